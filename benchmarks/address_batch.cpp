@@ -0,0 +1,88 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include "lib/address.h"
+#include "lib/address_batch.h"
+
+namespace {
+    const size_t BATCH_SIZE = 4096;
+
+    std::vector<uint8_t> randomKeys(size_t count) {
+        std::mt19937 rng(1234);
+        std::vector<uint8_t> keys(count * ADDRESS_PK_LEN);
+        for (auto &b : keys) {
+            b = (uint8_t) rng();
+        }
+        return keys;
+    }
+
+    // Reference: one key at a time through the single key API
+    void BM_address_fromPubKey(benchmark::State &state) {
+        const auto keys = randomKeys(BATCH_SIZE);
+        std::vector<char> out(BATCH_SIZE * ADDRESS_STR_LEN(3));
+
+        for (auto _ : state) {
+            for (size_t i = 0; i < BATCH_SIZE; i++) {
+                address_fromPubKey(out.data() + i * ADDRESS_STR_LEN(3), ADDRESS_STR_LEN(3),
+                                   "iov", keys.data() + i * ADDRESS_PK_LEN);
+            }
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+    BENCHMARK(BM_address_fromPubKey);
+
+    void BM_address_hash_batch(benchmark::State &state) {
+        const auto kernel = (address_kernel_e) state.range(0);
+        if (!address_kernel_supported(kernel)) {
+            state.SkipWithError("kernel not supported on this CPU");
+            return;
+        }
+        state.SetLabel(address_kernel_name(kernel));
+
+        const auto keys = randomKeys(BATCH_SIZE);
+        std::vector<uint8_t> hashes(BATCH_SIZE * ADDRESS_HASH_LEN);
+
+        for (auto _ : state) {
+            address_hash_batch(kernel, keys.data(), BATCH_SIZE, hashes.data());
+            benchmark::DoNotOptimize(hashes.data());
+        }
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+        state.SetBytesProcessed(state.iterations() * BATCH_SIZE * ADDRESS_PK_LEN);
+    }
+    BENCHMARK(BM_address_hash_batch)->DenseRange(address_kernel_scalar, address_kernel_avx512);
+
+    void BM_address_fromPubKey_batch(benchmark::State &state) {
+        const auto kernel = (address_kernel_e) state.range(0);
+        if (!address_kernel_supported(kernel)) {
+            state.SkipWithError("kernel not supported on this CPU");
+            return;
+        }
+        state.SetLabel(address_kernel_name(kernel));
+
+        const auto keys = randomKeys(BATCH_SIZE);
+        std::vector<char> out(BATCH_SIZE * ADDRESS_STR_LEN(3));
+
+        for (auto _ : state) {
+            address_fromPubKey_batch(kernel, out.data(), ADDRESS_STR_LEN(3), "iov", keys.data(), BATCH_SIZE);
+            benchmark::DoNotOptimize(out.data());
+        }
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+    BENCHMARK(BM_address_fromPubKey_batch)->DenseRange(address_kernel_scalar, address_kernel_avx512);
+}
@@ -0,0 +1,57 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "buffering.h"
+
+namespace {
+    // Same sizes as the Nano S transaction buffers (src/tx.c)
+    const uint16_t RAM_BUFFER_SIZE = 384;
+    const uint16_t FLASH_BUFFER_SIZE = 8192;
+    const uint16_t NVM_PAGE_SIZE = 64;
+
+    /// Full transaction received in APDU sized chunks. Above RAM_BUFFER_SIZE the data
+    /// goes to flash through MEMCPY_NV, a plain memcpy on host
+    void BM_buffering_append(benchmark::State &state) {
+        const size_t txLen = state.range(0);
+        const size_t chunkLen = state.range(1);
+
+        std::vector<uint8_t> ram(RAM_BUFFER_SIZE);
+        std::vector<uint8_t> flash(FLASH_BUFFER_SIZE);
+        std::vector<uint8_t> chunk(chunkLen, 0xA5);
+
+        for (auto _ : state) {
+            buffering_init(ram.data(), ram.size(), flash.data(), flash.size());
+            for (size_t pos = 0; pos < txLen; pos += chunkLen) {
+                const size_t n = std::min(chunkLen, txLen - pos);
+                benchmark::DoNotOptimize(buffering_append(chunk.data(), n));
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetBytesProcessed(state.iterations() * txLen);
+
+        // NVM pages a device would write for one transaction
+        const bool inFlash = txLen > RAM_BUFFER_SIZE;
+        state.counters["nvm_pages"] = inFlash ? (double) ((txLen + NVM_PAGE_SIZE - 1) / NVM_PAGE_SIZE) : 0;
+        state.SetLabel(inFlash ? "flash" : "ram");
+    }
+    BENCHMARK(BM_buffering_append)
+        ->Args({250, 250})
+        ->Args({384, 250})
+        ->Args({2048, 250})
+        ->Args({8192, 250})
+        ->Args({8192, 64});
+}
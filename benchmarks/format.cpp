@@ -0,0 +1,84 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bech32.h"
+#include "bignum.h"
+#include "zxformat.h"
+
+namespace {
+    void BM_bech32EncodeFromBytes(benchmark::State &state) {
+        std::vector<uint8_t> data(state.range(0));
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = (uint8_t) (i * 37);
+        }
+        char out[200];
+
+        for (auto _ : state) {
+            bech32EncodeFromBytes(out, "iov", data.data(), data.size());
+            benchmark::DoNotOptimize(out);
+        }
+        state.SetBytesProcessed(state.iterations() * data.size());
+    }
+    // Addresses (20) and public keys (32)
+    BENCHMARK(BM_bech32EncodeFromBytes)->Arg(20)->Arg(32);
+
+    // Proposal and contract ids (8 bytes) up to 128-bit batch totals
+    void BM_bignumBigEndian_to_bcd(benchmark::State &state) {
+        std::vector<uint8_t> value(state.range(0), 0xFF);
+        uint8_t bcd[64];
+        char out[160];
+
+        for (auto _ : state) {
+            bignumBigEndian_to_bcd(bcd, sizeof(bcd), value.data(), value.size());
+            bignumBigEndian_bcdprint(out, sizeof(out), bcd, sizeof(bcd));
+            benchmark::DoNotOptimize(out);
+        }
+        state.SetBytesProcessed(state.iterations() * value.size());
+    }
+    BENCHMARK(BM_bignumBigEndian_to_bcd)->Arg(8)->Arg(16);
+
+    void BM_int64_to_str(benchmark::State &state) {
+        const int64_t value = state.range(0);
+        char out[30];
+
+        for (auto _ : state) {
+            int64_to_str(out, sizeof(out), value);
+            benchmark::DoNotOptimize(out);
+        }
+    }
+    BENCHMARK(BM_int64_to_str)->Arg(7)->Arg(999999999)->Arg(INT64_MAX);
+
+    void BM_asciify(benchmark::State &state) {
+        // Mix of ASCII and two byte UTF-8 sequences, as in memos
+        std::string memo;
+        while (memo.size() < (size_t) state.range(0)) {
+            memo += "Payment \xc3\xa9t\xc3\xa9 ";
+        }
+        memo.resize(state.range(0));
+        std::vector<char> buffer(memo.size() + 1);
+
+        for (auto _ : state) {
+            memcpy(buffer.data(), memo.c_str(), buffer.size());
+            asciify(buffer.data());
+            benchmark::DoNotOptimize(buffer.data());
+        }
+        state.SetBytesProcessed(state.iterations() * memo.size());
+    }
+    BENCHMARK(BM_asciify)->Arg(16)->Arg(128);
+}
@@ -0,0 +1,301 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Workload driver for instruction counting on Cortex-M0 (see scripts/m0_insn_count.py)
+//
+//   bench_m0 list             prints the case names
+//   bench_m0 <case> <reps>    runs the setup of <case>, then <reps> operations
+//
+// Per-page cases (page/<tx>/<item>/<page>) are listed for the worst-case transactions only
+// (tests/tx_worst.h, see scripts/m0_wcet.py).
+//
+// The emulator counts every instruction of the process, so the cost of one operation is
+// (count(reps) - count(0)) / reps: setup, corpus generation and exit cancel out.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bech32.h"
+#include "bignum.h"
+#include "buffering.h"
+#include "zxformat.h"
+#include "lib/parser.h"
+#include "tx_builder.h"
+#include "tx_worst.h"
+
+using namespace iov_test;
+
+// Device configuration, set by benchmarks/m0/CMakeLists.txt
+#ifndef RAM_BUFFER_SIZE
+#define RAM_BUFFER_SIZE 384
+#endif
+#ifndef FLASH_BUFFER_SIZE
+#define FLASH_BUFFER_SIZE 8192
+#endif
+#ifndef BENCH_KEY_LEN
+#define BENCH_KEY_LEN 33
+#endif
+#ifndef BENCH_VALUE_LEN
+#define BENCH_VALUE_LEN 37
+#endif
+
+// Same chunking as the APDUs sent by the wallets
+#define BENCH_CHUNK_LEN 250
+
+namespace {
+    uint8_t ramBuffer[RAM_BUFFER_SIZE];
+    uint8_t flashBuffer[FLASH_BUFFER_SIZE];
+
+    parser_context_t ctx;
+    parser_tx_t txObj;
+    char key[BENCH_KEY_LEN];
+    char value[BENCH_VALUE_LEN];
+
+    volatile uint32_t sink;
+
+    struct tx_case {
+        std::string name;
+        bytes_t data;
+    };
+
+    std::vector<tx_case> txCases() {
+        send_tx noMemo;
+        noMemo.memo = "";
+        send_tx longMemo;
+        longMemo.memo = std::string(TX_MEMOLEN_MAX, 'm');
+
+        std::vector<tx_case> cases = {
+            {"send", build(noMemo)},
+            {"send_memo128", build(longMemo)},
+            {"vote", build_msg(PBIDX_TX_VOTEMSG, vote_msg(VOTE_OPTION_YES))},
+            {"update_1", build_msg(PBIDX_TX_UPDATEMSG, update_msg(1))},
+            {"update_16", build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX))},
+            {"batch_1", build_msg(PBIDX_TX_BATCHMSG, batch_msg(1))},
+            {"batch_16", build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX))},
+        };
+        for (const auto &w : worst_cases()) {
+            cases.push_back({w.first, w.second});
+        }
+        return cases;
+    }
+
+    /// Loads the transaction the way tx.c does: RAM buffer first, flash once it does not fit
+    bool load(const bytes_t &data) {
+        buffering_reset();
+        for (size_t offset = 0; offset < data.size(); offset += BENCH_CHUNK_LEN) {
+            const size_t n = std::min((size_t) BENCH_CHUNK_LEN, data.size() - offset);
+            if (buffering_append(const_cast<uint8_t *>(data.data()) + offset, (int) n) != (int) n) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool parse() {
+        const buffer_state_t *b = buffering_get_buffer();
+        return parser_parse(&ctx, b->data, b->pos, &txObj) == parser_ok;
+    }
+
+    /// What the last chunk triggers before the first screen is shown (tx_parse + first page)
+    void firstScreen() {
+        uint8_t pageCount = 0;
+        const buffer_state_t *b = buffering_get_buffer();
+        if (parser_parse(&ctx, b->data, b->pos, &txObj) == parser_ok &&
+            parser_validate(&ctx, bool_true) == parser_ok) {
+            parser_getItem(&ctx, 0, key, sizeof(key), value, sizeof(value), 0, &pageCount);
+        }
+        sink += pageCount;
+    }
+
+    /// Every page of one display item, as shown while scrolling
+    void renderItem(int8_t displayIdx) {
+        uint8_t pageCount = 1;
+        for (uint8_t page = 0; page < pageCount; page++) {
+            parser_getItem(&ctx, displayIdx, key, sizeof(key), value, sizeof(value), page, &pageCount);
+        }
+        sink += (uint8_t) value[0];
+    }
+
+    std::vector<std::string> caseNames() {
+        std::vector<std::string> names;
+        for (const auto &c : txCases()) {
+            names.push_back(std::string("append/") + c.name);
+            names.push_back(std::string("parse/") + c.name);
+            names.push_back(std::string("first_screen/") + c.name);
+            if (!load(c.data) || !parse()) {
+                continue;
+            }
+            const bool worst = c.name.compare(0, 6, "worst_") == 0;
+            for (int8_t i = 0; i < parser_getNumItems(&ctx); i++) {
+                names.push_back(std::string("getItem/") + c.name + "/" + std::to_string(i));
+
+                uint8_t pageCount = 1;
+                for (uint8_t page = 0; worst && page < pageCount; page++) {
+                    parser_getItem(&ctx, i, key, sizeof(key), value, sizeof(value), page, &pageCount);
+                    names.push_back(std::string("page/") + c.name + "/" + std::to_string(i) + "/" +
+                                    std::to_string(page));
+                }
+            }
+        }
+        for (const char *n : {"bech32/20", "bech32/32", "bcd/8", "bcd/16",
+                              "int64_to_str/7", "int64_to_str/999999999", "int64_to_str/max"}) {
+            names.push_back(n);
+        }
+        return names;
+    }
+
+    int runTx(const std::string &op, const std::string &rest, unsigned long reps) {
+        const size_t slash = rest.find('/');
+        const std::string txName = rest.substr(0, slash);
+
+        for (const auto &c : txCases()) {
+            if (txName != c.name) {
+                continue;
+            }
+            if (op == "append") {
+                for (unsigned long i = 0; i < reps; i++) {
+                    if (!load(c.data)) {
+                        return 2;
+                    }
+                }
+                return 0;
+            }
+
+            if (!load(c.data) || !parse()) {
+                return 2;
+            }
+            if (op == "parse") {
+                for (unsigned long i = 0; i < reps; i++) {
+                    parse();
+                }
+                return 0;
+            }
+
+            if (op == "first_screen") {
+                for (unsigned long i = 0; i < reps; i++) {
+                    firstScreen();
+                }
+                return 0;
+            }
+
+            if (op == "page" && slash != std::string::npos) {
+                int displayIdx = 0;
+                int page = 0;
+                if (sscanf(rest.c_str() + slash + 1, "%d/%d", &displayIdx, &page) != 2 ||
+                    displayIdx >= parser_getNumItems(&ctx)) {
+                    return 2;
+                }
+                uint8_t pageCount = 0;
+                if (parser_getItem(&ctx, (int8_t) displayIdx, key, sizeof(key), value, sizeof(value),
+                                   (uint8_t) page, &pageCount) != parser_ok) {
+                    return 2;
+                }
+                for (unsigned long i = 0; i < reps; i++) {
+                    parser_getItem(&ctx, (int8_t) displayIdx, key, sizeof(key), value, sizeof(value),
+                                   (uint8_t) page, &pageCount);
+                    sink += (uint8_t) value[0];
+                }
+                return 0;
+            }
+
+            if (op == "getItem" && slash != std::string::npos) {
+                const int8_t displayIdx = (int8_t) atoi(rest.c_str() + slash + 1);
+                if (displayIdx >= parser_getNumItems(&ctx)) {
+                    return 2;
+                }
+                for (unsigned long i = 0; i < reps; i++) {
+                    renderItem(displayIdx);
+                }
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    int runFormat(const std::string &op, const std::string &arg, unsigned long reps) {
+        if (op == "bech32") {
+            std::vector<uint8_t> data(atoi(arg.c_str()));
+            for (size_t i = 0; i < data.size(); i++) {
+                data[i] = (uint8_t) (i * 37);
+            }
+            char out[200];
+            for (unsigned long i = 0; i < reps; i++) {
+                bech32EncodeFromBytes(out, "iov", data.data(), data.size());
+                sink += (uint8_t) out[4];
+            }
+            return 0;
+        }
+
+        if (op == "bcd") {
+            std::vector<uint8_t> bigEndian(atoi(arg.c_str()), 0xFF);
+            uint8_t bcd[64];
+            char out[160];
+            for (unsigned long i = 0; i < reps; i++) {
+                bignumBigEndian_to_bcd(bcd, sizeof(bcd), bigEndian.data(), bigEndian.size());
+                bignumBigEndian_bcdprint(out, sizeof(out), bcd, sizeof(bcd));
+                sink += (uint8_t) out[0];
+            }
+            return 0;
+        }
+
+        if (op == "int64_to_str") {
+            const int64_t v = arg == "max" ? INT64_MAX : strtoll(arg.c_str(), nullptr, 10);
+            char out[30];
+            for (unsigned long i = 0; i < reps; i++) {
+                int64_to_str(out, sizeof(out), v);
+                sink += (uint8_t) out[0];
+            }
+            return 0;
+        }
+
+        return 1;
+    }
+}
+
+int main(int argc, char **argv) {
+    buffering_init(ramBuffer, sizeof(ramBuffer), flashBuffer, sizeof(flashBuffer));
+
+    if (argc == 2 && strcmp(argv[1], "list") == 0) {
+        for (const auto &n : caseNames()) {
+            printf("%s\n", n.c_str());
+        }
+        return 0;
+    }
+    if (argc != 3) {
+        printf("usage: bench_m0 list | bench_m0 <case> <reps>\n");
+        return 1;
+    }
+
+    const std::string name = argv[1];
+    const unsigned long reps = strtoul(argv[2], nullptr, 10);
+    const size_t slash = name.find('/');
+    if (slash == std::string::npos) {
+        printf("unknown case %s\n", name.c_str());
+        return 1;
+    }
+
+    const std::string op = name.substr(0, slash);
+    const std::string rest = name.substr(slash + 1);
+    const int err = (op == "append" || op == "parse" || op == "first_screen" || op == "getItem" || op == "page")
+                    ? runTx(op, rest, reps)
+                    : runFormat(op, rest, reps);
+    if (err != 0) {
+        printf("%s %s\n", err == 1 ? "unknown case" : "failed", name.c_str());
+    }
+    return err;
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Vector table and reset handler for the emulated board (see mps2_an385.ld).
+// newlib's rdimon crt0 (_start) clears .bss, reads argv through semihosting and calls main.
+
+#include <stdint.h>
+
+extern uint32_t __StackTop;
+extern uint32_t __data_load__;
+extern uint32_t __data_start__;
+extern uint32_t __data_end__;
+
+extern void _start(void);
+
+void Reset_Handler(void) {
+    // .data is loaded into ROM by the emulator
+    const uint32_t *src = &__data_load__;
+    for (uint32_t *dst = &__data_start__; dst < &__data_end__;) {
+        *dst++ = *src++;
+    }
+    _start();
+    for (;;) {}
+}
+
+void Default_Handler(void) {
+    for (;;) {}
+}
+
+__attribute__ ((section(".vectors"), used))
+const void *vectors[16] = {
+    &__StackTop,
+    (void *) Reset_Handler,
+    (void *) Default_Handler,       // NMI
+    (void *) Default_Handler,       // HardFault
+};
@@ -0,0 +1,136 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "lib/parser.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    // Key and value buffers of the Nano S review screens
+    const uint16_t KEY_LEN = 33;
+    const uint16_t VALUE_LEN = 37;
+
+    struct tx_case {
+        const char *name;
+        bytes_t data;
+    };
+
+    std::vector<tx_case> txCases() {
+        send_tx noMemo;
+        noMemo.memo = "";
+        send_tx longMemo;
+        longMemo.memo = std::string(TX_MEMOLEN_MAX, 'm');
+
+        return {
+            {"send", build(noMemo)},
+            {"send_memo128", build(longMemo)},
+            {"vote", build_msg(PBIDX_TX_VOTEMSG, vote_msg(VOTE_OPTION_YES))},
+            {"update_1", build_msg(PBIDX_TX_UPDATEMSG, update_msg(1))},
+            {"update_16", build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX))},
+            {"batch_1", build_msg(PBIDX_TX_BATCHMSG, batch_msg(1))},
+            {"batch_16", build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX))},
+        };
+    }
+
+    /// Varints of 1, 2, 5 and 10 bytes
+    void BM_readRawVarint(benchmark::State &state) {
+        const size_t count = 1024;
+        const uint64_t value = state.range(0) == 10 ? UINT64_MAX : (1ull << (7u * state.range(0))) - 1;
+
+        bytes_t data;
+        for (size_t i = 0; i < count; i++) {
+            uint64_t v = value;
+            while (v >= 0x80) {
+                data.push_back((uint8_t) (v | 0x80u));
+                v >>= 7u;
+            }
+            data.push_back((uint8_t) v);
+        }
+
+        for (auto _ : state) {
+            parser_context_t ctx = {data.data(), (parser_size_t) data.size(), 0, 0, nullptr, nullptr};
+            uint64_t v = 0;
+            for (size_t i = 0; i < count; i++) {
+                _readRawVarint(&ctx, &v);
+            }
+            benchmark::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(state.iterations() * count);
+        state.SetBytesProcessed(state.iterations() * data.size());
+    }
+    BENCHMARK(BM_readRawVarint)->Arg(1)->Arg(2)->Arg(5)->Arg(10);
+
+    void BM_parser_parse(benchmark::State &state, bytes_t data) {
+        parser_context_t ctx;
+        parser_tx_t tx;
+        if (parser_parse(&ctx, data.data(), data.size(), &tx) != parser_ok) {
+            state.SkipWithError("invalid transaction");
+            return;
+        }
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(parser_parse(&ctx, data.data(), data.size(), &tx));
+        }
+        state.SetBytesProcessed(state.iterations() * data.size());
+    }
+
+    /// One benchmark per display item: every field kind of every message type
+    void BM_parser_getItem(benchmark::State &state, bytes_t data, int8_t displayIdx) {
+        parser_context_t ctx;
+        parser_tx_t tx;
+        if (parser_parse(&ctx, data.data(), data.size(), &tx) != parser_ok) {
+            state.SkipWithError("invalid transaction");
+            return;
+        }
+
+        char key[KEY_LEN];
+        char value[VALUE_LEN];
+        uint8_t pageCount = 0;
+        parser_getItem(&ctx, displayIdx, key, sizeof(key), value, sizeof(value), 0, &pageCount);
+        state.SetLabel(key);
+
+        for (auto _ : state) {
+            // All pages, as the device does while scrolling
+            for (uint8_t page = 0; page < pageCount; page++) {
+                parser_getItem(&ctx, displayIdx, key, sizeof(key), value, sizeof(value), page, &pageCount);
+            }
+            benchmark::DoNotOptimize(value);
+        }
+        state.SetItemsProcessed(state.iterations() * pageCount);
+    }
+
+    const bool registered = [] {
+        for (const auto &c : txCases()) {
+            benchmark::RegisterBenchmark((std::string("BM_parser_parse/") + c.name).c_str(),
+                                         BM_parser_parse, c.data);
+
+            parser_context_t ctx;
+            parser_tx_t tx;
+            if (parser_parse(&ctx, c.data.data(), c.data.size(), &tx) != parser_ok) {
+                continue;
+            }
+            for (int8_t i = 0; i < parser_getNumItems(&ctx); i++) {
+                benchmark::RegisterBenchmark(
+                    (std::string("BM_parser_getItem/") + c.name + "/" + std::to_string(i)).c_str(),
+                    BM_parser_getItem, c.data, i);
+            }
+        }
+        return true;
+    }();
+}
@@ -26,7 +26,8 @@ extern "C" {
 #endif
 
 #include "string.h"
-#ifndef __APPLE__
+// newlib (bare metal builds) lacks __THROW/__nonnull and may lack explicit_bzero
+#if !defined(__APPLE__) && !defined(__NEWLIB__)
 extern void explicit_bzero(void *__s, size_t __n) __THROW __nonnull ((1));
 #endif
 #define __Z_INLINE inline __attribute__((always_inline)) static
@@ -104,7 +105,7 @@ void __logstack();
 #define CX_ECCINFO_PARITY_ODD 1u
 #define CX_ECCINFO_xGTn 2u
 
-#ifndef __APPLE__
+#if !defined(__APPLE__) && !defined(__NEWLIB__)
 #define MEMZERO explicit_bzero
 #else
 __Z_INLINE void __memzero(void *buffer, size_t s) { memset(buffer, 0, s); }
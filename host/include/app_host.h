@@ -0,0 +1,90 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Drives the app (app_main.c and everything below it) on a host, one APDU at a time
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    app_host_user_accept = 0,
+    app_host_user_reject,
+} app_host_user_e;
+
+/// Called for every item shown while a transaction is reviewed
+typedef void (*app_host_review_cb)(const char *key, const char *value, void *userdata);
+
+/// Points of an APDU exchange where a host harness can take timestamps
+typedef enum {
+    app_host_event_apdu_start = 0,      // Command delivered to the app
+    app_host_event_apdu_end,            // Reply sent by the app
+    app_host_event_review_start,        // Transaction review shown
+    app_host_event_page_start,          // Rendering of one review page
+    app_host_event_page_end,
+    app_host_event_user,                // Confirmation screen answered
+} app_host_event_e;
+
+typedef void (*app_host_event_cb)(app_host_event_e event, void *userdata);
+
+/// Resets the app to its idle state. Must be called once before app_host_exchange
+void app_host_init();
+
+/// Sends a command APDU and returns the length of the reply (data + status word).
+/// Commands that need a confirmation are accepted or rejected right away (see app_host_set_user)
+uint16_t app_host_exchange(const uint8_t *command, uint16_t commandLen,
+                           uint8_t *reply, uint16_t replyMaxLen);
+
+/// What the user does on the next confirmation screens. Default: accept
+void app_host_set_user(app_host_user_e action);
+
+void app_host_set_review_callback(app_host_review_cb cb, void *userdata);
+
+void app_host_set_event_callback(app_host_event_cb cb, void *userdata);
+
+/// Number of items shown during the last transaction review
+uint16_t app_host_review_count();
+
+/// Delivers a ticker event, as the SE does every 100 ms
+void app_host_ticker();
+
+/// Locks or unlocks the device (os_global_pin_is_validated)
+void app_host_set_locked(bool locked);
+
+/// Stack available to app_host_stack_usage
+#define APP_HOST_STACK_SIZE (64 * 1024)
+
+/// Runs fn(arg) on a painted stack and returns the deepest stack use in bytes.
+/// Host frames are larger than on the device (64-bit pointers, other ABI): compare runs, not devices
+size_t app_host_stack_usage(void (*fn)(void *arg), void *arg);
+
+///////////////////////////////////////////////
+// Between the host io layer and the host view
+
+/// Answers the confirmation screen currently shown, if any. Returns false when there is none
+bool app_host_view_resolve(app_host_user_e action);
+
+/// Reports an event to the callback set with app_host_set_event_callback
+void app_host_event(app_host_event_e event);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,30 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Host replacement for BAGL. Nothing is drawn, elements only need a type
+
+#include <stdint.h>
+
+typedef struct {
+    struct {
+        uint8_t type;
+        uint8_t userid;
+    } component;
+    const char *text;
+} bagl_element_t;
+
+void io_seproxyhal_display_default(bagl_element_t *element);
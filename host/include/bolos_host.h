@@ -0,0 +1,25 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Force-included in the host build of the app sources. On the device the same environment
+// comes from the SDK: Makefile DEFINES and the headers zxmacros.h pulls in for TARGET_NANOS/X
+
+#define UNUSED(x) (void)x
+#define PRINTF(...)
+
+#include "os.h"
+#include "os_io_seproxyhal.h"
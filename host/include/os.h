@@ -0,0 +1,159 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Host replacement for the BOLOS os.h: exceptions, memory helpers and the few os_* calls used by the app
+
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TARGET_ID                   0x31100004      // Nano S
+
+#define EXCEPTION                   1
+#define INVALID_PARAMETER           2
+#define EXCEPTION_OVERFLOW          3
+#define EXCEPTION_SECURITY          4
+#define INVALID_CRC                 5
+#define INVALID_CHECKSUM            6
+#define INVALID_COUNTER             7
+#define NOT_SUPPORTED               8
+#define INVALID_STATE               9
+#define TIMEOUT                     10
+#define EXCEPTION_PIC               11
+#define EXCEPTION_APPEXIT           12
+#define EXCEPTION_IO_OVERFLOW       13
+#define EXCEPTION_IO_HEADER         14
+#define EXCEPTION_IO_STATE          15
+#define EXCEPTION_IO_RESET          16
+#define EXCEPTION_CXPORT            17
+#define EXCEPTION_SYSTEM            18
+#define NOT_ENOUGH_SPACE            19
+
+#define BOLOS_UX_OK                 0xAA
+#define BOLOS_UX_IGNORE             0x97
+#define BOLOS_UX_CONTINUE           0
+
+///////////////////////////////////////////////
+// Exceptions (same model as the SDK: setjmp based, one context per TRY)
+
+typedef unsigned short exception_t;
+
+typedef struct try_context_s try_context_t;
+
+struct try_context_s {
+    jmp_buf jmp_buf;
+    try_context_t *previous;
+    exception_t ex;
+};
+
+try_context_t *try_context_get(void);
+
+try_context_t *try_context_set(try_context_t *context);
+
+void os_longjmp(unsigned int exception) __attribute__((noreturn));
+
+#define BEGIN_TRY_L(L)                                                  \
+    {                                                                   \
+        try_context_t __try##L;
+
+#define TRY_L(L)                                                        \
+        __try##L.ex = setjmp(__try##L.jmp_buf);                         \
+        if (__try##L.ex == 0) {                                         \
+            __try##L.previous = try_context_set(&__try##L);
+
+#define CATCH_L(L, x)                                                   \
+            goto __FINALLY##L;                                          \
+        }                                                               \
+        else if (__try##L.ex == (x)) {                                  \
+            __try##L.ex = 0;                                            \
+            try_context_set(__try##L.previous);
+
+#define CATCH_OTHER_L(L, e)                                             \
+            goto __FINALLY##L;                                          \
+        }                                                               \
+        else {                                                          \
+            exception_t e;                                              \
+            e = __try##L.ex;                                            \
+            __try##L.ex = 0;                                            \
+            try_context_set(__try##L.previous);
+
+#define CATCH_ALL_L(L)                                                  \
+            goto __FINALLY##L;                                          \
+        }                                                               \
+        else {                                                          \
+            __try##L.ex = 0;                                            \
+            try_context_set(__try##L.previous);
+
+#define FINALLY_L(L)                                                    \
+            goto __FINALLY##L;                                          \
+        }                                                               \
+        __FINALLY##L:                                                   \
+        if (try_context_get() == &__try##L) {                           \
+            try_context_set(__try##L.previous);                         \
+        }
+
+#define END_TRY_L(L)                                                    \
+        if (__try##L.ex != 0) {                                         \
+            os_longjmp(__try##L.ex);                                    \
+        }                                                               \
+    }
+
+#define BEGIN_TRY       BEGIN_TRY_L(_)
+#define TRY             TRY_L(_)
+#define CATCH(x)        CATCH_L(_, x)
+#define CATCH_OTHER(e)  CATCH_OTHER_L(_, e)
+#define CATCH_ALL       CATCH_ALL_L(_)
+#define FINALLY         FINALLY_L(_)
+#define END_TRY         END_TRY_L(_)
+
+#define THROW(x)        os_longjmp(x)
+
+///////////////////////////////////////////////
+// Memory and NVM
+
+#define os_memcpy   memcpy
+#define os_memmove  memmove
+#define os_memset   memset
+#define os_memcmp   memcmp
+
+#ifndef PIC
+#define PIC(x) (x)
+#endif
+
+/// Flash is plain memory on the host
+void nvm_write(void *dst_adr, void *src_adr, unsigned int src_len);
+
+///////////////////////////////////////////////
+// System
+
+unsigned int os_global_pin_is_validated(void);
+
+unsigned int os_version(unsigned char *version, unsigned int maxlength);
+
+unsigned int os_seph_version(unsigned char *version, unsigned int maxlength);
+
+void os_sched_exit(unsigned int exit_code);
+
+void reset(void);
+
+#ifdef __cplusplus
+}
+#endif
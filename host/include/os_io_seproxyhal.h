@@ -0,0 +1,80 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Host replacement for the SE proxy HAL: APDU transport and UX event plumbing
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IO_APDU_BUFFER_SIZE             (5 + 255)
+#define IO_SEPROXYHAL_BUFFER_SIZE_B     128
+
+#define CHANNEL_APDU                    0
+#define CHANNEL_KEYBOARD                1
+#define CHANNEL_SPI                     2
+
+#define IO_RESET_AFTER_REPLIED          0x80
+#define IO_RECEIVE_DATA                 0x40
+#define IO_RETURN_AFTER_TX              0x20
+#define IO_ASYNCH_REPLY                 0x10
+#define IO_FLAGS                        0xF8
+
+#define SEPROXYHAL_TAG_BUTTON_PUSH_EVENT        0x05
+#define SEPROXYHAL_TAG_FINGER_EVENT             0x0C
+#define SEPROXYHAL_TAG_DISPLAY_PROCESSED_EVENT  0x0D
+#define SEPROXYHAL_TAG_TICKER_EVENT             0x0E
+
+extern unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+extern unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
+
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len);
+
+/// Implemented by the app
+unsigned char io_event(unsigned char channel);
+
+void io_seproxyhal_init(void);
+
+void io_seproxyhal_general_status(void);
+
+unsigned int io_seproxyhal_spi_is_status_sent(void);
+
+void io_seproxyhal_spi_send(const unsigned char *buffer, unsigned short length);
+
+unsigned short io_seproxyhal_spi_recv(unsigned char *buffer, unsigned short maxlength, unsigned int flags);
+
+void USB_power(unsigned char enabled);
+
+// There is no screen: the host view (host/src/view_host.c) decides what the user does
+#define UX_INIT()
+#define UX_WAIT()
+#define UX_DISPLAYED()                  1
+#define UX_DISPLAYED_EVENT()
+#define UX_REDISPLAY()
+#define UX_ALLOWED                      1
+#define UX_DEFAULT_EVENT()
+#define UX_FINGER_EVENT(seph_packet)
+#define UX_BUTTON_PUSH_EVENT(seph_packet)
+#define UX_TICKER_EVENT(seph_packet, callback)
+
+#define IS_UX_ALLOWED                   1
+
+#ifdef __cplusplus
+}
+#endif
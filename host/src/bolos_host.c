@@ -0,0 +1,236 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "app_host.h"
+#include "os.h"
+#include "os_io_seproxyhal.h"
+#include "bagl.h"
+
+#include "app_main.h"
+#include "view.h"
+#include "actions.h"
+#include "tx.h"
+#include "lib/crypto.h"
+#include "lib/pubkey_cache.h"
+#include "lib/stats.h"
+#include "zxmacros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+unsigned char G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
+
+///////////////////////////////////////////////
+// Exceptions
+
+try_context_t *currentTryContext = NULL;
+
+try_context_t *try_context_get(void) {
+    return currentTryContext;
+}
+
+try_context_t *try_context_set(try_context_t *context) {
+    try_context_t *previous = currentTryContext;
+    currentTryContext = context;
+    return previous;
+}
+
+void os_longjmp(unsigned int exception) {
+    try_context_t *context = try_context_get();
+    if (context == NULL) {
+        // On the device this would crash the app
+        fprintf(stderr, "Uncaught exception 0x%04X\n", exception);
+        abort();
+    }
+    longjmp(context->jmp_buf, exception);
+}
+
+///////////////////////////////////////////////
+// APDU transport
+//
+// app_main() runs until it asks io_exchange for the next command after having replied.
+// At that point control goes back to app_host_exchange
+
+typedef struct {
+    const uint8_t *command;
+    uint16_t commandLen;
+
+    uint8_t *reply;
+    uint16_t replyMaxLen;
+    uint16_t replyLen;
+    bool replied;
+
+    jmp_buf done;
+} host_exchange_t;
+
+host_exchange_t hostExchange;
+app_host_user_e hostUser = app_host_user_accept;
+bool hostLocked = false;
+
+app_host_event_cb hostEventCallback = NULL;
+void *hostEventUserdata = NULL;
+
+void app_host_event(app_host_event_e event) {
+    if (hostEventCallback != NULL) {
+        hostEventCallback(event, hostEventUserdata);
+    }
+}
+
+void app_host_set_event_callback(app_host_event_cb cb, void *userdata) {
+    hostEventCallback = cb;
+    hostEventUserdata = userdata;
+}
+
+unsigned short io_exchange(unsigned char channel_and_flags, unsigned short tx_len) {
+    if (tx_len > 0) {
+        if (tx_len > hostExchange.replyMaxLen) {
+            tx_len = hostExchange.replyMaxLen;
+        }
+        MEMCPY(hostExchange.reply, G_io_apdu_buffer, tx_len);
+        hostExchange.replyLen = tx_len;
+        hostExchange.replied = true;
+        app_host_event(app_host_event_apdu_end);
+    }
+
+    if (channel_and_flags & IO_RETURN_AFTER_TX) {
+        return 0;
+    }
+
+    if (!hostExchange.replied && (channel_and_flags & IO_ASYNCH_REPLY)) {
+        // The app is waiting for the user: the reply is sent from the view handlers
+        app_host_event(app_host_event_user);
+        app_host_view_resolve(hostUser);
+    }
+
+    if (hostExchange.replied || hostExchange.command == NULL) {
+        try_context_set(NULL);
+        longjmp(hostExchange.done, 1);
+    }
+
+    const uint16_t rx = hostExchange.commandLen;
+    MEMCPY(G_io_apdu_buffer, hostExchange.command, rx);
+    hostExchange.command = NULL;
+    app_host_event(app_host_event_apdu_start);
+    return rx;
+}
+
+uint16_t app_host_exchange(const uint8_t *command, uint16_t commandLen,
+                           uint8_t *reply, uint16_t replyMaxLen) {
+    if (commandLen > IO_APDU_BUFFER_SIZE) {
+        commandLen = IO_APDU_BUFFER_SIZE;
+    }
+
+    hostExchange.command = command;
+    hostExchange.commandLen = commandLen;
+    hostExchange.reply = reply;
+    hostExchange.replyMaxLen = replyMaxLen;
+    hostExchange.replyLen = 0;
+    hostExchange.replied = false;
+
+    if (setjmp(hostExchange.done) == 0) {
+        app_main();
+    }
+
+    return hostExchange.replyLen;
+}
+
+void app_host_init() {
+    try_context_set(NULL);
+    MEMZERO(G_io_apdu_buffer, sizeof(G_io_apdu_buffer));
+    hostUser = app_host_user_accept;
+    hostLocked = false;
+
+    pubkey_cache_clear();
+    crypto_accountNodeClear();
+    app_sign_clear();
+    // Settings as in a freshly installed app
+    tx_settings_set_review_mode(tx_review_full);
+#if defined(APP_STATS)
+    stats_reset();
+#endif
+
+    view_init();
+    app_init();
+}
+
+void app_host_set_user(app_host_user_e action) {
+    hostUser = action;
+}
+
+void app_host_ticker() {
+    G_io_seproxyhal_spi_buffer[0] = SEPROXYHAL_TAG_TICKER_EVENT;
+    io_event(CHANNEL_SPI);
+}
+
+void app_host_set_locked(bool locked) {
+    hostLocked = locked;
+}
+
+///////////////////////////////////////////////
+// SE proxy, USB and screen: nothing to do
+
+void io_seproxyhal_init(void) {}
+
+void io_seproxyhal_general_status(void) {}
+
+unsigned int io_seproxyhal_spi_is_status_sent(void) {
+    return 1;
+}
+
+void io_seproxyhal_spi_send(const unsigned char *buffer, unsigned short length) {
+    UNUSED(buffer);
+    UNUSED(length);
+}
+
+unsigned short io_seproxyhal_spi_recv(unsigned char *buffer, unsigned short maxlength, unsigned int flags) {
+    UNUSED(buffer);
+    UNUSED(maxlength);
+    UNUSED(flags);
+    return 0;
+}
+
+void USB_power(unsigned char enabled) {
+    UNUSED(enabled);
+}
+
+void io_seproxyhal_display_default(bagl_element_t *element) {
+    UNUSED(element);
+}
+
+///////////////////////////////////////////////
+// System
+
+void nvm_write(void *dst_adr, void *src_adr, unsigned int src_len) {
+    MEMCPY(dst_adr, src_adr, src_len);
+}
+
+unsigned int os_global_pin_is_validated(void) {
+    return hostLocked ? 0 : BOLOS_UX_OK;
+}
+
+unsigned int os_version(unsigned char *version, unsigned int maxlength) {
+    return snprintf((char *) version, maxlength, "host");
+}
+
+unsigned int os_seph_version(unsigned char *version, unsigned int maxlength) {
+    return snprintf((char *) version, maxlength, "host");
+}
+
+void os_sched_exit(unsigned int exit_code) {
+    exit((int) exit_code);
+}
+
+void reset(void) {}
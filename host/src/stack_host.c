@@ -0,0 +1,71 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Stack painting: the call runs on its own stack, filled with a pattern beforehand.
+// The lowest byte that no longer holds the pattern is the high-water mark.
+
+#include "app_host.h"
+#include "zxmacros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ucontext.h>
+
+#define STACK_PAINT 0xA5u
+
+typedef struct {
+    void (*fn)(void *arg);
+    void *arg;
+} stack_call_t;
+
+static uint8_t hostStack[APP_HOST_STACK_SIZE] __attribute__ ((aligned(16)));
+static stack_call_t *hostStackCall;
+
+static void stack_trampoline() {
+    hostStackCall->fn(hostStackCall->arg);
+}
+
+size_t app_host_stack_usage(void (*fn)(void *arg), void *arg) {
+    stack_call_t call = {fn, arg};
+    ucontext_t caller;
+    ucontext_t callee;
+
+    MEMSET(hostStack, STACK_PAINT, sizeof(hostStack));
+
+    getcontext(&callee);
+    callee.uc_stack.ss_sp = hostStack;
+    callee.uc_stack.ss_size = sizeof(hostStack);
+    callee.uc_link = &caller;
+    makecontext(&callee, stack_trampoline, 0);
+
+    hostStackCall = &call;
+    if (swapcontext(&caller, &callee) != 0) {
+        fprintf(stderr, "swapcontext failed\n");
+        abort();
+    }
+    hostStackCall = NULL;
+
+    // The stack grows down
+    size_t untouched = 0;
+    while (untouched < sizeof(hostStack) && hostStack[untouched] == STACK_PAINT) {
+        untouched++;
+    }
+    if (untouched == 0) {
+        fprintf(stderr, "app_host_stack_usage: stack overflow\n");
+        abort();
+    }
+    return sizeof(hostStack) - untouched;
+}
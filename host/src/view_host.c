@@ -0,0 +1,107 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Host counterpart of view_s.c / view_x.c. There is no screen: the review goes through every item
+// as a user pressing "next" would, and the confirmation is answered by app_host_view_resolve
+
+#include "view.h"
+#include "view_internal.h"
+#include "app_host.h"
+
+typedef enum {
+    screen_idle = 0,
+    screen_address,
+    screen_sign,
+    screen_error,
+} host_screen_e;
+
+host_screen_e hostScreen = screen_idle;
+uint16_t hostReviewCount = 0;
+app_host_review_cb hostReviewCallback = NULL;
+void *hostReviewUserdata = NULL;
+
+void splitValueField() {}
+
+void view_idle_show_impl() {
+    hostScreen = screen_idle;
+}
+
+void view_address_show_impl() {
+    hostScreen = screen_address;
+}
+
+void view_error_show_impl() {
+    hostScreen = screen_error;
+}
+
+void view_sign_show_impl() {
+    hostReviewCount = 0;
+    app_host_event(app_host_event_review_start);
+    h_review_init();
+
+    for (;;) {
+        app_host_event(app_host_event_page_start);
+        const view_error_t err = h_review_update_data();
+        if (err == view_no_data) {
+            break;
+        }
+        app_host_event(app_host_event_page_end);
+        if (err != view_no_error) {
+            view_error_show();
+            return;
+        }
+
+        if (hostReviewCallback != NULL) {
+            hostReviewCallback(viewdata.key, viewdata.value, hostReviewUserdata);
+        }
+        hostReviewCount++;
+        h_review_increase();
+    }
+
+    hostScreen = screen_sign;
+}
+
+bool app_host_view_resolve(app_host_user_e action) {
+    const host_screen_e screen = hostScreen;
+    hostScreen = screen_idle;
+
+    switch (screen) {
+        case screen_address:
+            h_address_accept(0);
+            return true;
+        case screen_sign:
+            if (action == app_host_user_accept) {
+                h_sign_accept(0);
+            } else {
+                h_sign_reject(0);
+            }
+            return true;
+        case screen_error:
+            h_error_accept(0);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void app_host_set_review_callback(app_host_review_cb cb, void *userdata) {
+    hostReviewCallback = cb;
+    hostReviewUserdata = userdata;
+}
+
+uint16_t app_host_review_count() {
+    return hostReviewCount;
+}
@@ -0,0 +1,333 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Replays APDU sessions through app_main() on the host build and reports where the time goes:
+//
+//   iov_apdu_latency [--iterations N] [--chunk N] [--json out.json] [--trace trace.json] [transcript ...]
+//
+// --trace writes the TRACE_BEGIN/TRACE_END events of the last iterations (the ring keeps
+// TRACE_RING_SIZE events) as chrome://tracing / Perfetto JSON.
+//
+// Without transcripts a built-in corpus of transactions of different sizes and shapes is used.
+// A transcript has one hex encoded command APDU per line. "user accept" / "user reject" lines
+// set the answer to the following confirmation screens; '#' starts a comment.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "app_host.h"
+#include "app_main.h"
+#include "buffering.h"
+#include "lib/crypto.h"
+#include "lib/parser_txdef.h"
+#include "lib/trace.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    typedef std::chrono::steady_clock clock_type;
+
+    struct step_t {
+        bytes_t apdu;
+        app_host_user_e user;
+    };
+
+    struct session_t {
+        std::string name;
+        std::vector<step_t> steps;
+    };
+
+    struct event_t {
+        app_host_event_e event;
+        clock_type::time_point t;
+    };
+
+    std::vector<event_t> events;
+    std::map<std::string, std::vector<double>> stages;      // microseconds
+
+    void onEvent(app_host_event_e event, void *) {
+        events.push_back({event, clock_type::now()});
+    }
+
+    double us(clock_type::time_point a, clock_type::time_point b) {
+        return std::chrono::duration<double, std::micro>(b - a).count();
+    }
+
+    const event_t *find(app_host_event_e e) {
+        for (const auto &ev : events) {
+            if (ev.event == e) {
+                return &ev;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Splits the events recorded while one APDU was processed into stages
+    void classify(const bytes_t &apdu, app_host_user_e user) {
+        const event_t *start = find(app_host_event_apdu_start);
+        const event_t *end = find(app_host_event_apdu_end);
+        if (start == nullptr || end == nullptr || apdu.size() < OFFSET_DATA) {
+            return;
+        }
+
+        const uint8_t ins = apdu[OFFSET_INS];
+        const uint8_t payloadType = apdu[OFFSET_PAYLOAD_TYPE];
+        switch (ins) {
+            case INS_GET_VERSION:
+                stages["get_version"].push_back(us(start->t, end->t));
+                return;
+            case INS_GET_ADDR_ED25519:
+                stages["get_addr"].push_back(us(start->t, end->t));
+                return;
+            default:
+                break;
+        }
+
+        if (payloadType == PAYLOAD_TYPE_INIT) {
+            stages["chunk_init"].push_back(us(start->t, end->t));
+            return;
+        }
+        if (payloadType == PAYLOAD_TYPE_ADD) {
+            // Once the RAM buffer is full, chunks are written to the emulated flash
+            const bool flash = buffering_get_flash_buffer()->in_use != 0;
+            stages[flash ? "chunk_append_flash" : "chunk_append_ram"].push_back(us(start->t, end->t));
+            return;
+        }
+
+        const event_t *review = find(app_host_event_review_start);
+        if (review == nullptr) {
+            // Rejected by the parser
+            stages["parse_error"].push_back(us(start->t, end->t));
+            return;
+        }
+        // Includes the append of the last chunk
+        stages["parse"].push_back(us(start->t, review->t));
+
+        bool first = true;
+        clock_type::time_point pageStart;
+        for (const auto &ev : events) {
+            if (ev.event == app_host_event_page_start) {
+                pageStart = ev.t;
+            } else if (ev.event == app_host_event_page_end) {
+                stages[first ? "render_first_item" : "render_page"].push_back(us(pageStart, ev.t));
+                first = false;
+            }
+        }
+
+        const event_t *answer = find(app_host_event_user);
+        if (answer != nullptr) {
+            stages[user == app_host_user_accept ? "sign" : "reject"].push_back(us(answer->t, end->t));
+        }
+    }
+
+    void run(const session_t &session) {
+        uint8_t reply[300];
+        for (const auto &step : session.steps) {
+            app_host_set_user(step.user);
+            events.clear();
+            app_host_exchange(step.apdu.data(), step.apdu.size(), reply, sizeof(reply));
+            classify(step.apdu, step.user);
+        }
+    }
+
+    session_t signSession(const std::string &name, const bytes_t &tx, size_t chunk,
+                          app_host_user_e user = app_host_user_accept) {
+        session_t s{name, {}};
+        s.steps.push_back({apdu(INS_GET_VERSION, 0, 0, {}), app_host_user_accept});
+        s.steps.push_back({apdu(INS_GET_ADDR_ED25519, 0, 0, path(0)), app_host_user_accept});
+        for (const auto &a : sign_apdus(INS_SIGN_ED25519, path(0), tx, chunk)) {
+            s.steps.push_back({a, user});
+        }
+        return s;
+    }
+
+    std::vector<session_t> corpus(size_t chunk) {
+        send_tx noMemo;
+        noMemo.memo = "";
+        send_tx longMemo;
+        longMemo.memo = std::string(TX_MEMOLEN_MAX, 'm');
+
+        return {
+            signSession("send", build(noMemo), chunk),
+            signSession("send_memo128", build(longMemo), chunk),
+            signSession("send_reject", build(send_tx()), chunk, app_host_user_reject),
+            signSession("vote", build_msg(PBIDX_TX_VOTEMSG, vote_msg(VOTE_OPTION_NO)), chunk),
+            signSession("update_1", build_msg(PBIDX_TX_UPDATEMSG, update_msg(1)), chunk),
+            signSession("update_16", build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX)),
+                        chunk),
+            signSession("batch_4", build_msg(PBIDX_TX_BATCHMSG, batch_msg(4)), chunk),
+            signSession("batch_16", build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX)), chunk),
+        };
+    }
+
+    bool loadTranscript(const std::string &path, session_t *session) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+        session->name = path;
+
+        app_host_user_e user = app_host_user_accept;
+        std::string line;
+        while (std::getline(in, line)) {
+            line = line.substr(0, line.find('#'));
+            line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+            if (line.empty()) {
+                continue;
+            }
+            if (line == "useraccept" || line == "userreject") {
+                user = line == "useraccept" ? app_host_user_accept : app_host_user_reject;
+                continue;
+            }
+            if (line.size() % 2 != 0) {
+                return false;
+            }
+            bytes_t apduBytes;
+            for (size_t i = 0; i < line.size(); i += 2) {
+                apduBytes.push_back((uint8_t) std::stoul(line.substr(i, 2), nullptr, 16));
+            }
+            session->steps.push_back({apduBytes, user});
+        }
+        return true;
+    }
+
+    /// Work done by each ticker event while a transaction is reviewed. The account node is
+    /// measured from scratch, as on the first signature of a session
+    void measureSignPrepare() {
+        const bytes_t message(4 * SIGN_PREPARE_DIGEST_STEP, 0x5A);
+        hdPath[0] = HDPATH_0_DEFAULT;
+        hdPath[1] = HDPATH_1_DEFAULT;
+        hdPath[2] = 0x80000000u;
+        crypto_signPrepareClear();
+        crypto_accountNodeClear();
+        for (bool done = false; !done;) {
+            const auto start = clock_type::now();
+            done = crypto_signPrepareDigestStep(message.data(), message.size(), SIGN_PREPARE_DIGEST_STEP);
+            stages["tick_digest_step"].push_back(us(start, clock_type::now()));
+        }
+
+        auto start = clock_type::now();
+        crypto_signPrepareAccountNode();
+        stages["tick_account_node"].push_back(us(start, clock_type::now()));
+
+        start = clock_type::now();
+        crypto_signPrepareKey();
+        stages["tick_derive_key"].push_back(us(start, clock_type::now()));
+        crypto_signPrepareClear();
+    }
+
+    double percentile(std::vector<double> v, double p) {
+        std::sort(v.begin(), v.end());
+        size_t rank = (size_t) (p / 100.0 * v.size() + 0.5);
+        rank = std::min(std::max(rank, (size_t) 1), v.size());
+        return v[rank - 1];
+    }
+}
+
+int main(int argc, char **argv) {
+    size_t iterations = 100;
+    size_t chunk = 250;
+    std::string jsonPath;
+    std::string tracePath;
+    std::vector<session_t> sessions;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::stoul(argv[++i]);
+        } else if (arg == "--chunk" && i + 1 < argc) {
+            chunk = std::min<size_t>(std::stoul(argv[++i]), 250);
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (arg == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            session_t s;
+            if (!loadTranscript(arg, &s)) {
+                fprintf(stderr, "Cannot read transcript %s\n", arg.c_str());
+                return 1;
+            }
+            sessions.push_back(s);
+        }
+    }
+    if (sessions.empty()) {
+        sessions = corpus(chunk);
+    }
+
+    app_host_init();
+    app_host_set_event_callback(onEvent, nullptr);
+    if (!tracePath.empty()) {
+#if defined(APP_TRACE)
+        trace_enable(true);
+#else
+        fprintf(stderr, "--trace needs a build with -DTRACE=ON\n");
+        return 1;
+#endif
+    }
+
+    for (size_t i = 0; i < iterations; i++) {
+        for (const auto &s : sessions) {
+            run(s);
+        }
+        measureSignPrepare();
+    }
+
+    printf("%-22s %8s %10s %10s %10s\n", "stage", "count", "p50 [us]", "p99 [us]", "max [us]");
+    for (const auto &s : stages) {
+        printf("%-22s %8zu %10.2f %10.2f %10.2f\n", s.first.c_str(), s.second.size(),
+               percentile(s.second, 50), percentile(s.second, 99),
+               *std::max_element(s.second.begin(), s.second.end()));
+    }
+
+    if (!jsonPath.empty()) {
+        FILE *f = fopen(jsonPath.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        fprintf(f, "{\n  \"iterations\": %zu,\n  \"stages\": {", iterations);
+        const char *sep = "\n";
+        for (const auto &s : stages) {
+            fprintf(f, "%s    \"%s\": {\"count\": %zu, \"p50_us\": %.3f, \"p99_us\": %.3f}",
+                    sep, s.first.c_str(), s.second.size(),
+                    percentile(s.second, 50), percentile(s.second, 99));
+            sep = ",\n";
+        }
+        fprintf(f, "\n  }\n}\n");
+        fclose(f);
+    }
+
+#if defined(APP_TRACE)
+    if (!tracePath.empty()) {
+        trace_enable(false);
+        FILE *f = fopen(tracePath.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", tracePath.c_str());
+            return 1;
+        }
+        printf("%u trace events written to %s\n", trace_write_chrome(f), tracePath.c_str());
+        fclose(f);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Deepest stack use of each public entry point over the transaction corpus (stack painting):
+//
+//   iov_stack_usage [--json out.json]
+//
+// Numbers are for the host ABI. For the device budget (STACK_SIZE in script.ld) use
+// scripts/stack_depth.py on a device build.
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "app_host.h"
+#include "app_main.h"
+#include "lib/parser.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    struct high_water_t {
+        size_t bytes = 0;
+        std::string where;
+    };
+
+    std::map<std::string, high_water_t> report;
+
+    void record(const std::string &api, const std::string &where, size_t bytes) {
+        high_water_t &h = report[api];
+        if (bytes > h.bytes) {
+            h.bytes = bytes;
+            h.where = where;
+        }
+    }
+
+    struct parser_call_t {
+        const bytes_t *data;
+        parser_context_t ctx;
+        parser_tx_t tx;
+        int8_t displayIdx;
+        uint8_t pageIdx;
+        uint8_t pageCount;
+        parser_error_t err;
+    };
+
+    struct exchange_call_t {
+        const bytes_t *command;
+        uint8_t reply[300];
+    };
+
+    std::vector<std::pair<std::string, bytes_t>> corpus() {
+        send_tx noMemo;
+        noMemo.memo = "";
+        send_tx longMemo;
+        longMemo.memo = std::string(TX_MEMOLEN_MAX, 'm');
+
+        return {
+            {"send", build(noMemo)},
+            {"send_memo128", build(longMemo)},
+            {"vote", build_msg(PBIDX_TX_VOTEMSG, vote_msg(VOTE_OPTION_YES))},
+            {"update_1", build_msg(PBIDX_TX_UPDATEMSG, update_msg(1))},
+            {"update_16", build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX))},
+            {"batch_1", build_msg(PBIDX_TX_BATCHMSG, batch_msg(1))},
+            {"batch_16", build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX))},
+        };
+    }
+
+    void measureParser(const std::string &name, const bytes_t &data) {
+        parser_call_t call;
+        call.data = &data;
+
+        record("parser_parse", name, app_host_stack_usage([](void *arg) {
+            auto c = (parser_call_t *) arg;
+            c->err = parser_parse(&c->ctx, c->data->data(), c->data->size(), &c->tx);
+        }, &call));
+        if (call.err != parser_ok) {
+            fprintf(stderr, "%s: %s\n", name.c_str(), parser_getErrorDescription(call.err));
+            return;
+        }
+
+        record("parser_validate", name, app_host_stack_usage([](void *arg) {
+            auto c = (parser_call_t *) arg;
+            c->err = parser_validate(&c->ctx, bool_true);
+        }, &call));
+
+        for (call.displayIdx = 0; call.displayIdx < parser_getNumItems(&call.ctx); call.displayIdx++) {
+            call.pageCount = 1;
+            for (call.pageIdx = 0; call.pageIdx < call.pageCount; call.pageIdx++) {
+                const size_t bytes = app_host_stack_usage([](void *arg) {
+                    auto c = (parser_call_t *) arg;
+                    // Nano S screen buffers
+                    char key[33];
+                    char value[37];
+                    c->err = parser_getItem(&c->ctx, c->displayIdx, key, sizeof(key), value, sizeof(value),
+                                            c->pageIdx, &c->pageCount);
+                }, &call);
+                record("parser_getItem", name + " item " + std::to_string(call.displayIdx), bytes);
+            }
+        }
+    }
+
+    void measureApdu(const std::string &api, const std::string &name, const bytes_t &command) {
+        exchange_call_t call;
+        call.command = &command;
+        record(api, name, app_host_stack_usage([](void *arg) {
+            auto c = (exchange_call_t *) arg;
+            app_host_exchange(c->command->data(), c->command->size(), c->reply, sizeof(c->reply));
+        }, &call));
+    }
+
+    void measureApp(const std::string &name, const bytes_t &data) {
+        for (const auto &command : sign_apdus(INS_SIGN_ED25519, path(0), data)) {
+            static const char *stage[] = {"APDU sign init", "APDU sign add", "APDU sign last (review + sign)"};
+            measureApdu(stage[command[OFFSET_PAYLOAD_TYPE]], name, command);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string jsonPath;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            fprintf(stderr, "usage: iov_stack_usage [--json out.json]\n");
+            return 1;
+        }
+    }
+
+    app_host_init();
+    measureApdu("APDU get version", "", apdu(INS_GET_VERSION, 0, 0, {}));
+    measureApdu("APDU get address (show)", "", apdu(INS_GET_ADDR_ED25519, 1, 0, path(0)));
+
+    for (const auto &c : corpus()) {
+        measureParser(c.first, c.second);
+        measureApp(c.first, c.second);
+    }
+
+    printf("%-32s %8s  %s\n", "entry point", "bytes", "deepest case");
+    for (const auto &r : report) {
+        printf("%-32s %8zu  %s\n", r.first.c_str(), r.second.bytes, r.second.where.c_str());
+    }
+
+    if (!jsonPath.empty()) {
+        FILE *f = fopen(jsonPath.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        fprintf(f, "{");
+        const char *sep = "\n";
+        for (const auto &r : report) {
+            fprintf(f, "%s  \"%s\": {\"bytes\": %zu, \"case\": \"%s\"}",
+                    sep, r.first.c_str(), r.second.bytes, r.second.where.c_str());
+            sep = ",\n";
+        }
+        fprintf(f, "\n}\n");
+        fclose(f);
+    }
+    return 0;
+}
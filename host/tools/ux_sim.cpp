@@ -0,0 +1,358 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Walks the transaction review as a user would and counts what it costs on each device:
+//
+//   iov_ux_sim [--device nanos|nanox|all] [--compact] [--screens] [--snapshots DIR] [--json out.json] [corpus ...]
+//
+// screens  screens shown from the first one up to "Sign transaction"
+// clicks   right button presses needed to reach "Sign transaction"
+//
+// Nano S: view_s.c shows the review right away, one screen per page of h_review_update_data with
+// the value split by splitValueField (18 + 18 characters), then menu_sign ("View transaction",
+// "Sign transaction").
+// Nano X: ux_sign_flow in view_x.c starts with "View transaction", then bnnn_paging screens of
+// X_LINES lines per item, then "Sign transaction". Character widths are not modelled: a line
+// holds X_LINE_CHARS characters.
+//
+// --compact selects the compact review mode of the settings menu, which adds "View details" before
+// "Sign transaction".
+// --screens prints a text snapshot of every screen, --snapshots writes them to DIR/<tx>.<device>.txt.
+// Without corpus files the built-in transactions (tests/tx_builder.h, tests/tx_worst.h) are used.
+// A corpus file has one hex encoded transaction (sign bytes) per line; '#' starts a comment.
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "app_host.h"
+#include "lib/parser_txdef.h"
+extern "C" {
+#include "tx.h"
+#include "view_internal.h"
+}
+#include "tx_builder.h"
+#include "tx_worst.h"
+
+using namespace iov_test;
+
+namespace {
+    // Key and value buffers of view_internal.h for TARGET_NANOX
+    const size_t X_KEY_LEN = 64;
+    const size_t X_VALUE_LEN = 4096;
+    // 114 px per line, about 6 px per character of Open Sans 11px
+    const size_t X_LINE_CHARS = 19;
+    const size_t X_LINES = 3;
+
+    struct tx_case {
+        std::string name;
+        bytes_t data;
+    };
+
+    struct screen_t {
+        std::string title;
+        std::vector<std::string> lines;
+    };
+
+    struct review_t {
+        std::string error;
+        uint16_t items = 0;
+        std::vector<screen_t> screens;
+
+        size_t clicks() const {
+            // The first screen is shown without pressing anything
+            return screens.empty() ? 0 : screens.size() - 1;
+        }
+    };
+
+    std::string load(const bytes_t &data) {
+        tx_initialize();
+        tx_reset();
+        bytes_t copy = data;
+        if (tx_append(copy.data(), copy.size()) != copy.size()) {
+            return "Transaction too large";
+        }
+#ifdef MAINNET_ENABLED
+        const char *err = tx_parse(bool_true);
+#else
+        const char *err = tx_parse(bool_false);
+#endif
+        return err == nullptr ? "" : err;
+    }
+
+    review_t reviewNanoS(const bytes_t &data) {
+        review_t r;
+        r.error = load(data);
+        if (!r.error.empty()) {
+            return r;
+        }
+
+        h_review_init();
+        int16_t lastIdx = -1;
+        for (;;) {
+            const view_error_t err = h_review_update_data();
+            if (err == view_no_data) {
+                break;
+            }
+            if (err != view_no_error) {
+                r.error = "Error screen at item " + std::to_string(viewdata.idx);
+                return r;
+            }
+            if (viewdata.idx != lastIdx) {
+                lastIdx = viewdata.idx;
+                r.items++;
+            }
+
+            // splitValueField in view_s.c
+            const std::string value = viewdata.value;
+            screen_t s{viewdata.key, {value.substr(0, MAX_CHARS_PER_VALUE_LINE), ""}};
+            if (value.size() > MAX_CHARS_PER_VALUE_LINE) {
+                s.lines[1] = value.substr(MAX_CHARS_PER_VALUE_LINE);
+            }
+            r.screens.push_back(s);
+            h_review_increase();
+        }
+
+        // menu_sign / menu_sign_compact
+        r.screens.push_back({"View transaction", {}});
+        if (tx_get_review_mode() == tx_review_compact) {
+            r.screens.push_back({"View details", {}});
+        }
+        r.screens.push_back({"Sign transaction", {}});
+        return r;
+    }
+
+    review_t reviewNanoX(const bytes_t &data) {
+        review_t r;
+        r.error = load(data);
+        if (!r.error.empty()) {
+            return r;
+        }
+        r.screens.push_back({"View", {"Transaction"}});
+
+        // h_review_update_data with the Nano X buffers
+        std::vector<char> key(X_KEY_LEN), value(X_VALUE_LEN);
+        h_review_init();
+        for (;;) {
+            const tx_error_t err = tx_getItem(viewdata.idx, key.data(), key.size(), value.data(), value.size(),
+                                              viewdata.pageIdx, &viewdata.pageCount);
+            if (err == tx_no_data) {
+                break;
+            }
+            if (err != tx_no_error) {
+                r.error = "Error screen at item " + std::to_string(viewdata.idx);
+                return r;
+            }
+            if (viewdata.pageCount == 0) {
+                h_review_increase();
+                continue;
+            }
+            if (viewdata.pageIdx == 0) {
+                r.items++;
+            }
+
+            // bnnn_paging: the value is wrapped and shown X_LINES lines at a time
+            const std::string text = value.data();
+            std::vector<std::string> lines;
+            for (size_t i = 0; i < text.size(); i += X_LINE_CHARS) {
+                lines.push_back(text.substr(i, X_LINE_CHARS));
+            }
+            if (lines.empty()) {
+                lines.emplace_back();
+            }
+            const size_t pages = (lines.size() + X_LINES - 1) / X_LINES;
+            for (size_t p = 0; p < pages; p++) {
+                screen_t s{key.data(), {}};
+                if (pages > 1) {
+                    s.title += " (" + std::to_string(p + 1) + "/" + std::to_string(pages) + ")";
+                }
+                for (size_t l = p * X_LINES; l < std::min(lines.size(), (p + 1) * X_LINES); l++) {
+                    s.lines.push_back(lines[l]);
+                }
+                r.screens.push_back(s);
+            }
+            h_review_increase();
+        }
+
+        if (tx_get_review_mode() == tx_review_compact) {
+            r.screens.push_back({"View", {"Details"}});
+        }
+        r.screens.push_back({"Sign", {"Transaction"}});
+        return r;
+    }
+
+    void printScreens(FILE *f, const review_t &r) {
+        for (size_t i = 0; i < r.screens.size(); i++) {
+            fprintf(f, "[%zu] %s\n", i + 1, r.screens[i].title.c_str());
+            for (const auto &line : r.screens[i].lines) {
+                fprintf(f, line.empty() ? "\n" : "    %s\n", line.c_str());
+            }
+        }
+    }
+
+    std::vector<tx_case> corpus() {
+        send_tx noMemo;
+        noMemo.memo = "";
+        send_tx longMemo;
+        longMemo.memo = std::string(TX_MEMOLEN_MAX, 'm');
+
+        std::vector<tx_case> out = {
+            {"send", build(noMemo)},
+            {"send_memo", build(send_tx())},
+            {"send_memo128", build(longMemo)},
+            {"vote", build_msg(PBIDX_TX_VOTEMSG, vote_msg(VOTE_OPTION_NO))},
+            {"update_1", build_msg(PBIDX_TX_UPDATEMSG, update_msg(1))},
+            {"update_16", build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX))},
+            {"batch_4", build_msg(PBIDX_TX_BATCHMSG, batch_msg(4))},
+            {"batch_16", build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX))},
+        };
+        for (const auto &c : worst_cases()) {
+            out.push_back({c.first, c.second});
+        }
+        return out;
+    }
+
+    bool loadCorpus(const std::string &path, std::vector<tx_case> *out) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+
+        std::string line;
+        size_t lineNo = 0;
+        while (std::getline(in, line)) {
+            lineNo++;
+            line = line.substr(0, line.find('#'));
+            line.erase(std::remove_if(line.begin(), line.end(), ::isspace), line.end());
+            if (line.empty()) {
+                continue;
+            }
+            if (line.size() % 2 != 0) {
+                return false;
+            }
+            bytes_t data;
+            for (size_t i = 0; i < line.size(); i += 2) {
+                data.push_back((uint8_t) std::stoul(line.substr(i, 2), nullptr, 16));
+            }
+            out->push_back({path + ":" + std::to_string(lineNo), data});
+        }
+        return true;
+    }
+
+    std::string fileName(std::string name) {
+        std::replace_if(name.begin(), name.end(), [](char c) { return !isalnum(c) && c != '_' && c != '-'; }, '_');
+        return name;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> devices = {"nanos", "nanox"};
+    bool compact = false;
+    bool showScreens = false;
+    std::string snapshotDir;
+    std::string jsonPath;
+    std::vector<tx_case> txs;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--device" && i + 1 < argc) {
+            const std::string device = argv[++i];
+            if (device != "all") {
+                devices = {device};
+            }
+        } else if (arg == "--compact") {
+            compact = true;
+        } else if (arg == "--screens") {
+            showScreens = true;
+        } else if (arg == "--snapshots" && i + 1 < argc) {
+            snapshotDir = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (!loadCorpus(arg, &txs)) {
+            fprintf(stderr, "Cannot read corpus %s\n", arg.c_str());
+            return 1;
+        }
+    }
+    for (const auto &device : devices) {
+        if (device != "nanos" && device != "nanox") {
+            fprintf(stderr, "Unknown device %s\n", device.c_str());
+            return 1;
+        }
+    }
+    if (txs.empty()) {
+        txs = corpus();
+    }
+
+    app_host_init();
+    tx_settings_set_review_mode(compact ? tx_review_compact : tx_review_full);
+
+    int ret = 0;
+    std::string json = "{";
+    for (const auto &device : devices) {
+        printf("%s\n%-22s %6s %8s %7s\n", device.c_str(), "tx", "items", "screens", "clicks");
+        json += std::string(json.size() > 1 ? ",\n" : "\n") + "  \"" + device + "\": {";
+
+        for (size_t t = 0; t < txs.size(); t++) {
+            const auto &tx = txs[t];
+            const review_t r = device == "nanos" ? reviewNanoS(tx.data) : reviewNanoX(tx.data);
+            json += std::string(t > 0 ? "," : "") + "\n    \"" + tx.name + "\": ";
+
+            if (!r.error.empty()) {
+                printf("%-22s %s\n", tx.name.c_str(), r.error.c_str());
+                json += "{\"error\": \"" + r.error + "\"}";
+                ret = 1;
+                continue;
+            }
+
+            printf("%-22s %6u %8zu %7zu\n", tx.name.c_str(), r.items, r.screens.size(), r.clicks());
+            json += "{\"items\": " + std::to_string(r.items) +
+                    ", \"screens\": " + std::to_string(r.screens.size()) +
+                    ", \"clicks\": " + std::to_string(r.clicks()) + "}";
+
+            if (showScreens) {
+                printScreens(stdout, r);
+                printf("\n");
+            }
+            if (!snapshotDir.empty()) {
+                const std::string path = snapshotDir + "/" + fileName(tx.name) + "." + device + ".txt";
+                FILE *f = fopen(path.c_str(), "w");
+                if (f == nullptr) {
+                    fprintf(stderr, "Cannot write %s\n", path.c_str());
+                    return 1;
+                }
+                printScreens(f, r);
+                fclose(f);
+            }
+        }
+        json += "\n  }";
+        printf("\n");
+    }
+    json += "\n}\n";
+
+    if (!jsonPath.empty()) {
+        FILE *f = fopen(jsonPath.c_str(), "w");
+        if (f == nullptr) {
+            fprintf(stderr, "Cannot write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        fputs(json.c_str(), f);
+        fclose(f);
+    }
+
+    return ret;
+}
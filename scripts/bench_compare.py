@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+#  (c) 2019 Zondax GmbH
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#*******************************************************************************
+"""Compares two iov_bench JSON reports.
+
+    iov_bench --benchmark_out=base.json --benchmark_out_format=json
+    ... apply the change, rebuild ...
+    iov_bench --benchmark_out=new.json --benchmark_out_format=json
+    scripts/bench_compare.py base.json new.json --max-regression 5
+
+With --benchmark_repetitions the median of each benchmark is compared.
+Exits with 1 when a benchmark is slower than --max-regression percent.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path, metric):
+    with open(path) as f:
+        report = json.load(f)
+
+    has_median = any(b.get("aggregate_name") == "median" for b in report["benchmarks"])
+
+    results = {}
+    for b in report["benchmarks"]:
+        if b.get("error_occurred"):
+            continue
+        if has_median:
+            if b.get("aggregate_name") != "median":
+                continue
+            name = b["run_name"]
+        else:
+            if b.get("run_type") == "aggregate":
+                continue
+            name = b["name"]
+
+        # Normalize to ns/op
+        scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}[b.get("time_unit", "ns")]
+        results[name] = {
+            "time": b[metric] * scale,
+            "bytes_per_second": b.get("bytes_per_second"),
+        }
+    return results
+
+
+def fmt_rate(v):
+    if v is None:
+        return "-"
+    for unit in ["B/s", "KiB/s", "MiB/s", "GiB/s"]:
+        if v < 1024:
+            return "%.1f %s" % (v, unit)
+        v /= 1024
+    return "%.1f TiB/s" % v
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two iov_bench JSON reports")
+    parser.add_argument("base")
+    parser.add_argument("new")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="cpu_time")
+    parser.add_argument("--max-regression", type=float, default=None,
+                        help="fail if any benchmark is slower by more than this percentage")
+    parser.add_argument("--filter", default="", help="only compare benchmarks containing this string")
+    args = parser.parse_args()
+
+    base = load(args.base, args.metric)
+    new = load(args.new, args.metric)
+
+    names = [n for n in base if n in new and args.filter in n]
+    if not names:
+        print("No common benchmarks")
+        return 1
+
+    width = max(len(n) for n in names)
+    print("%-*s %12s %12s %8s %14s %14s" % (width, "Benchmark", "base ns/op", "new ns/op", "delta",
+                                           "base rate", "new rate"))
+
+    regressions = []
+    for name in names:
+        b, n = base[name], new[name]
+        delta = (n["time"] - b["time"]) / b["time"] * 100 if b["time"] > 0 else 0.0
+        print("%-*s %12.1f %12.1f %+7.1f%% %14s %14s" % (width, name, b["time"], n["time"], delta,
+                                                       fmt_rate(b["bytes_per_second"]),
+                                                       fmt_rate(n["bytes_per_second"])))
+        if args.max_regression is not None and delta > args.max_regression:
+            regressions.append((name, delta))
+
+    for name in sorted(set(base) - set(new)):
+        print("missing in new: %s" % name)
+    for name in sorted(set(new) - set(base)):
+        print("only in new: %s" % name)
+
+    if regressions:
+        print()
+        for name, delta in regressions:
+            print("REGRESSION %s: %+.1f%%" % (name, delta))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
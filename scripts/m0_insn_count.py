@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+#  (c) 2019 Zondax GmbH
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#*******************************************************************************
+"""Counts Cortex-M0 instructions per parser and formatting operation.
+
+    cmake -S benchmarks/m0 -B build_m0 -DCMAKE_TOOLCHAIN_FILE=benchmarks/m0/thumbv6m.cmake
+    cmake --build build_m0
+    scripts/m0_insn_count.py --build build_m0 --plugin /path/to/libinsn.so --json m0.json
+    ... apply the change, rebuild ...
+    scripts/m0_insn_count.py --build build_m0 --plugin /path/to/libinsn.so --baseline m0.json
+
+The drivers (bench_m0_nanos.elf, bench_m0_nanox.elf) run under qemu-system-arm with the
+instruction counting TCG plugin (tests/plugin/insn.c in the QEMU tree). Every case runs twice,
+with 0 and with --reps operations; the difference divided by --reps is the cost of one operation.
+"""
+
+import argparse
+import concurrent.futures
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+DEVICES = ["nanos", "nanox"]
+
+
+def qemu_cmd(args, elf, guest_args, log):
+    semihosting = ",".join(["enable=on", "target=native", "arg=bench_m0"] + ["arg=%s" % a for a in guest_args])
+    cmd = [args.qemu, "-M", "mps2-an385", "-nographic", "-monitor", "none", "-serial", "none",
+           "-semihosting-config", semihosting, "-kernel", elf]
+    if log is not None:
+        cmd += ["-plugin", "%s,inline=on" % args.plugin, "-d", "plugin", "-D", log]
+    return cmd
+
+
+def list_cases(args, elf):
+    out = subprocess.run(qemu_cmd(args, elf, ["list"], None), check=True, timeout=args.timeout,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    return [line.strip() for line in out.splitlines() if line.strip()]
+
+
+def count(args, elf, case, reps):
+    with tempfile.NamedTemporaryFile(suffix=".log") as log:
+        proc = subprocess.run(qemu_cmd(args, elf, [case, str(reps)], log.name), timeout=args.timeout,
+                              stdout=subprocess.PIPE, universal_newlines=True)
+        if proc.stdout.strip():
+            raise RuntimeError("%s: %s" % (case, proc.stdout.strip()))
+        with open(log.name) as f:
+            m = re.search(r"insns: (\d+)", f.read())
+        if m is None:
+            raise RuntimeError("%s: no instruction count, is the insn plugin loaded?" % case)
+        return int(m.group(1))
+
+
+def measure(args, elf, case):
+    base = count(args, elf, case, 0)
+    total = count(args, elf, case, args.reps)
+    return (total - base) / args.reps
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Instructions per operation on Cortex-M0")
+    parser.add_argument("--build", required=True, help="cross build directory of benchmarks/m0")
+    parser.add_argument("--plugin", default=os.environ.get("QEMU_INSN_PLUGIN"),
+                        help="path to QEMU's libinsn.so (default: $QEMU_INSN_PLUGIN)")
+    parser.add_argument("--qemu", default="qemu-system-arm")
+    parser.add_argument("--device", choices=DEVICES + ["all"], default="all")
+    parser.add_argument("--reps", type=int, default=4, help="operations per measured run")
+    parser.add_argument("--filter", default="", help="only cases containing this string")
+    parser.add_argument("--jobs", "-j", type=int, default=os.cpu_count())
+    parser.add_argument("--timeout", type=int, default=120)
+    parser.add_argument("--json", help="write the counts to this file")
+    parser.add_argument("--baseline", help="counts of a previous --json run to compare against")
+    args = parser.parse_args()
+
+    if not args.plugin:
+        parser.error("--plugin or QEMU_INSN_PLUGIN is required")
+    if args.reps < 1:
+        parser.error("--reps must be at least 1")
+
+    devices = DEVICES if args.device == "all" else [args.device]
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    results = {}
+    for device in devices:
+        elf = os.path.join(args.build, "bench_m0_%s.elf" % device)
+        cases = [c for c in list_cases(args, elf) if args.filter in c]
+        with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+            counts = pool.map(lambda c: measure(args, elf, c), cases)
+            results[device] = dict(zip(cases, counts))
+
+    width = max(len(c) for r in results.values() for c in r) if results else 10
+    for device in devices:
+        print("%s\n%-*s %14s %14s %8s" % (device, width, "case", "insns/op", "baseline", "delta"))
+        for case, insns in results[device].items():
+            base = baseline.get(device, {}).get(case)
+            if base:
+                print("%-*s %14.0f %14.0f %+7.1f%%" % (width, case, insns, base, (insns - base) / base * 100))
+            else:
+                print("%-*s %14.0f %14s %8s" % (width, case, insns, "-", "-"))
+        print()
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
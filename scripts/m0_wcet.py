@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+#  (c) 2019 Zondax GmbH
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#*******************************************************************************
+"""Worst-case instruction counts for parse and render on Cortex-M0.
+
+Runs the worst-case transactions of tests/tx_worst.h through the benchmarks/m0 drivers (see
+scripts/m0_insn_count.py for the build) and reports per message type:
+
+    parser_Tx      parser_parse of the whole transaction
+    first screen   last chunk to first screen: parse, validate and the first page
+    page turn      the most expensive single page over all items
+    per item       the most expensive page of every display item
+
+    scripts/m0_wcet.py --build build_m0 --plugin /path/to/libinsn.so --max-page 200000
+
+Exits with 1 when a limit is exceeded.
+"""
+
+import argparse
+import concurrent.futures
+import json
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from m0_insn_count import DEVICES, list_cases, measure  # noqa: E402
+
+
+def analyze(args, elf):
+    cases = [c for c in list_cases(args, elf) if "/worst_" in c]
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        counts = dict(zip(cases, pool.map(lambda c: measure(args, elf, c), cases)))
+
+    report = {}
+    for case, insns in counts.items():
+        parts = case.split("/")
+        op, tx = parts[0], parts[1]
+        r = report.setdefault(tx, {"parse": 0, "first_screen": 0, "page_max": 0, "page_max_at": "", "items": {}})
+        if op == "parse":
+            r["parse"] = insns
+        elif op == "first_screen":
+            r["first_screen"] = insns
+        elif op == "page":
+            item, page = int(parts[2]), int(parts[3])
+            r["items"][item] = max(insns, r["items"].get(item, 0))
+            if insns > r["page_max"]:
+                r["page_max"] = insns
+                r["page_max_at"] = "item %d page %d" % (item, page)
+    return report
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Worst-case instruction counts on Cortex-M0")
+    parser.add_argument("--build", required=True, help="cross build directory of benchmarks/m0")
+    parser.add_argument("--plugin", default=os.environ.get("QEMU_INSN_PLUGIN"),
+                        help="path to QEMU's libinsn.so (default: $QEMU_INSN_PLUGIN)")
+    parser.add_argument("--qemu", default="qemu-system-arm")
+    parser.add_argument("--device", choices=DEVICES + ["all"], default="all")
+    parser.add_argument("--reps", type=int, default=2)
+    parser.add_argument("--jobs", "-j", type=int, default=os.cpu_count())
+    parser.add_argument("--timeout", type=int, default=120)
+    parser.add_argument("--max-first-screen", type=int, help="fail above this many instructions")
+    parser.add_argument("--max-page", type=int, help="fail if a page turn needs more instructions")
+    parser.add_argument("--items", action="store_true", help="also list the worst page of every item")
+    parser.add_argument("--json", help="write the report to this file")
+    args = parser.parse_args()
+
+    if not args.plugin:
+        parser.error("--plugin or QEMU_INSN_PLUGIN is required")
+    if args.reps < 1:
+        parser.error("--reps must be at least 1")
+
+    devices = DEVICES if args.device == "all" else [args.device]
+    failed = False
+    results = {}
+    for device in devices:
+        report = analyze(args, os.path.join(args.build, "bench_m0_%s.elf" % device))
+        results[device] = report
+
+        print("%s\n%-14s %12s %14s %12s  %s" % (device, "tx", "parser_Tx", "first screen", "page turn", "worst page"))
+        for tx, r in sorted(report.items()):
+            print("%-14s %12.0f %14.0f %12.0f  %s" % (tx, r["parse"], r["first_screen"], r["page_max"], r["page_max_at"]))
+            if args.items:
+                for item, insns in sorted(r["items"].items()):
+                    print("    item %-3d %12.0f" % (item, insns))
+
+            if args.max_first_screen is not None and r["first_screen"] > args.max_first_screen:
+                print("    first screen above %d" % args.max_first_screen)
+                failed = True
+            if args.max_page is not None and r["page_max"] > args.max_page:
+                print("    page turn above %d" % args.max_page)
+                failed = True
+        print()
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
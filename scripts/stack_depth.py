@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+#*******************************************************************************
+#  (c) 2019 Zondax GmbH
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+#*******************************************************************************
+"""Worst-case stack depth from -fstack-usage frames and the call graph of the linked binary.
+
+Device build (see the stack_report target in the Makefile):
+
+    make clean && make STACK_USAGE=1 && make stack_report
+
+Host build:
+
+    cmake -S . -B build -DSTACK_USAGE=ON && cmake --build build
+    scripts/stack_depth.py --su build --elf build/iov_stack_usage --root parser_parse --root parser_getItem
+
+Frames come from the .su files, calls from the disassembly. Calls through function pointers,
+recursion and functions without .su data (assembly, libgcc, prebuilt libraries) are listed
+because their cost is not included. Exits with 1 when a root exceeds --limit.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+RE_FUNC = re.compile(r"^([0-9a-f]+) <([^>]+)>:$")
+RE_DIRECT = re.compile(r"\s(bl|blx|call|callq|b|b\.w|b\.n|jmp|jmpq)\s+[0-9a-f]+ <([^>+]+)(\+0x[0-9a-f]+)?>")
+RE_INDIRECT = re.compile(r"\s(blx\s+r\d+|call[q]?\s+\*)")
+CALLS = ("bl", "blx", "call", "callq")
+
+
+def base_name(func):
+    """foo.constprop.0, foo.isra.1, foo.part.2, foo@plt -> foo"""
+    return re.split(r"[.@]", func)[0]
+
+
+def load_frames(su_dir):
+    frames = {}
+    dynamic = set()
+    for root, _, files in os.walk(su_dir):
+        for name in files:
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name)) as f:
+                for line in f:
+                    parts = line.rstrip("\n").split("\t")
+                    if len(parts) < 3:
+                        continue
+                    func = base_name(parts[0].split(":")[-1])
+                    size = int(parts[1])
+                    # Static functions with the same name in several files: keep the largest
+                    frames[func] = max(size, frames.get(func, 0))
+                    if parts[2].startswith("dynamic") and "bounded" not in parts[2]:
+                        dynamic.add(func)
+    return frames, dynamic
+
+
+def load_calls(objdump, elf):
+    out = subprocess.run([objdump, "-d", "--no-show-raw-insn", elf], check=True,
+                         stdout=subprocess.PIPE, universal_newlines=True).stdout
+    calls = {}
+    indirect = set()
+    current = None
+    for line in out.splitlines():
+        m = RE_FUNC.match(line)
+        if m:
+            current = base_name(m.group(2))
+            calls.setdefault(current, set())
+            continue
+        if current is None:
+            continue
+        m = RE_DIRECT.search(line)
+        if m:
+            mnemonic, target, offset = m.groups()
+            target = base_name(target)
+            # Branches inside the function are control flow; to another function they are tail calls
+            if target != current and (mnemonic in CALLS or offset is None):
+                calls[current].add(target)
+            continue
+        if RE_INDIRECT.search(line):
+            indirect.add(current)
+    return calls, indirect
+
+
+class Analysis:
+    def __init__(self, frames, calls):
+        self.frames = frames
+        self.calls = calls
+        self.memo = {}
+        self.recursive = set()
+        self.unknown = set()
+
+    def depth(self, func, stack=()):
+        """(bytes, chain) of the deepest path starting at func"""
+        if func in self.memo:
+            return self.memo[func]
+        if func in stack:
+            self.recursive.add(func)
+            return 0, []
+        if func not in self.frames:
+            self.unknown.add(func)
+
+        best = (0, [])
+        for callee in sorted(self.calls.get(func, ())):
+            d = self.depth(callee, stack + (func,))
+            if d[0] > best[0]:
+                best = d
+        result = (self.frames.get(func, 0) + best[0], [func] + best[1])
+        self.memo[func] = result
+        return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Worst-case stack depth from -fstack-usage data")
+    parser.add_argument("--su", required=True, help="directory searched for .su files")
+    parser.add_argument("--elf", required=True, help="linked binary")
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--root", action="append", help="entry points (default: main)")
+    parser.add_argument("--limit", type=int, help="fail if a root needs more than this many bytes")
+    parser.add_argument("--top", type=int, default=15, help="largest frames to list")
+    args = parser.parse_args()
+
+    frames, dynamic = load_frames(args.su)
+    if not frames:
+        print("No .su files found in %s" % args.su)
+        return 1
+    calls, indirect = load_calls(args.objdump, args.elf)
+    analysis = Analysis(frames, calls)
+
+    failed = False
+    for root in args.root or ["main"]:
+        if root not in calls:
+            print("%s: not found in %s" % (root, args.elf))
+            failed = True
+            continue
+        total, chain = analysis.depth(root)
+        over = args.limit is not None and total > args.limit
+        failed = failed or over
+        print("%s: %d bytes%s" % (root, total, " (limit %d exceeded)" % args.limit if over else ""))
+        running = 0
+        for func in chain:
+            running += frames.get(func, 0)
+            print("    %6d %6d  %s%s" % (frames.get(func, 0), running, func, "" if func in frames else " (no .su)"))
+        print()
+
+    print("Largest frames:")
+    for func, size in sorted(frames.items(), key=lambda kv: -kv[1])[:args.top]:
+        print("    %6d  %s%s" % (size, func, " (dynamic)" if func in dynamic else ""))
+
+    reached = set(analysis.memo)
+    notes = [
+        ("Indirect calls (not followed)", sorted(indirect & reached)),
+        ("Recursion (counted once)", sorted(analysis.recursive)),
+        ("Unbounded dynamic frames", sorted(dynamic & reached)),
+        ("No .su data (counted as 0)", sorted(analysis.unknown)),
+    ]
+    for title, funcs in notes:
+        if funcs:
+            print("\n%s:\n    %s" % (title, "\n    ".join(funcs)))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -16,20 +16,270 @@
 ********************************************************************************/
 
 #include "actions.h"
+#include "app_main.h"
+#include "view_internal.h"
 #include "lib/crypto.h"
+#include "lib/pubkey_cache.h"
+#include "lib/stats.h"
+#include "lib/trace.h"
 #include "tx.h"
 #include "apdu_codes.h"
 #include <os_io_seproxyhal.h>
 #include "coin.h"
 
-uint8_t app_sign() {
+// Index of the next transaction to sign in the current batch
+uint8_t batchSignIdx = UINT8_MAX;
+
+// Signing work done from ticker events while the user reviews the transaction, so that accept
+// only has to sign. Each event does one bounded step: SIGN_PREPARE_DIGEST_STEP bytes of the digest,
+// the 44'/234' node (once per session) or the last hardened step of the key
+typedef enum {
+    sign_prepare_idle = 0,
+    sign_prepare_digest,
+    sign_prepare_account_node,
+    sign_prepare_key,
+} sign_prepare_step_e;
+
+sign_prepare_step_e signPrepareStep = sign_prepare_idle;
+
+void app_sign_prepare_start() {
+    signPrepareStep = sign_prepare_digest;
+}
+
+void app_sign_prepare_step() {
+    if (signPrepareStep == sign_prepare_idle) {
+        return;
+    }
+
+    TRACE_SCOPE("app_sign_prepare_step");
+    BEGIN_TRY
+    {
+        TRY
+        {
+            switch (signPrepareStep) {
+                case sign_prepare_digest:
+                    // Batch entries are hashed one by one when they are signed
+                    if (tx_batch_get_count() > 0 ||
+                        crypto_signPrepareDigestStep(tx_get_buffer(), tx_get_buffer_length(),
+                                                     SIGN_PREPARE_DIGEST_STEP)) {
+                        // Multipath signers derive their keys on accept, one after the other
+                        signPrepareStep = hdPathListCount > 0 ? sign_prepare_idle : sign_prepare_account_node;
+                    }
+                    break;
+                case sign_prepare_account_node:
+                    crypto_signPrepareAccountNode();
+                    signPrepareStep = sign_prepare_key;
+                    break;
+                case sign_prepare_key:
+                    // The key takes the place of the running hash, which is complete by now
+                    crypto_signPrepareKey();
+                    signPrepareStep = sign_prepare_idle;
+                    break;
+                default:
+                    signPrepareStep = sign_prepare_idle;
+                    break;
+            }
+        }
+        CATCH_OTHER(e)
+        {
+            UNUSED(e);
+            // Best effort: whatever is missing is computed on accept
+            signPrepareStep = sign_prepare_idle;
+        }
+        FINALLY
+        {}
+    }
+    END_TRY;
+}
+
+uint16_t app_sign() {
+    STATS_MARK(lastSignTick);
+
+    // Keys of the paths that sign are worth keeping in flash (no-op without PUBKEY_CACHE_NVM)
+    if (hdPathListCount > 0) {
+        for (uint8_t i = 0; i < hdPathListCount; i++) {
+            pubkey_cache_persist(hdPathList[i]);
+        }
+    } else {
+        pubkey_cache_persist(hdPath);
+    }
+
+    if (tx_batch_get_count() > 0) {
+        // The key is derived once and kept until the whole batch has been signed
+        signPrepareStep = sign_prepare_idle;
+        crypto_signPrepareKey();
+        batchSignIdx = 0;
+        return app_sign_batch_next();
+    }
+
     uint8_t *signature = G_io_apdu_buffer;
     const uint8_t *message = tx_get_buffer();
     const uint16_t messageLength = tx_get_buffer_length();
 
+    signPrepareStep = sign_prepare_idle;
+
+    if (hdPathListCount > 0) {
+        // One signature per path, all over the same message
+        const uint16_t replyLen = crypto_signMultiPath(signature, IO_APDU_BUFFER_SIZE - 2, message, messageLength);
+        hdPathListCount = 0;
+        return replyLen;
+    }
+
     return crypto_sign(signature, IO_APDU_BUFFER_SIZE - 2, message, messageLength);
 }
 
+uint8_t app_sign_batch_next() {
+    if (batchSignIdx >= tx_batch_get_count()) {
+        app_sign_clear();
+        return 0;
+    }
+
+    const uint8_t replyLen = crypto_batchSign(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2,
+                                              tx_batch_get_buffer(batchSignIdx),
+                                              tx_batch_get_buffer_length(batchSignIdx));
+    batchSignIdx++;
+
+    if (replyLen == 0 || batchSignIdx >= tx_batch_get_count()) {
+        app_sign_clear();
+    }
+
+    return replyLen;
+}
+
+void app_sign_clear() {
+    signPrepareStep = sign_prepare_idle;
+    crypto_signPrepareClear();
+    batchSignIdx = UINT8_MAX;
+}
+
+// Position of the INS_PARSE_ONLY item stream. Records are rendered again on every APDU, so only
+// the record being sent and how much of it was sent are kept
+typedef struct {
+    uint8_t active;
+    int16_t idx;            // item being sent, -1 for the header
+    int8_t pageIdx;
+    uint16_t offset;        // bytes of the current record already sent
+} parse_stream_t;
+
+parse_stream_t parseStream;
+
+void app_parse_only_start() {
+    parseStream.active = 1;
+    parseStream.idx = -1;
+    parseStream.pageIdx = 0;
+    parseStream.offset = 0;
+}
+
+void app_parse_only_clear() {
+    MEMZERO(&parseStream, sizeof(parseStream));
+}
+
+__Z_INLINE void parse_record_head(uint8_t *head, uint8_t tag, uint16_t len) {
+    head[0] = tag;
+    head[1] = len & 0xFFu;
+    head[2] = len >> 8u;
+}
+
+// Copies bytes [*offset, *offset + space) of segment to out, moving *offset to the next segment
+__Z_INLINE uint16_t parse_record_copy(uint8_t *out, uint16_t space, uint16_t *offset,
+                                      const void *segment, uint16_t segmentLen) {
+    if (*offset >= segmentLen) {
+        *offset -= segmentLen;
+        return 0;
+    }
+    uint16_t n = segmentLen - *offset;
+    if (n > space) {
+        n = space;
+    }
+    MEMCPY(out, (const uint8_t *) segment + *offset, n);
+    *offset = 0;
+    return n;
+}
+
+uint16_t app_parse_only_next(uint16_t *replyLen) {
+    *replyLen = 0;
+    if (!parseStream.active) {
+        return APDU_CODE_COMMAND_NOT_ALLOWED;
+    }
+
+    const uint16_t capacity = IO_APDU_BUFFER_SIZE - 2;
+    uint8_t head[PARSE_ITEM_HEAD_LEN];
+
+    while (*replyLen < capacity) {
+        // Render the current record. No review is on screen, so the view buffers hold the item
+        uint8_t headLen = PARSE_RECORD_HEAD_LEN;
+        uint16_t keyLen = 0;
+        uint16_t valueLen = 0;
+        uint8_t pageCount = 0;
+
+        if (parseStream.idx < 0) {
+            const uint16_t numItems = tx_getNumItems();
+            parse_record_head(head, PARSE_TAG_HEADER, 2);
+            head[headLen++] = numItems & 0xFFu;
+            head[headLen++] = numItems >> 8u;
+        } else {
+            tx_error_t err;
+            do {
+                err = tx_getItem(parseStream.idx,
+                                 viewdata.key, MAX_CHARS_PER_KEY_LINE,
+                                 viewdata.value, MAX_CHARS_PER_VALUE1_LINE,
+                                 parseStream.pageIdx, &pageCount);
+                if (err == tx_no_error && pageCount == 0) {
+                    // Not shown in the review either
+                    parseStream.idx++;
+                    parseStream.pageIdx = 0;
+                }
+            } while (err == tx_no_error && pageCount == 0);
+
+            if (err == tx_no_data) {
+                parse_record_head(head, PARSE_TAG_END, 0);
+            } else if (err != tx_no_error) {
+                app_parse_only_clear();
+                *replyLen = 0;
+                return APDU_CODE_DATA_INVALID;
+            } else {
+                keyLen = strlen(viewdata.key);
+                valueLen = strlen(viewdata.value);
+                parse_record_head(head, PARSE_TAG_ITEM, PARSE_ITEM_HEAD_LEN - PARSE_RECORD_HEAD_LEN + keyLen + valueLen);
+                head[headLen++] = parseStream.idx & 0xFFu;
+                head[headLen++] = parseStream.idx >> 8u;
+                head[headLen++] = parseStream.pageIdx;
+                head[headLen++] = pageCount;
+                head[headLen++] = keyLen;
+            }
+        }
+
+        // Send what fits of the part that was not sent yet
+        const uint16_t recordLen = headLen + keyLen + valueLen;
+        uint16_t skip = parseStream.offset;
+        uint16_t sent = parse_record_copy(G_io_apdu_buffer + *replyLen, capacity - *replyLen, &skip, head, headLen);
+        sent += parse_record_copy(G_io_apdu_buffer + *replyLen + sent, capacity - *replyLen - sent, &skip,
+                                  viewdata.key, keyLen);
+        sent += parse_record_copy(G_io_apdu_buffer + *replyLen + sent, capacity - *replyLen - sent, &skip,
+                                  viewdata.value, valueLen);
+        *replyLen += sent;
+        parseStream.offset += sent;
+
+        if (parseStream.offset < recordLen) {
+            break;
+        }
+
+        // Next record
+        parseStream.offset = 0;
+        if (head[0] == PARSE_TAG_END) {
+            app_parse_only_clear();
+            break;
+        }
+        parseStream.pageIdx++;
+        if (parseStream.idx < 0 || parseStream.pageIdx >= pageCount) {
+            parseStream.idx++;
+            parseStream.pageIdx = 0;
+        }
+    }
+
+    return APDU_CODE_OK;
+}
+
 void app_set_hrp(char *p) {
     crypto_set_hrp(p);
 }
@@ -40,6 +290,10 @@ uint8_t app_fill_address() {
     return crypto_fillAddress(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2);
 }
 
+uint16_t app_fill_public_keys(uint32_t startIndex, uint8_t count, bool includeAddressHash) {
+    return crypto_fillPublicKeys(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2, startIndex, count, includeAddressHash);
+}
+
 void app_reply_address() {
     const uint8_t replyLen = app_fill_address();
     set_code(G_io_apdu_buffer, replyLen, APDU_CODE_OK);
@@ -16,13 +16,40 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
-uint8_t app_sign();
+uint16_t app_sign();
+
+/// Signs the next transaction of an accepted batch. Returns 0 when there is nothing left to sign
+uint8_t app_sign_batch_next();
+
+/// Wipes any pending signing state (prepared key and digest, batch progress)
+void app_sign_clear();
+
+/// Starts preparing the signature of the transaction under review
+void app_sign_prepare_start();
+
+/// Does the next step of the signature preparation: a slice of the digest (SIGN_PREPARE_DIGEST_STEP bytes),
+/// the 44'/234' node or the signing key. Called from ticker events
+void app_sign_prepare_step();
+
+/// Starts the INS_PARSE_ONLY item stream of the parsed transaction
+void app_parse_only_start();
+
+/// Fills the apdu buffer with the next bytes of the item stream
+/// \return status word. APDU_CODE_COMMAND_NOT_ALLOWED when no stream was started
+uint16_t app_parse_only_next(uint16_t *replyLen);
+
+/// Drops the item stream
+void app_parse_only_clear();
 
 void app_set_hrp(char *p);
 
 uint8_t app_fill_address();
 
+/// Fills the apdu buffer with packed public keys (and optionally address hashes) for consecutive account indexes
+uint16_t app_fill_public_keys(uint32_t startIndex, uint8_t count, bool includeAddressHash);
+
 void app_reply_address();
 
 void app_reply_error();
@@ -25,12 +25,23 @@
 #include "actions.h"
 #include "tx.h"
 #include "lib/crypto.h"
+#include "lib/parser_txdef.h"
+#include "lib/pubkey_cache.h"
+#include "lib/stats.h"
+#include "lib/trace.h"
 #include "coin.h"
 #include "zxmacros.h"
 
+#ifdef MAINNET_ENABLED
+#define APP_IS_MAINNET bool_true
+#else
+#define APP_IS_MAINNET bool_false
+#endif
+
 unsigned char G_io_seproxyhal_spi_buffer[IO_SEPROXYHAL_BUFFER_SIZE_B];
 
 unsigned char io_event(unsigned char channel) {
+    UNUSED(channel);
     switch (G_io_seproxyhal_spi_buffer[0]) {
         case SEPROXYHAL_TAG_FINGER_EVENT: //
             UX_FINGER_EVENT(G_io_seproxyhal_spi_buffer);
@@ -41,11 +52,23 @@ unsigned char io_event(unsigned char channel) {
             break;
 
         case SEPROXYHAL_TAG_DISPLAY_PROCESSED_EVENT:
-            if (!UX_DISPLAYED())
+            if (!UX_DISPLAYED()) {
                 UX_DISPLAYED_EVENT();
+            }
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT: { //
+            STATS_INC(ticks);
+
+            if (os_global_pin_is_validated() != BOLOS_UX_OK) {
+                // Device is locked: cached keys must not outlive the session
+                pubkey_cache_clear();
+                crypto_accountNodeClear();
+            }
+
+            app_sign_prepare_step();
+            view_review_prefetch();
+
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
                     if (UX_ALLOWED) {
                         UX_REDISPLAY();
@@ -90,176 +113,374 @@ unsigned short io_exchange_al(unsigned char channel, unsigned short tx_len) {
     return 0;
 }
 
-void extractHDPath(uint32_t rx, uint32_t offset) {
-    if ((rx - offset) < sizeof(uint32_t) * HDPATH_LEN_DEFAULT) {
-        THROW(APDU_CODE_WRONG_LENGTH);
-    }
+// Handlers return the status word appended to their reply, or APDU_NO_REPLY when the reply is
+// sent later from the view (user confirmation). Only OS calls still throw: they are caught in app_main
+#define APDU_NO_REPLY 0
 
-    MEMCPY(hdPath, G_io_apdu_buffer + offset, sizeof(uint32_t) * HDPATH_LEN_DEFAULT);
+typedef uint16_t (*apdu_handler_t)(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx);
 
+uint16_t validateHDPath(const uint32_t path[HDPATH_LEN_DEFAULT]) {
     // Check values
-    if (hdPath[0] != HDPATH_0_DEFAULT ||
-        hdPath[1] != HDPATH_1_DEFAULT) {
-        THROW(APDU_CODE_DATA_INVALID);
+    if (path[0] != HDPATH_0_DEFAULT ||
+        path[1] != HDPATH_1_DEFAULT) {
+        return APDU_CODE_DATA_INVALID;
     }
 
     // Check all items are hardened
     for (int i = 0; i < HDPATH_LEN_DEFAULT; i++) {
-        if ( (hdPath[i] & 0x80000000) == 0) {
-            THROW(APDU_CODE_DATA_INVALID);
+        if ( (path[i] & 0x80000000) == 0) {
+            return APDU_CODE_DATA_INVALID;
         }
     }
+
+    return APDU_CODE_OK;
 }
 
-bool process_chunk(volatile uint32_t *tx, uint32_t rx) {
+uint16_t extractHDPath(uint32_t rx, uint32_t offset) {
+    // A single path invalidates any previous list of signers
+    hdPathListCount = 0;
+
+    if ((rx - offset) < sizeof(uint32_t) * HDPATH_LEN_DEFAULT) {
+        return APDU_CODE_WRONG_LENGTH;
+    }
+
+    MEMCPY(hdPath, G_io_apdu_buffer + offset, sizeof(uint32_t) * HDPATH_LEN_DEFAULT);
+    return validateHDPath(hdPath);
+}
+
+uint16_t extractHDPathList(uint32_t rx, uint32_t offset) {
+    hdPathListCount = 0;
+
+    const uint32_t pathSize = sizeof(uint32_t) * HDPATH_LEN_DEFAULT;
+    const uint32_t dataLen = rx - offset;
+    if (dataLen == 0 || dataLen % pathSize != 0 || dataLen / pathSize > HDPATH_LIST_MAX) {
+        return APDU_CODE_WRONG_LENGTH;
+    }
+
+    const uint8_t count = dataLen / pathSize;
+    for (uint8_t i = 0; i < count; i++) {
+        MEMCPY(hdPathList[i], G_io_apdu_buffer + offset + i * pathSize, pathSize);
+        const uint16_t sw = validateHDPath(hdPathList[i]);
+        if (sw != APDU_CODE_OK) {
+            return sw;
+        }
+    }
+
+    // The first path is kept as the default one
+    MEMCPY(hdPath, hdPathList[0], pathSize);
+    hdPathListCount = count;
+    return APDU_CODE_OK;
+}
+
+/// Stores a chunk of the transaction
+/// \return APDU_CODE_OK, with isLast set when the transaction is complete
+uint16_t process_chunk(uint32_t rx, bool *isLast) {
+    TRACE_SCOPE("process_chunk");
     const uint8_t payloadType = G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE];
+    *isLast = false;
 
     if (G_io_apdu_buffer[OFFSET_P2] != 0) {
-        THROW(APDU_CODE_INVALIDP1P2);
+        return APDU_CODE_INVALIDP1P2;
     }
 
     if (rx < OFFSET_DATA) {
-        THROW(APDU_CODE_WRONG_LENGTH);
+        return APDU_CODE_WRONG_LENGTH;
     }
 
-    uint32_t added;
     switch (payloadType) {
-        case 0:
+        case PAYLOAD_TYPE_INIT:
             tx_initialize();
             tx_reset();
-            extractHDPath(rx, OFFSET_DATA);
-            return false;
-        case 1:
-            added = tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
-            if (added != rx - OFFSET_DATA) {
-                THROW(APDU_CODE_OUTPUT_BUFFER_TOO_SMALL);
+            if (G_io_apdu_buffer[OFFSET_INS] == INS_PARSE_ONLY) {
+                // Nothing is signed, the payload is ignored
+                hdPathListCount = 0;
+                return APDU_CODE_OK;
+            }
+            if (G_io_apdu_buffer[OFFSET_INS] == INS_SIGN_MULTIPATH) {
+                return extractHDPathList(rx, OFFSET_DATA);
             }
-            return false;
-        case 2:
-            added = tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA);
-            if (added != rx - OFFSET_DATA) {
-                THROW(APDU_CODE_OUTPUT_BUFFER_TOO_SMALL);
+            return extractHDPath(rx, OFFSET_DATA);
+        case PAYLOAD_TYPE_ADD:
+        case PAYLOAD_TYPE_LAST:
+            if (tx_append(&(G_io_apdu_buffer[OFFSET_DATA]), rx - OFFSET_DATA) != rx - OFFSET_DATA) {
+                return APDU_CODE_OUTPUT_BUFFER_TOO_SMALL;
             }
-            return true;
+            *isLast = payloadType == PAYLOAD_TYPE_LAST;
+            return APDU_CODE_OK;
+        default:
+            return APDU_CODE_INVALIDP1P2;
     }
+}
 
-    THROW(APDU_CODE_INVALIDP1P2);
+/// Replies with the parser error message when the transaction is not valid
+__Z_INLINE uint16_t reply_parse_error(volatile uint32_t *tx, const char *error_msg) {
+    const int error_msg_length = strlen(error_msg);
+    MEMCPY(G_io_apdu_buffer, error_msg, error_msg_length);
+    *tx += (error_msg_length);
+    return APDU_CODE_DATA_INVALID;
 }
 
-void handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
-    uint16_t sw = 0;
+uint16_t handleGetVersion(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
+    UNUSED(rx);
+#ifdef MAINNET_ENABLED
+    G_io_apdu_buffer[0] = 0;
+#else
+    G_io_apdu_buffer[0] = 0xFF;
+#endif
+    G_io_apdu_buffer[1] = LEDGER_MAJOR_VERSION;
+    G_io_apdu_buffer[2] = LEDGER_MINOR_VERSION;
+    G_io_apdu_buffer[3] = LEDGER_PATCH_VERSION;
+    G_io_apdu_buffer[4] = !IS_UX_ALLOWED;
+
+    G_io_apdu_buffer[5] = (TARGET_ID >> 24) & 0xFF;
+    G_io_apdu_buffer[6] = (TARGET_ID >> 16) & 0xFF;
+    G_io_apdu_buffer[7] = (TARGET_ID >> 8) & 0xFF;
+    G_io_apdu_buffer[8] = (TARGET_ID >> 0) & 0xFF;
+
+    *tx += 9;
+    return APDU_CODE_OK;
+}
 
-    BEGIN_TRY
-    {
-        TRY
-        {
-            if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
-                THROW(APDU_CODE_CLA_NOT_SUPPORTED);
-            }
+uint16_t handleGetAddr(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    const uint16_t sw = extractHDPath(rx, OFFSET_DATA);
+    if (sw != APDU_CODE_OK) {
+        return sw;
+    }
 
-            if (rx < APDU_MIN_LENGTH) {
-                THROW(APDU_CODE_WRONG_LENGTH);
-            }
+    uint8_t requireConfirmation = G_io_apdu_buffer[OFFSET_P1];
 
-            switch (G_io_apdu_buffer[OFFSET_INS]) {
-                case INS_GET_VERSION: {
 #ifdef MAINNET_ENABLED
-                    G_io_apdu_buffer[0] = 0;
+    app_set_hrp(APP_MAINNET_HRP);
 #else
-                    G_io_apdu_buffer[0] = 0xFF;
+    app_set_hrp(APP_TESTNET_HRP);
 #endif
-                    G_io_apdu_buffer[1] = LEDGER_MAJOR_VERSION;
-                    G_io_apdu_buffer[2] = LEDGER_MINOR_VERSION;
-                    G_io_apdu_buffer[3] = LEDGER_PATCH_VERSION;
-                    G_io_apdu_buffer[4] = !IS_UX_ALLOWED;
-
-                    G_io_apdu_buffer[5] = (TARGET_ID >> 24) & 0xFF;
-                    G_io_apdu_buffer[6] = (TARGET_ID >> 16) & 0xFF;
-                    G_io_apdu_buffer[7] = (TARGET_ID >> 8) & 0xFF;
-                    G_io_apdu_buffer[8] = (TARGET_ID >> 0) & 0xFF;
-
-                    *tx += 9;
-                    THROW(APDU_CODE_OK);
-                    break;
-                }
 
-                case INS_GET_ADDR_ED25519: {
-                    extractHDPath(rx, OFFSET_DATA);
+    if (requireConfirmation) {
+        app_fill_address();
+        view_address_show();
+        *flags |= IO_ASYNCH_REPLY;
+        return APDU_NO_REPLY;
+    }
 
-                    uint8_t requireConfirmation = G_io_apdu_buffer[OFFSET_P1];
+    *tx = app_fill_address();
+    return APDU_CODE_OK;
+}
 
-#ifdef MAINNET_ENABLED
-                    app_set_hrp(APP_MAINNET_HRP);
-#else
-                    app_set_hrp(APP_TESTNET_HRP);
+uint16_t handleGetPubkeys(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
+    // Non-interactive: public keys can be exported without user confirmation
+    if (rx - OFFSET_DATA != PUBKEYS_REQUEST_LEN) {
+        return APDU_CODE_WRONG_LENGTH;
+    }
+
+    const uint8_t includeAddressHash = G_io_apdu_buffer[OFFSET_P1];
+    if (includeAddressHash > 1 || G_io_apdu_buffer[OFFSET_P2] != 0) {
+        return APDU_CODE_INVALIDP1P2;
+    }
+
+    const uint8_t *data = G_io_apdu_buffer + OFFSET_DATA;
+    const uint32_t startIndex = (uint32_t) data[0] |
+                                ((uint32_t) data[1] << 8u) |
+                                ((uint32_t) data[2] << 16u) |
+                                ((uint32_t) data[3] << 24u);
+    const uint8_t count = data[4];
+
+    const uint8_t countMax = includeAddressHash ? PUBKEYS_WITH_HASH_COUNT_MAX : PUBKEYS_COUNT_MAX;
+    if (count == 0 || count > countMax) {
+        return APDU_CODE_DATA_INVALID;
+    }
+
+    // Indexes are always hardened, so they must stay below 2^31
+    if (startIndex >= 0x80000000u || count > 0x80000000u - startIndex) {
+        return APDU_CODE_DATA_INVALID;
+    }
+
+    *tx = app_fill_public_keys(startIndex, count, includeAddressHash);
+    return APDU_CODE_OK;
+}
+
+// INS_SIGN_ED25519 and INS_SIGN_MULTIPATH
+uint16_t handleSign(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    bool isLast;
+    const uint16_t sw = process_chunk(rx, &isLast);
+    if (sw != APDU_CODE_OK || !isLast) {
+        return sw;
+    }
+
+    const char *error_msg = tx_parse(APP_IS_MAINNET);
+    if (error_msg != NULL) {
+        return reply_parse_error(tx, error_msg);
+    }
+
+    app_sign_prepare_start();
+    view_sign_show();
+    *flags |= IO_ASYNCH_REPLY;
+    return APDU_NO_REPLY;
+}
+
+uint16_t handleSignBatch(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    if (G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] == PAYLOAD_TYPE_NEXT_SIGNATURE) {
+        // Signatures after the first one are retrieved one by one
+        *tx = app_sign_batch_next();
+        return *tx == 0 ? APDU_CODE_COMMAND_NOT_ALLOWED : APDU_CODE_OK;
+    }
+
+    bool isLast;
+    const uint16_t sw = process_chunk(rx, &isLast);
+    if (sw != APDU_CODE_OK || !isLast) {
+        return sw;
+    }
+
+    const char *error_msg = tx_batch_parse(APP_IS_MAINNET);
+    if (error_msg != NULL) {
+        return reply_parse_error(tx, error_msg);
+    }
+
+    app_sign_prepare_start();
+    view_sign_show();
+    *flags |= IO_ASYNCH_REPLY;
+    return APDU_NO_REPLY;
+}
+
+// Parses the transaction without showing it and returns its items as a TLV stream
+uint16_t handleParseOnly(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
+    uint16_t replyLen;
+    if (G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] == PAYLOAD_TYPE_NEXT_ITEMS) {
+        const uint16_t sw = app_parse_only_next(&replyLen);
+        *tx = replyLen;
+        return sw;
+    }
+
+    if (G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] == PAYLOAD_TYPE_INIT) {
+        // The transaction buffer is replaced: a review still on screen must not be able to sign it
+        view_idle_show(0);
+    }
+
+    bool isLast;
+    uint16_t sw = process_chunk(rx, &isLast);
+    if (sw != APDU_CODE_OK || !isLast) {
+        return sw;
+    }
+
+    const char *error_msg = tx_parse(APP_IS_MAINNET);
+    if (error_msg != NULL) {
+        return reply_parse_error(tx, error_msg);
+    }
+
+    app_parse_only_start();
+    sw = app_parse_only_next(&replyLen);
+    *tx = replyLen;
+    return sw;
+}
+
+#if defined(APP_STATS)
+uint16_t handleGetStats(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
+    UNUSED(rx);
+    if (G_io_apdu_buffer[OFFSET_P1] != 0 || G_io_apdu_buffer[OFFSET_P2] != 0) {
+        return APDU_CODE_INVALIDP1P2;
+    }
+    *tx = stats_fill(G_io_apdu_buffer, IO_APDU_BUFFER_SIZE - 2);
+    return APDU_CODE_OK;
+}
 #endif
 
-                    if (requireConfirmation) {
-                        app_fill_address();
-                        view_address_show();
-                        *flags |= IO_ASYNCH_REPLY;
-                        break;
-                    }
+uint16_t handleGetCaps(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx);
+
+// Indexed by INS. NULL entries are not supported
+const apdu_handler_t apdu_handlers[] = {
+    [INS_GET_VERSION] = handleGetVersion,
+    [INS_GET_ADDR_ED25519] = handleGetAddr,
+    [INS_SIGN_ED25519] = handleSign,
+    [INS_SIGN_BATCH] = handleSignBatch,
+    [INS_SIGN_MULTIPATH] = handleSign,
+    [INS_GET_PUBKEYS_ED25519] = handleGetPubkeys,
+#if defined(APP_STATS)
+    [INS_GET_STATS] = handleGetStats,
+#endif
+    [INS_GET_CAPS] = handleGetCaps,
+    [INS_PARSE_ONLY] = handleParseOnly,
+};
 
-                    *tx = app_fill_address();
-                    THROW(APDU_CODE_OK);
-                    break;
-                }
+#define APDU_HANDLERS_COUNT (sizeof(apdu_handlers) / sizeof(apdu_handlers[0]))
 
-                case INS_SIGN_ED25519: {
-                    if (!process_chunk(tx, rx))
-                        THROW(APDU_CODE_OK);
+uint16_t handleGetCaps(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
+    UNUSED(rx);
+    if (G_io_apdu_buffer[OFFSET_P1] != 0 || G_io_apdu_buffer[OFFSET_P2] != 0) {
+        return APDU_CODE_INVALIDP1P2;
+    }
 
+    app_caps_t caps;
+    MEMZERO(&caps, sizeof(caps));
+    caps.version = CAPS_VERSION;
+    for (uint8_t ins = 0; ins < APDU_HANDLERS_COUNT && ins < 32; ins++) {
+        if (apdu_handlers[ins] != NULL) {
+            caps.commands |= 1u << ins;
+        }
+    }
+
+    caps.features = CAPS_FEATURE_PUBKEYS_HASH | CAPS_FEATURE_BATCH_NEXT;
 #ifdef MAINNET_ENABLED
-                    const bool_t isMainnet = bool_true;
-#else
-                    const bool_t isMainnet = bool_false;
+    caps.features |= CAPS_FEATURE_MAINNET;
 #endif
-                    const char *error_msg = tx_parse(isMainnet);
+    if (tx_settings_get_review_mode() == tx_review_compact) {
+        caps.features |= CAPS_FEATURE_REVIEW_COMPACT;
+    }
 
-                    if (error_msg != NULL) {
-                        int error_msg_length = strlen(error_msg);
-                        MEMCPY(G_io_apdu_buffer, error_msg, error_msg_length);
-                        *tx += (error_msg_length);
-                        THROW(APDU_CODE_DATA_INVALID);
-                    }
+    caps.chunkMax = IO_APDU_BUFFER_SIZE - OFFSET_DATA;
+    caps.ramBuffer = RAM_BUFFER_SIZE;
+    caps.flashBuffer = FLASH_BUFFER_SIZE;
+    caps.batchMax = TX_BATCH_COUNT_MAX;
+    caps.pathsMax = HDPATH_LIST_MAX;
+    caps.pubkeysMax = PUBKEYS_COUNT_MAX;
+    caps.pubkeysHashMax = PUBKEYS_WITH_HASH_COUNT_MAX;
+    caps.memoMax = TX_MEMOLEN_MAX;
+    caps.participantsMax = PBIDX_UPDATEMSG_PARTICIPANTS_MAX;
+    caps.multisigMax = PBIDX_MULTISIG_COUNT_MAX;
+    caps.batchSendMax = PBIDX_BATCHMSG_SENDMSG_MAX;
+    caps.batchTickersMax = PBIDX_BATCHMSG_TICKERS_MAX;
+
+    MEMCPY(G_io_apdu_buffer, &caps, sizeof(caps));
+    *tx = sizeof(caps);
+    return APDU_CODE_OK;
+}
 
-                    view_sign_show();
-                    *flags |= IO_ASYNCH_REPLY;
-                    break;
-                }
+uint16_t handleApdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    if (G_io_apdu_buffer[OFFSET_CLA] != CLA) {
+        return APDU_CODE_CLA_NOT_SUPPORTED;
+    }
 
-                default:
-                    THROW(APDU_CODE_INS_NOT_SUPPORTED);
-            }
-        }
-        CATCH(EXCEPTION_IO_RESET)
-        {
-            THROW(EXCEPTION_IO_RESET);
-        }
-        CATCH_OTHER(e)
-        {
-            switch (e & 0xF000) {
-                case 0x6000:
-                case APDU_CODE_OK:
-                    sw = e;
-                    break;
-                default:
-                    sw = 0x6800 | (e & 0x7FF);
-                    break;
-            }
-            G_io_apdu_buffer[*tx] = sw >> 8;
-            G_io_apdu_buffer[*tx + 1] = sw;
-            *tx += 2;
-        }
-        FINALLY
-        {
-        }
+    if (rx < APDU_MIN_LENGTH) {
+        return APDU_CODE_WRONG_LENGTH;
+    }
+
+    const uint8_t ins = G_io_apdu_buffer[OFFSET_INS];
+    STATS_APDU(ins);
+
+    if (ins != INS_SIGN_BATCH ||
+        G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] != PAYLOAD_TYPE_NEXT_SIGNATURE) {
+        // Any other command aborts a pending signature or a batch that is still being signed
+        app_sign_clear();
+    }
+    if (ins != INS_PARSE_ONLY ||
+        G_io_apdu_buffer[OFFSET_PAYLOAD_TYPE] != PAYLOAD_TYPE_NEXT_ITEMS) {
+        // Any other command ends the item stream
+        app_parse_only_clear();
     }
-    END_TRY;
+
+    if (ins >= APDU_HANDLERS_COUNT || apdu_handlers[ins] == NULL) {
+        return APDU_CODE_INS_NOT_SUPPORTED;
+    }
+
+    const apdu_handler_t handler = (apdu_handler_t) PIC(apdu_handlers[ins]);
+    return handler(flags, tx, rx);
 }
 
-void handle_generic_apdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+bool handle_generic_apdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32_t rx) {
+    UNUSED(flags);
     if (rx > 4 && os_memcmp(G_io_apdu_buffer, "\xE0\x01\x00\x00", 4) == 0) {
         // Respond to get device info command
         uint8_t *p = G_io_apdu_buffer;
@@ -280,8 +501,9 @@ void handle_generic_apdu(volatile uint32_t *flags, volatile uint32_t *tx, uint32
         p = p + 1 + *p;
 
         *tx = p - G_io_apdu_buffer;
-        THROW(APDU_CODE_OK);
+        return true;
     }
+    return false;
 }
 
 void app_init() {
@@ -309,12 +531,18 @@ void app_main() {
                 rx = io_exchange(CHANNEL_APDU | flags, rx);
                 flags = 0;
 
-                if (rx == 0)
-                    THROW(APDU_CODE_EMPTY_BUFFER);
-
-                handle_generic_apdu(&flags, &tx, rx);
-
-                handleApdu(&flags, &tx, rx);
+                if (rx == 0) {
+                    sw = APDU_CODE_EMPTY_BUFFER;
+                } else if (handle_generic_apdu(&flags, &tx, rx)) {
+                    sw = APDU_CODE_OK;
+                } else {
+                    sw = handleApdu(&flags, &tx, rx);
+                }
+                if (sw != APDU_NO_REPLY) {
+                    G_io_apdu_buffer[tx] = sw >> 8;
+                    G_io_apdu_buffer[tx + 1] = sw;
+                    tx += 2;
+                }
             }
             CATCH_OTHER(e);
             {
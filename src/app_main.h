@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "apdu_codes.h"
 
 #define CLA                             0x22
@@ -32,9 +33,60 @@
 
 #define OFFSET_PAYLOAD_TYPE             OFFSET_P1
 
+#define PAYLOAD_TYPE_INIT               0
+#define PAYLOAD_TYPE_ADD                1
+#define PAYLOAD_TYPE_LAST               2
+#define PAYLOAD_TYPE_NEXT_SIGNATURE     3
+#define PAYLOAD_TYPE_NEXT_ITEMS         3   // INS_PARSE_ONLY: reads the item stream
+
 #define INS_GET_VERSION                 0
 #define INS_GET_ADDR_ED25519            1
 #define INS_SIGN_ED25519                2
+#define INS_SIGN_BATCH                  3
+#define INS_SIGN_MULTIPATH              4
+#define INS_GET_PUBKEYS_ED25519         5
+#define INS_GET_STATS                   6   // only with APP_STATS
+#define INS_GET_CAPS                    7
+#define INS_PARSE_ONLY                  8
+
+// INS_PARSE_ONLY item stream: tag (1) | length (2) | payload
+#define PARSE_TAG_END                   0x00    // no payload
+#define PARSE_TAG_HEADER                0x01    // number of items (2)
+#define PARSE_TAG_ITEM                  0x02    // item (2) | page (1) | page count (1) | key length (1) | key | value
+#define PARSE_RECORD_HEAD_LEN           3
+#define PARSE_ITEM_HEAD_LEN             (PARSE_RECORD_HEAD_LEN + 5)
+
+// INS_GET_PUBKEYS_ED25519: start index (4 bytes LE) + count (1 byte)
+#define PUBKEYS_REQUEST_LEN             5
+#define PUBKEYS_COUNT_MAX               8   // 8 x 32 bytes
+#define PUBKEYS_WITH_HASH_COUNT_MAX     4   // 4 x (32 + 20) bytes
+
+#define CAPS_VERSION                    1
+
+// INS_GET_CAPS feature bits
+#define CAPS_FEATURE_MAINNET            0x0001u // otherwise testnet
+#define CAPS_FEATURE_PUBKEYS_HASH       0x0002u // INS_GET_PUBKEYS_ED25519 with P1 = 1
+#define CAPS_FEATURE_BATCH_NEXT         0x0004u // INS_SIGN_BATCH signatures read with PAYLOAD_TYPE_NEXT_SIGNATURE
+#define CAPS_FEATURE_REVIEW_COMPACT     0x0008u // compact review mode selected in the settings menu
+
+/// Response layout of INS_GET_CAPS, little endian
+typedef struct {
+    uint8_t version;
+    uint32_t commands;          // bit n set when INS n is supported
+    uint16_t features;          // CAPS_FEATURE_*
+    uint16_t chunkMax;          // largest payload of a single APDU
+    uint16_t ramBuffer;         // transaction buffer in RAM
+    uint16_t flashBuffer;       // transaction buffer in flash, used when RAM is not enough
+    uint8_t batchMax;           // transactions in INS_SIGN_BATCH
+    uint8_t pathsMax;           // paths in INS_SIGN_MULTIPATH
+    uint8_t pubkeysMax;         // keys in INS_GET_PUBKEYS_ED25519 (P1 = 0)
+    uint8_t pubkeysHashMax;     // keys in INS_GET_PUBKEYS_ED25519 (P1 = 1)
+    uint16_t memoMax;
+    uint8_t participantsMax;    // UpdateMultisigMsg participants
+    uint8_t multisigMax;        // multisig contracts per transaction
+    uint8_t batchSendMax;       // SendMsg in a BatchMsg
+    uint8_t batchTickersMax;    // tickers in a BatchMsg
+} __attribute__((packed)) app_caps_t;
 
 void app_init();
 
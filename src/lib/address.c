@@ -0,0 +1,88 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "address.h"
+#include "coin.h"
+#include "zxmacros.h"
+#include <bech32.h>
+#include <string.h>
+
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX)
+#include "cx.h"
+
+// No precomputed prefix state here: cx_hash_sha256 cannot start from working variables,
+// and carrying a software SHA-256 in flash to skip 3 of 64 rounds is not worth it
+void address_hash(const uint8_t pubKey[ADDRESS_PK_LEN], uint8_t addressHash[ADDRESS_HASH_LEN]) {
+    // One contiguous message: a cx_sha256_t context would take more than twice its stack
+    uint8_t message[ADDRESS_MSG_LEN];
+    uint8_t hash[CX_SHA256_SIZE];
+
+    MEMCPY(message, IOV_PK_PREFIX, IOV_PK_PREFIX_LEN);
+    MEMCPY(message + IOV_PK_PREFIX_LEN, pubKey, ADDRESS_PK_LEN);
+    cx_hash_sha256(message, ADDRESS_MSG_LEN, hash, CX_SHA256_SIZE);
+
+    MEMCPY(addressHash, hash, ADDRESS_HASH_LEN);
+}
+
+#else
+#include "sha256.h"
+
+// The hashed message (45 bytes) fits in a single padded block whose first 3 words
+// hold only prefix bytes. Rounds 0..2 are therefore the same for every key and are
+// skipped by starting from these working variables
+const uint32_t address_prefix_working[8] = {
+    0xc7834db8, 0x6f1b1f19, 0x6f71efc0, 0x6a09e667, 0x445f325a, 0x9dc82204, 0x0c314a15, 0x510e527f,
+};
+
+// Padded block with the prefix in place. The key goes at offset IOV_PK_PREFIX_LEN
+const uint8_t address_block_template[SHA256_BLOCK_LEN] = {
+    's', 'i', 'g', 's', '/', 'e', 'd', '2', '5', '5', '1', '9', '/',
+    [ADDRESS_MSG_LEN] = 0x80,
+    [SHA256_BLOCK_LEN - 2] = (ADDRESS_MSG_LEN * 8) >> 8,
+    [SHA256_BLOCK_LEN - 1] = (ADDRESS_MSG_LEN * 8) & 0xFF,
+};
+
+void address_hash(const uint8_t pubKey[ADDRESS_PK_LEN], uint8_t addressHash[ADDRESS_HASH_LEN]) {
+    uint8_t block[SHA256_BLOCK_LEN];
+    uint32_t state[8];
+
+    MEMCPY(block, address_block_template, SHA256_BLOCK_LEN);
+    MEMCPY(block + IOV_PK_PREFIX_LEN, pubKey, ADDRESS_PK_LEN);
+    MEMCPY(state, sha256_iv, sizeof(state));
+
+    sha256_compress_from(state, address_prefix_working, block, ADDRESS_PREFIX_ROUNDS);
+
+    for (uint8_t i = 0; i < ADDRESS_HASH_LEN / 4; i++) {
+        addressHash[4 * i] = (uint8_t) (state[i] >> 24u);
+        addressHash[4 * i + 1] = (uint8_t) (state[i] >> 16u);
+        addressHash[4 * i + 2] = (uint8_t) (state[i] >> 8u);
+        addressHash[4 * i + 3] = (uint8_t) state[i];
+    }
+}
+
+#endif
+
+uint16_t address_fromPubKey(char *out, uint16_t outLen, const char *hrp, const uint8_t pubKey[ADDRESS_PK_LEN]) {
+    if (outLen < ADDRESS_STR_LEN(strlen(hrp))) {
+        return 0;
+    }
+
+    uint8_t addressHash[ADDRESS_HASH_LEN];
+    address_hash(pubKey, addressHash);
+
+    bech32EncodeFromBytes(out, hrp, addressHash, ADDRESS_HASH_LEN);
+    return strlen(out);
+}
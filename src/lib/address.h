@@ -0,0 +1,52 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "coin.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADDRESS_PK_LEN      32
+#define ADDRESS_HASH_LEN    20
+
+// hrp + '1' + 32 data chars + 6 checksum chars + terminator
+#define ADDRESS_STR_LEN(HRP_LEN)    ((HRP_LEN) + 1 + 32 + 6 + 1)
+
+// Hashed message: prefix || pubKey
+#define ADDRESS_MSG_LEN         (IOV_PK_PREFIX_LEN + ADDRESS_PK_LEN)
+
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+#define ADDRESS_PREFIX_ROUNDS   3
+
+// SHA-256 working variables after the rounds that only depend on the prefix,
+// and the padded block the public key is copied into. Shared with the bulk kernels
+extern const uint32_t address_prefix_working[8];
+extern const uint8_t address_block_template[64];
+#endif
+
+/// Computes the address hash of an ed25519 public key: first 20 bytes of SHA-256("sigs/ed25519/" || pubKey)
+void address_hash(const uint8_t pubKey[ADDRESS_PK_LEN], uint8_t addressHash[ADDRESS_HASH_LEN]);
+
+/// Writes the bech32 address of an ed25519 public key. Returns the address length or 0 if out is too small
+uint16_t address_fromPubKey(char *out, uint16_t outLen, const char *hrp, const uint8_t pubKey[ADDRESS_PK_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
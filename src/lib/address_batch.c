@@ -0,0 +1,185 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+
+#include "address_batch.h"
+#include "sha256.h"
+#include "zxmacros.h"
+#include <bech32.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ADDRESS_BATCH_X86
+
+#define VROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+#define KERNEL_NAME     address_kernel_sse2_run
+#define KERNEL_LANES    4
+#define KERNEL_TARGET   __attribute__((target("sse2")))
+#include "address_batch_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_LANES
+#undef KERNEL_TARGET
+
+#define KERNEL_NAME     address_kernel_avx2_run
+#define KERNEL_LANES    8
+#define KERNEL_TARGET   __attribute__((target("avx2")))
+#include "address_batch_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_LANES
+#undef KERNEL_TARGET
+
+#define KERNEL_NAME     address_kernel_avx512_run
+#define KERNEL_LANES    16
+#define KERNEL_TARGET   __attribute__((target("avx512f")))
+#include "address_batch_kernel.h"
+#undef KERNEL_NAME
+#undef KERNEL_LANES
+#undef KERNEL_TARGET
+#endif
+
+typedef void (*address_kernel_fn)(const uint8_t *pubKeys, uint8_t *hashes);
+
+static void address_kernel_scalar_run(const uint8_t *pubKeys, uint8_t *hashes) {
+    address_hash(pubKeys, hashes);
+}
+
+typedef struct {
+    const char *name;
+    address_kernel_fn run;
+    uint8_t lanes;
+} address_kernel_t;
+
+static const address_kernel_t kernels[] = {
+    [address_kernel_auto] = {"auto", NULL, 0},
+    [address_kernel_scalar] = {"scalar", address_kernel_scalar_run, 1},
+#ifdef ADDRESS_BATCH_X86
+    [address_kernel_sse2] = {"sse2", address_kernel_sse2_run, 4},
+    [address_kernel_avx2] = {"avx2", address_kernel_avx2_run, 8},
+    [address_kernel_avx512] = {"avx512", address_kernel_avx512_run, 16},
+#else
+    [address_kernel_sse2] = {"sse2", NULL, 4},
+    [address_kernel_avx2] = {"avx2", NULL, 8},
+    [address_kernel_avx512] = {"avx512", NULL, 16},
+#endif
+};
+
+#define KERNEL_COUNT (sizeof(kernels) / sizeof(kernels[0]))
+
+bool address_kernel_supported(address_kernel_e kernel) {
+    switch (kernel) {
+        case address_kernel_auto:
+        case address_kernel_scalar:
+            return true;
+#ifdef ADDRESS_BATCH_X86
+        case address_kernel_sse2:
+            return __builtin_cpu_supports("sse2");
+        case address_kernel_avx2:
+            return __builtin_cpu_supports("avx2");
+        case address_kernel_avx512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+address_kernel_e address_kernel_best() {
+    if (address_kernel_supported(address_kernel_avx512)) {
+        return address_kernel_avx512;
+    }
+    if (address_kernel_supported(address_kernel_avx2)) {
+        return address_kernel_avx2;
+    }
+    if (address_kernel_supported(address_kernel_sse2)) {
+        return address_kernel_sse2;
+    }
+    return address_kernel_scalar;
+}
+
+const char *address_kernel_name(address_kernel_e kernel) {
+    if ((size_t) kernel >= KERNEL_COUNT) {
+        return "unknown";
+    }
+    return kernels[kernel].name;
+}
+
+static const address_kernel_t *address_kernel_select(address_kernel_e kernel) {
+    if (kernel == address_kernel_auto) {
+        kernel = address_kernel_best();
+    }
+    if ((size_t) kernel >= KERNEL_COUNT || !address_kernel_supported(kernel)) {
+        return NULL;
+    }
+    return &kernels[kernel];
+}
+
+// Hashes up to one pass worth of keys. The tail of a batch is padded into a scratch buffer
+static void address_kernel_pass(const address_kernel_t *k,
+                                const uint8_t *pubKeys, size_t count,
+                                uint8_t *hashes) {
+    if (count == k->lanes) {
+        k->run(pubKeys, hashes);
+        return;
+    }
+
+    uint8_t keysTail[ADDRESS_KERNEL_LANES_MAX * ADDRESS_PK_LEN];
+    uint8_t hashesTail[ADDRESS_KERNEL_LANES_MAX * ADDRESS_HASH_LEN];
+    MEMZERO(keysTail, sizeof(keysTail));
+    MEMCPY(keysTail, pubKeys, count * ADDRESS_PK_LEN);
+    k->run(keysTail, hashesTail);
+    MEMCPY(hashes, hashesTail, count * ADDRESS_HASH_LEN);
+}
+
+bool address_hash_batch(address_kernel_e kernel,
+                        const uint8_t *pubKeys, size_t count,
+                        uint8_t *hashes) {
+    const address_kernel_t *k = address_kernel_select(kernel);
+    if (k == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; i += k->lanes) {
+        const size_t n = (count - i < k->lanes) ? count - i : k->lanes;
+        address_kernel_pass(k, pubKeys + i * ADDRESS_PK_LEN, n, hashes + i * ADDRESS_HASH_LEN);
+    }
+    return true;
+}
+
+bool address_fromPubKey_batch(address_kernel_e kernel,
+                              char *out, size_t stride,
+                              const char *hrp,
+                              const uint8_t *pubKeys, size_t count) {
+    const address_kernel_t *k = address_kernel_select(kernel);
+    if (k == NULL || stride < ADDRESS_STR_LEN(strlen(hrp))) {
+        return false;
+    }
+
+    uint8_t hashes[ADDRESS_KERNEL_LANES_MAX * ADDRESS_HASH_LEN];
+
+    for (size_t i = 0; i < count; i += k->lanes) {
+        const size_t n = (count - i < k->lanes) ? count - i : k->lanes;
+        address_kernel_pass(k, pubKeys + i * ADDRESS_PK_LEN, n, hashes);
+
+        for (size_t j = 0; j < n; j++) {
+            bech32EncodeFromBytes(out + (i + j) * stride, hrp, hashes + j * ADDRESS_HASH_LEN, ADDRESS_HASH_LEN);
+        }
+    }
+    return true;
+}
+
+#endif
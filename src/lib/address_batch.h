@@ -0,0 +1,63 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Bulk public key to address derivation. Host only
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "address.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    address_kernel_auto = 0,        // best kernel supported by the CPU
+    address_kernel_scalar,
+    address_kernel_sse2,            // 4 keys per pass
+    address_kernel_avx2,            // 8 keys per pass
+    address_kernel_avx512,          // 16 keys per pass
+} address_kernel_e;
+
+#define ADDRESS_KERNEL_LANES_MAX    16
+
+/// Returns true if the kernel can run on this CPU
+bool address_kernel_supported(address_kernel_e kernel);
+
+/// Returns the widest kernel supported by this CPU
+address_kernel_e address_kernel_best();
+
+const char *address_kernel_name(address_kernel_e kernel);
+
+/// Hashes count packed 32-byte public keys into count packed 20-byte address hashes.
+/// Returns false if the kernel is not supported
+bool address_hash_batch(address_kernel_e kernel,
+                        const uint8_t *pubKeys, size_t count,
+                        uint8_t *hashes);
+
+/// Encodes count packed 32-byte public keys into bech32 addresses. Address i is written at out + i * stride.
+/// Keys are hashed and encoded in groups, so hashes never leave the cache.
+/// Returns false if the kernel is not supported or stride is too small for hrp
+bool address_fromPubKey_batch(address_kernel_e kernel,
+                              char *out, size_t stride,
+                              const char *hrp,
+                              const uint8_t *pubKeys, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
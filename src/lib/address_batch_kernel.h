@@ -0,0 +1,101 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+// Multi-buffer SHA-256 address kernel. Each vector lane hashes a different public key.
+// Included by address_batch.c once per instruction set, with these defined:
+//   KERNEL_NAME     function name
+//   KERNEL_LANES    keys per pass (vector width / 32 bits)
+//   KERNEL_TARGET   function attribute enabling the instruction set
+
+#define KERNEL_CONCAT_(A, B) A##B
+#define KERNEL_CONCAT(A, B) KERNEL_CONCAT_(A, B)
+#define KERNEL_VEC KERNEL_CONCAT(KERNEL_NAME, _vec)
+
+typedef uint32_t KERNEL_VEC __attribute__((vector_size(4 * KERNEL_LANES)));
+
+KERNEL_TARGET
+static void KERNEL_NAME(const uint8_t *pubKeys, uint8_t *hashes) {
+    KERNEL_VEC w[16];
+
+    // Transpose: w[j] holds message word j of every lane
+    for (uint8_t lane = 0; lane < KERNEL_LANES; lane++) {
+        uint8_t block[SHA256_BLOCK_LEN];
+        MEMCPY(block, address_block_template, SHA256_BLOCK_LEN);
+        MEMCPY(block + IOV_PK_PREFIX_LEN, pubKeys + lane * ADDRESS_PK_LEN, ADDRESS_PK_LEN);
+
+        for (uint8_t j = 0; j < 16; j++) {
+            w[j][lane] = (uint32_t) block[4 * j] << 24u |
+                         (uint32_t) block[4 * j + 1] << 16u |
+                         (uint32_t) block[4 * j + 2] << 8u |
+                         (uint32_t) block[4 * j + 3];
+        }
+    }
+
+    const KERNEL_VEC zero = {0};
+    KERNEL_VEC a = zero + address_prefix_working[0];
+    KERNEL_VEC b = zero + address_prefix_working[1];
+    KERNEL_VEC c = zero + address_prefix_working[2];
+    KERNEL_VEC d = zero + address_prefix_working[3];
+    KERNEL_VEC e = zero + address_prefix_working[4];
+    KERNEL_VEC f = zero + address_prefix_working[5];
+    KERNEL_VEC g = zero + address_prefix_working[6];
+    KERNEL_VEC h = zero + address_prefix_working[7];
+
+    for (uint8_t i = ADDRESS_PREFIX_ROUNDS; i < 64; i++) {
+        if (i >= 16) {
+            const KERNEL_VEC w15 = w[(i - 15) & 15u];
+            const KERNEL_VEC w2 = w[(i - 2) & 15u];
+            const KERNEL_VEC s0 = VROTR(w15, 7) ^ VROTR(w15, 18) ^ (w15 >> 3);
+            const KERNEL_VEC s1 = VROTR(w2, 17) ^ VROTR(w2, 19) ^ (w2 >> 10);
+            w[i & 15u] += s0 + w[(i - 7) & 15u] + s1;
+        }
+
+        const KERNEL_VEC S1 = VROTR(e, 6) ^ VROTR(e, 11) ^ VROTR(e, 25);
+        const KERNEL_VEC ch = (e & f) ^ (~e & g);
+        const KERNEL_VEC t1 = h + S1 + ch + sha256_k[i] + w[i & 15u];
+        const KERNEL_VEC S0 = VROTR(a, 2) ^ VROTR(a, 13) ^ VROTR(a, 22);
+        const KERNEL_VEC maj = (a & b) ^ (a & c) ^ (b & c);
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + S0 + maj;
+    }
+
+    // Only the first 5 state words (20 bytes) are part of the address
+    const KERNEL_VEC out[5] = {
+        a + sha256_iv[0], b + sha256_iv[1], c + sha256_iv[2], d + sha256_iv[3], e + sha256_iv[4],
+    };
+
+    for (uint8_t lane = 0; lane < KERNEL_LANES; lane++) {
+        uint8_t *hash = hashes + lane * ADDRESS_HASH_LEN;
+        for (uint8_t j = 0; j < 5; j++) {
+            const uint32_t v = out[j][lane];
+            hash[4 * j] = (uint8_t) (v >> 24u);
+            hash[4 * j + 1] = (uint8_t) (v >> 16u);
+            hash[4 * j + 2] = (uint8_t) (v >> 8u);
+            hash[4 * j + 3] = (uint8_t) v;
+        }
+    }
+}
+
+#undef KERNEL_VEC
+#undef KERNEL_CONCAT
+#undef KERNEL_CONCAT_
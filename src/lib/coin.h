@@ -38,6 +38,7 @@ extern "C" {
 
 #define IOV_WHOLE_DIGITS   15
 #define IOV_FRAC_DIGITS    9
+#define IOV_FRAC_UNIT      1000000000
 
 #ifdef __cplusplus
 }
@@ -16,19 +16,44 @@
 
 #include "crypto.h"
 #include "coin.h"
-#include <bech32.h>
+#include "address.h"
+#include "trace.h"
 
 uint32_t hdPath[HDPATH_LEN_DEFAULT];
 
+uint32_t hdPathList[HDPATH_LIST_MAX][HDPATH_LEN_DEFAULT];
+uint8_t hdPathListCount = 0;
+
 #if defined(TARGET_NANOS) || defined(TARGET_NANOX)
 #include "cx.h"
+#else
+#include "cx_host.h"
+// Host builds have no exception support; the cx host backend never throws
+#ifndef BEGIN_TRY
+#define BEGIN_TRY   {
+#define TRY
+#define FINALLY
+#define END_TRY     }
+#endif
+#endif
 
-void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen) {
-    cx_ecfp_public_key_t cx_publicKey;
-    cx_ecfp_private_key_t cx_privateKey;
-    uint8_t privateKeyData[32];
+#include "pubkey_cache.h"
+#include "slip10.h"
 
-    if (pubKeyLen < PK_LEN) {
+static const uint32_t hdPathAccountNode[HDPATH_LEN_DEFAULT - 1] = {HDPATH_0_DEFAULT, HDPATH_1_DEFAULT};
+
+// 44'/234' node. All accounts are hardened children of it, so it is derived from the seed
+// once per session and only the last SLIP-10 step is computed for each account
+typedef struct {
+    uint8_t privateKey[SLIP10_KEY_LEN];
+    uint8_t chainCode[SLIP10_CHAINCODE_LEN];
+    bool ready;
+} account_node_t;
+
+account_node_t accountNode;
+
+void crypto_accountNodeInit() {
+    if (accountNode.ready) {
         return;
     }
 
@@ -39,21 +64,83 @@ void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *p
                 os_perso_derive_node_bip32_seed_key(
                         HDW_ED25519_SLIP10,
                         CX_CURVE_Ed25519,
-                        path,
-                        HDPATH_LEN_DEFAULT,
-                        privateKeyData,
-                        NULL,
+                        hdPathAccountNode,
+                        HDPATH_LEN_DEFAULT - 1,
+                        accountNode.privateKey,
+                        accountNode.chainCode,
                         NULL,
                         0)
             );
+            accountNode.ready = true;
+        }
+        FINALLY {
+            if (!accountNode.ready) {
+                crypto_accountNodeClear();
+            }
+        }
+    }
+    END_TRY;
+}
+
+void crypto_accountNodeClear() {
+    MEMZERO(&accountNode, sizeof(accountNode));
+}
+
+void crypto_derivePrivateKey(const uint32_t path[HDPATH_LEN_DEFAULT], cx_ecfp_private_key_t *cx_privateKey) {
+    uint8_t privateKeyData[32];
+
+    BEGIN_TRY
+    {
+        TRY {
+            if (path[0] == hdPathAccountNode[0] && path[1] == hdPathAccountNode[1]) {
+                crypto_accountNodeInit();
+                SAFE_HEARTBEAT(
+                    slip10_deriveHardenedChild(accountNode.privateKey,
+                                               accountNode.chainCode,
+                                               path[2],
+                                               privateKeyData,
+                                               NULL)
+                );
+            } else {
+                SAFE_HEARTBEAT(
+                    os_perso_derive_node_bip32_seed_key(
+                            HDW_ED25519_SLIP10,
+                            CX_CURVE_Ed25519,
+                            path,
+                            HDPATH_LEN_DEFAULT,
+                            privateKeyData,
+                            NULL,
+                            NULL,
+                            0)
+                );
+            }
+
+            SAFE_HEARTBEAT(cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, 32, cx_privateKey));
+        }
+        FINALLY {
+            MEMZERO(privateKeyData, 32);
+        }
+    }
+    END_TRY;
+}
+
+void crypto_derivePublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen) {
+    cx_ecfp_public_key_t cx_publicKey;
+    cx_ecfp_private_key_t cx_privateKey;
+
+    if (pubKeyLen < PK_LEN) {
+        return;
+    }
 
-            SAFE_HEARTBEAT(cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, 32, &cx_privateKey));
+    BEGIN_TRY
+    {
+        TRY {
+            crypto_derivePrivateKey(path, &cx_privateKey);
             SAFE_HEARTBEAT(cx_ecfp_init_public_key(CX_CURVE_Ed25519, NULL, 0, &cx_publicKey));
             SAFE_HEARTBEAT(cx_ecfp_generate_pair(CX_CURVE_Ed25519, &cx_publicKey, &cx_privateKey, 1));
         }
         FINALLY {
             MEMZERO(&cx_privateKey, sizeof(cx_privateKey));
-            MEMZERO(privateKeyData, 32);
         }
     }
     END_TRY;
@@ -69,78 +156,187 @@ void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *p
     }
 }
 
-uint16_t crypto_sign(uint8_t *signature, uint16_t signatureMaxlen, const uint8_t *message, uint16_t messageLen) {
-    uint8_t messageDigest[CX_SHA512_SIZE];
-    cx_hash_sha512(message, messageLen, messageDigest, CX_SHA512_SIZE);
+void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen) {
+    if (pubKeyLen < PK_LEN) {
+        return;
+    }
 
-    cx_ecfp_private_key_t cx_privateKey;
-    uint8_t privateKeyData[32];
+    if (pubkey_cache_get(path, pubKey)) {
+        return;
+    }
+
+    crypto_derivePublicKey(path, pubKey, pubKeyLen);
+    pubkey_cache_put(path, pubKey);
+}
+
+uint16_t crypto_signDigest(const cx_ecfp_private_key_t *cx_privateKey,
+                           uint8_t *signature, uint16_t signatureMaxlen,
+                           const uint8_t *messageDigest) {
     int signatureLength;
     unsigned int info = 0;
 
+    SAFE_HEARTBEAT(
+        signatureLength = cx_eddsa_sign(cx_privateKey,
+                                        CX_LAST,
+                                        CX_SHA512,
+                                        messageDigest,
+                                        CX_SHA512_SIZE,
+                                        NULL,
+                                        0,
+                                        signature,
+                                        signatureMaxlen,
+                                        &info));
+
+    return signatureLength;
+}
+
+uint16_t crypto_signPath(const uint32_t path[HDPATH_LEN_DEFAULT],
+                         uint8_t *signature, uint16_t signatureMaxlen,
+                         const uint8_t *messageDigest) {
+    cx_ecfp_private_key_t cx_privateKey;
+    uint16_t signatureLength = 0;
+
     BEGIN_TRY
     {
         TRY
         {
             // Generate keys
-            SAFE_HEARTBEAT(os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10,
-                                                               CX_CURVE_Ed25519,
-                                                               hdPath,
-                                                               HDPATH_LEN_DEFAULT,
-                                                               privateKeyData,
-                                                               NULL,
-                                                               NULL,
-                                                               0));
-
-            SAFE_HEARTBEAT(cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, 32, &cx_privateKey));
+            crypto_derivePrivateKey(path, &cx_privateKey);
 
             // Sign
-            SAFE_HEARTBEAT(
-                signatureLength = cx_eddsa_sign(&cx_privateKey,
-                                                CX_LAST,
-                                                CX_SHA512,
-                                                messageDigest,
-                                                CX_SHA512_SIZE,
-                                                NULL,
-                                                0,
-                                                signature,
-                                                signatureMaxlen,
-                                                &info));
-
+            signatureLength = crypto_signDigest(&cx_privateKey, signature, signatureMaxlen, messageDigest);
         }
         FINALLY {
             MEMZERO(&cx_privateKey, sizeof(cx_privateKey));
-            MEMZERO(privateKeyData, 32);
         }
     }
     END_TRY;
 
     return signatureLength;
 }
-#else
 
-void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen) {
-    // Empty version for non-Ledger devices
-    MEMSET(pubKey, 0, 32);
+// Signing material prepared in the background while the user reviews a transaction.
+// In batch mode the key is kept here until all transactions have been signed
+typedef struct {
+    union {
+        cx_sha512_t hash;                   // while the digest is computed
+        cx_ecfp_private_key_t privateKey;   // once it is complete
+    };
+    uint8_t digest[CX_SHA512_SIZE];
+    uint16_t digestPos;                     // message bytes hashed so far
+    bool keyReady;
+    bool digestReady;
+} sign_prepared_t;
+
+sign_prepared_t signPrepared;
+
+void crypto_signPrepareAccountNode() {
+    if (hdPath[0] == hdPathAccountNode[0] && hdPath[1] == hdPathAccountNode[1]) {
+        crypto_accountNodeInit();
+    }
+}
+
+void crypto_signPrepareKey() {
+    if (signPrepared.keyReady) {
+        return;
+    }
+    crypto_derivePrivateKey(hdPath, &signPrepared.privateKey);
+    signPrepared.keyReady = true;
 }
 
-uint16_t crypto_sign(uint8_t *signature,
-                     uint16_t signatureMaxlen,
-                     const uint8_t *message,
-                     uint16_t messageLen) {
-    // Empty version for non-Ledger devices
-    return 0;
+bool crypto_signPrepareDigestStep(const uint8_t *message, uint16_t messageLen, uint16_t stepLen) {
+    if (signPrepared.digestReady) {
+        return true;
+    }
+    if (signPrepared.digestPos == 0) {
+        cx_sha512_init(&signPrepared.hash);
+    }
+
+    uint16_t len = messageLen - signPrepared.digestPos;
+    const bool last = len <= stepLen;
+    if (!last) {
+        len = stepLen;
+    }
+
+    cx_hash(&signPrepared.hash.header, last ? CX_LAST : 0,
+            message + signPrepared.digestPos, len,
+            last ? signPrepared.digest : NULL, last ? CX_SHA512_SIZE : 0);
+    signPrepared.digestPos += len;
+    signPrepared.digestReady = last;
+    return last;
 }
 
-#define CX_SHA256_SIZE 32
+void crypto_signPrepareDigest(const uint8_t *message, uint16_t messageLen) {
+    crypto_signPrepareDigestStep(message, messageLen, messageLen);
+}
 
-int cx_hash_sha256(const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len) {
-    // Empty version for non-Ledger devices
-    // Mock with picosha2
-    return 0;
+void crypto_signPrepareClear() {
+    MEMZERO(&signPrepared, sizeof(signPrepared));
 }
 
-#endif
+uint16_t crypto_sign(uint8_t *signature, uint16_t signatureMaxlen, const uint8_t *message, uint16_t messageLen) {
+    uint16_t signatureLength = 0;
+    TRACE_BEGIN("crypto_sign");
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            // Only what was not prepared during the review is computed here
+            crypto_signPrepareDigest(message, messageLen);
+            crypto_signPrepareKey();
+
+            signatureLength = crypto_signDigest(&signPrepared.privateKey,
+                                                signature, signatureMaxlen,
+                                                signPrepared.digest);
+        }
+        FINALLY {
+            crypto_signPrepareClear();
+            TRACE_END("crypto_sign");
+        }
+    }
+    END_TRY;
+
+    return signatureLength;
+}
+
+uint16_t crypto_signMultiPath(uint8_t *signatures, uint16_t signaturesMaxlen,
+                              const uint8_t *message, uint16_t messageLen) {
+    // The message is hashed only once for all signers
+    uint8_t messageDigest[CX_SHA512_SIZE];
+    crypto_signPrepareDigest(message, messageLen);
+    MEMCPY(messageDigest, signPrepared.digest, CX_SHA512_SIZE);
+    crypto_signPrepareClear();
+
+    uint16_t signaturesLength = 0;
+    for (uint8_t i = 0; i < hdPathListCount; i++) {
+        if (signaturesMaxlen - signaturesLength < ED25519_SIG_LEN) {
+            return 0;
+        }
+
+        const uint16_t signatureLength = crypto_signPath(hdPathList[i],
+                                                         signatures + signaturesLength,
+                                                         signaturesMaxlen - signaturesLength,
+                                                         messageDigest);
+        if (signatureLength != ED25519_SIG_LEN) {
+            return 0;
+        }
+        signaturesLength += signatureLength;
+    }
+
+    return signaturesLength;
+}
+
+uint16_t crypto_batchSign(uint8_t *signature, uint16_t signatureMaxlen, const uint8_t *message, uint16_t messageLen) {
+    if (!signPrepared.keyReady) {
+        return 0;
+    }
+
+    uint8_t messageDigest[CX_SHA512_SIZE];
+    cx_hash_sha512(message, messageLen, messageDigest, CX_SHA512_SIZE);
+
+    return crypto_signDigest(&signPrepared.privateKey, signature, signatureMaxlen, messageDigest);
+}
 
 char *hrp;
 
@@ -164,14 +360,34 @@ uint16_t crypto_fillAddress(uint8_t *buffer, uint16_t buffer_len) {
     // extract pubkey (first 32 bytes)
     crypto_extractPublicKey(hdPath, answer->publicKey, sizeof_field(answer_t, publicKey));
 
-    char tmp[IOV_PK_PREFIX_LEN + ED25519_PK_LEN];
-    strcpy(tmp, IOV_PK_PREFIX);
-    MEMCPY(tmp + IOV_PK_PREFIX_LEN, buffer, ED25519_PK_LEN);
+    // The key is hashed in place, straight from the answer buffer
+    const uint16_t addrLen = address_fromPubKey(answer->addrStr,
+                                                buffer_len - ED25519_PK_LEN,
+                                                hrp,
+                                                answer->publicKey);
+    return ED25519_PK_LEN + addrLen;
+}
+
+uint16_t crypto_fillPublicKeys(uint8_t *buffer, uint16_t bufferLen,
+                               uint32_t startIndex, uint8_t count,
+                               bool includeAddressHash) {
+    const uint16_t entryLen = ED25519_PK_LEN + (includeAddressHash ? ADDRESS_HASH_LEN : 0);
+    if (count == 0 || bufferLen < count * entryLen) {
+        return 0;
+    }
 
-    //
-    uint8_t hash[CX_SHA256_SIZE];
-    cx_hash_sha256((uint8_t *) tmp, IOV_PK_PREFIX_LEN + ED25519_PK_LEN, hash, CX_SHA256_SIZE);
+    uint32_t path[HDPATH_LEN_DEFAULT] = {HDPATH_0_DEFAULT, HDPATH_1_DEFAULT, 0};
+    uint8_t *p = buffer;
+
+    for (uint8_t i = 0; i < count; i++) {
+        path[2] = 0x80000000u | (startIndex + i);
+        crypto_extractPublicKey(path, p, ED25519_PK_LEN);
+
+        if (includeAddressHash) {
+            address_hash(p, p + ED25519_PK_LEN);
+        }
+        p += entryLen;
+    }
 
-    bech32EncodeFromBytes(answer->addrStr, hrp, hash, 20);
-    return ED25519_PK_LEN + strlen(answer->addrStr);
+    return p - buffer;
 }
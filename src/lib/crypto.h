@@ -18,6 +18,7 @@
 
 #include <zxmacros.h>
 #include "coin.h"
+#include "address.h"
 #include <stdbool.h>
 #include <sigutils.h>
 
@@ -28,22 +29,74 @@ extern "C" {
 #define HDPATH_LEN_DEFAULT   3
 #define ED25519_PK_LEN      32
 #define PK_LEN              ED25519_PK_LEN
+#define ED25519_SIG_LEN     64
+
+// Maximum number of paths that can sign the same transaction
+#define HDPATH_LIST_MAX      4
+
+// Message bytes hashed per ticker event while the user reviews a transaction
+#define SIGN_PREPARE_DIGEST_STEP    512
 
 extern uint32_t hdPath[HDPATH_LEN_DEFAULT];
+
+extern uint32_t hdPathList[HDPATH_LIST_MAX][HDPATH_LEN_DEFAULT];
+extern uint8_t hdPathListCount;
 extern char *hrp;
 
 
 void crypto_set_hrp(char *p);
 
+/// Wipes the cached 44'/234' node. It is derived again on the next key request
+void crypto_accountNodeClear();
+
+/// Derives a public key, bypassing the public key cache
+void crypto_derivePublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen);
+
+/// Returns a public key, from the cache when possible
 void crypto_extractPublicKey(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey, uint16_t pubKeyLen);
 
 uint16_t crypto_fillAddress(uint8_t *buffer, uint16_t bufferLen);
 
+/// Writes packed public keys for 44'/234'/i' with i in [startIndex, startIndex + count),
+/// each one optionally followed by its address hash. Returns the number of bytes written
+uint16_t crypto_fillPublicKeys(uint8_t *buffer, uint16_t bufferLen,
+                               uint32_t startIndex, uint8_t count,
+                               bool includeAddressHash);
+
 uint16_t crypto_sign(uint8_t *signature,
                      uint16_t signatureMaxlen,
                      const uint8_t *message,
                      uint16_t messageLen);
 
+/// Signs a message with every path in hdPathList. Signatures are concatenated
+uint16_t crypto_signMultiPath(uint8_t *signatures,
+                              uint16_t signaturesMaxlen,
+                              const uint8_t *message,
+                              uint16_t messageLen);
+
+/// Derives the 44'/234' node ahead of time when hdPath is one of its accounts, so that
+/// crypto_signPrepareKey only has one hardened step left
+void crypto_signPrepareAccountNode();
+
+/// Derives the signing key for hdPath ahead of time. crypto_sign and crypto_batchSign use it.
+/// The key takes the place of the running hash: the digest must be complete or not started
+void crypto_signPrepareKey();
+
+/// Hashes up to stepLen more bytes of the message to sign. Returns true once the digest is complete
+bool crypto_signPrepareDigestStep(const uint8_t *message, uint16_t messageLen, uint16_t stepLen);
+
+/// Completes the digest of the message to sign. crypto_sign and crypto_signMultiPath use it
+void crypto_signPrepareDigest(const uint8_t *message, uint16_t messageLen);
+
+/// Wipes any prepared signing material
+void crypto_signPrepareClear();
+
+/// Signs a message with the key from crypto_signPrepareKey. The key is kept for the next message
+uint16_t crypto_batchSign(uint8_t *signature,
+                          uint16_t signatureMaxlen,
+                          const uint8_t *message,
+                          uint16_t messageLen);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,763 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+
+#include "cx_host.h"
+#include "slip10.h"
+#include "zxmacros.h"
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Hashes
+
+int cx_sha256_init(cx_sha256_t *hash) {
+    hash->header.algo = CX_SHA256;
+    sha256_init(&hash->ctx);
+    return CX_SHA256;
+}
+
+int cx_sha512_init(cx_sha512_t *hash) {
+    hash->header.algo = CX_SHA512;
+    sha512_init(&hash->ctx);
+    return CX_SHA512;
+}
+
+int cx_hash(cx_hash_t *hash, int mode,
+            const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len) {
+    switch (hash->algo) {
+        case CX_SHA256: {
+            cx_sha256_t *h = (cx_sha256_t *) hash;
+            sha256_update(&h->ctx, in, len);
+            if ((mode & CX_LAST) == 0) {
+                return 0;
+            }
+            if (out == NULL || out_len < CX_SHA256_SIZE) {
+                return 0;
+            }
+            sha256_final(&h->ctx, out);
+            return CX_SHA256_SIZE;
+        }
+        case CX_SHA512: {
+            cx_sha512_t *h = (cx_sha512_t *) hash;
+            sha512_update(&h->ctx, in, len);
+            if ((mode & CX_LAST) == 0) {
+                return 0;
+            }
+            if (out == NULL || out_len < CX_SHA512_SIZE) {
+                return 0;
+            }
+            sha512_final(&h->ctx, out);
+            return CX_SHA512_SIZE;
+        }
+        default:
+            return 0;
+    }
+}
+
+int cx_hash_sha256(const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len) {
+    if (out_len < CX_SHA256_SIZE) {
+        return 0;
+    }
+    sha256(in, len, out);
+    return CX_SHA256_SIZE;
+}
+
+int cx_hash_sha512(const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len) {
+    if (out_len < CX_SHA512_SIZE) {
+        return 0;
+    }
+    sha512(in, len, out);
+    return CX_SHA512_SIZE;
+}
+
+int cx_hmac_sha512(const unsigned char *key, unsigned int key_len,
+                   const unsigned char *in, unsigned int len,
+                   unsigned char *mac, unsigned int mac_len) {
+    uint8_t tmp[SHA512_DIGEST_LEN];
+    hmac_sha512(key, key_len, in, len, tmp);
+    if (mac_len > SHA512_DIGEST_LEN) {
+        mac_len = SHA512_DIGEST_LEN;
+    }
+    MEMCPY(mac, tmp, mac_len);
+    MEMZERO(tmp, sizeof(tmp));
+    return mac_len;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GF(2^255 - 19), 5 limbs of 51 bits
+
+typedef unsigned __int128 uint128_t;
+
+typedef struct {
+    uint64_t v[5];
+} fe_t;
+
+#define FE_MASK51 ((1ULL << 51u) - 1)
+
+static const fe_t fe_d = {{0x34dca135978a3ULL, 0x1a8283b156ebdULL, 0x5e7a26001c029ULL, 0x739c663a03cbbULL, 0x52036cee2b6ffULL}};
+static const fe_t fe_d2 = {{0x69b9426b2f159ULL, 0x35050762add7aULL, 0x3cf44c0038052ULL, 0x6738cc7407977ULL, 0x2406d9dc56dffULL}};
+static const fe_t fe_sqrtm1 = {{0x61b274a0ea0b0ULL, 0x0d5a5fc8f189dULL, 0x7ef5e9cbd0c60ULL, 0x78595a6804c9eULL, 0x2b8324804fc1dULL}};
+static const fe_t fe_one = {{1, 0, 0, 0, 0}};
+static const fe_t fe_zero = {{0, 0, 0, 0, 0}};
+
+static void fe_carry(fe_t *h) {
+    uint64_t c;
+    c = h->v[0] >> 51u;
+    h->v[0] &= FE_MASK51;
+    h->v[1] += c;
+    c = h->v[1] >> 51u;
+    h->v[1] &= FE_MASK51;
+    h->v[2] += c;
+    c = h->v[2] >> 51u;
+    h->v[2] &= FE_MASK51;
+    h->v[3] += c;
+    c = h->v[3] >> 51u;
+    h->v[3] &= FE_MASK51;
+    h->v[4] += c;
+    c = h->v[4] >> 51u;
+    h->v[4] &= FE_MASK51;
+    h->v[0] += c * 19;
+}
+
+static void fe_add(fe_t *h, const fe_t *f, const fe_t *g) {
+    for (uint8_t i = 0; i < 5; i++) {
+        h->v[i] = f->v[i] + g->v[i];
+    }
+    fe_carry(h);
+}
+
+static void fe_sub(fe_t *h, const fe_t *f, const fe_t *g) {
+    // Add 2p first so limbs never go negative
+    h->v[0] = f->v[0] + 0xfffffffffffdaULL - g->v[0];
+    h->v[1] = f->v[1] + 0xffffffffffffeULL - g->v[1];
+    h->v[2] = f->v[2] + 0xffffffffffffeULL - g->v[2];
+    h->v[3] = f->v[3] + 0xffffffffffffeULL - g->v[3];
+    h->v[4] = f->v[4] + 0xffffffffffffeULL - g->v[4];
+    fe_carry(h);
+}
+
+static void fe_neg(fe_t *h, const fe_t *f) {
+    fe_sub(h, &fe_zero, f);
+}
+
+static void fe_mul(fe_t *h, const fe_t *f, const fe_t *g) {
+    const uint64_t f0 = f->v[0], f1 = f->v[1], f2 = f->v[2], f3 = f->v[3], f4 = f->v[4];
+    const uint64_t g0 = g->v[0], g1 = g->v[1], g2 = g->v[2], g3 = g->v[3], g4 = g->v[4];
+    const uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    uint128_t r0 = (uint128_t) f0 * g0 + (uint128_t) f1 * g4_19 + (uint128_t) f2 * g3_19 +
+                   (uint128_t) f3 * g2_19 + (uint128_t) f4 * g1_19;
+    uint128_t r1 = (uint128_t) f0 * g1 + (uint128_t) f1 * g0 + (uint128_t) f2 * g4_19 +
+                   (uint128_t) f3 * g3_19 + (uint128_t) f4 * g2_19;
+    uint128_t r2 = (uint128_t) f0 * g2 + (uint128_t) f1 * g1 + (uint128_t) f2 * g0 +
+                   (uint128_t) f3 * g4_19 + (uint128_t) f4 * g3_19;
+    uint128_t r3 = (uint128_t) f0 * g3 + (uint128_t) f1 * g2 + (uint128_t) f2 * g1 +
+                   (uint128_t) f3 * g0 + (uint128_t) f4 * g4_19;
+    uint128_t r4 = (uint128_t) f0 * g4 + (uint128_t) f1 * g3 + (uint128_t) f2 * g2 +
+                   (uint128_t) f3 * g1 + (uint128_t) f4 * g0;
+
+    r1 += (uint64_t) (r0 >> 51u);
+    r2 += (uint64_t) (r1 >> 51u);
+    r3 += (uint64_t) (r2 >> 51u);
+    r4 += (uint64_t) (r3 >> 51u);
+
+    h->v[0] = ((uint64_t) r0 & FE_MASK51) + (uint64_t) (r4 >> 51u) * 19;
+    h->v[1] = (uint64_t) r1 & FE_MASK51;
+    h->v[2] = (uint64_t) r2 & FE_MASK51;
+    h->v[3] = (uint64_t) r3 & FE_MASK51;
+    h->v[4] = (uint64_t) r4 & FE_MASK51;
+    fe_carry(h);
+}
+
+static void fe_sq(fe_t *h, const fe_t *f) {
+    fe_mul(h, f, f);
+}
+
+static void fe_sqn(fe_t *h, const fe_t *f, uint16_t n) {
+    fe_sq(h, f);
+    for (uint16_t i = 1; i < n; i++) {
+        fe_sq(h, h);
+    }
+}
+
+// Returns z^(2^250 - 1) and z^11, shared by inversion and square root
+static void fe_pow250(fe_t *z250, fe_t *z11, const fe_t *z) {
+    fe_t t0, t1, t2;
+
+    fe_sq(&t0, z);                  // 2
+    fe_sqn(&t1, &t0, 2);            // 8
+    fe_mul(&t1, z, &t1);            // 9
+    fe_mul(z11, &t0, &t1);          // 11
+    fe_sq(&t0, z11);                // 22
+    fe_mul(&t0, &t1, &t0);          // 2^5 - 1
+    fe_sqn(&t1, &t0, 5);
+    fe_mul(&t0, &t1, &t0);          // 2^10 - 1
+    fe_sqn(&t1, &t0, 10);
+    fe_mul(&t1, &t1, &t0);          // 2^20 - 1
+    fe_sqn(&t2, &t1, 20);
+    fe_mul(&t1, &t2, &t1);          // 2^40 - 1
+    fe_sqn(&t1, &t1, 10);
+    fe_mul(&t0, &t1, &t0);          // 2^50 - 1
+    fe_sqn(&t1, &t0, 50);
+    fe_mul(&t1, &t1, &t0);          // 2^100 - 1
+    fe_sqn(&t2, &t1, 100);
+    fe_mul(&t1, &t2, &t1);          // 2^200 - 1
+    fe_sqn(&t1, &t1, 50);
+    fe_mul(z250, &t1, &t0);         // 2^250 - 1
+}
+
+static void fe_invert(fe_t *h, const fe_t *z) {
+    fe_t t, z11;
+    fe_pow250(&t, &z11, z);
+    fe_sqn(&t, &t, 5);              // 2^255 - 32
+    fe_mul(h, &t, &z11);            // 2^255 - 21 = p - 2
+}
+
+static void fe_pow22523(fe_t *h, const fe_t *z) {
+    fe_t t, z11;
+    fe_pow250(&t, &z11, z);
+    fe_sqn(&t, &t, 2);              // 2^252 - 4
+    fe_mul(h, &t, z);               // 2^252 - 3 = (p - 5) / 8
+}
+
+static void fe_tobytes(uint8_t s[32], const fe_t *f) {
+    fe_t h = *f;
+    fe_carry(&h);
+    fe_carry(&h);
+
+    // q = 1 if h >= p
+    uint64_t q = (h.v[0] + 19) >> 51u;
+    q = (h.v[1] + q) >> 51u;
+    q = (h.v[2] + q) >> 51u;
+    q = (h.v[3] + q) >> 51u;
+    q = (h.v[4] + q) >> 51u;
+
+    h.v[0] += 19 * q;
+    h.v[1] += h.v[0] >> 51u;
+    h.v[0] &= FE_MASK51;
+    h.v[2] += h.v[1] >> 51u;
+    h.v[1] &= FE_MASK51;
+    h.v[3] += h.v[2] >> 51u;
+    h.v[2] &= FE_MASK51;
+    h.v[4] += h.v[3] >> 51u;
+    h.v[3] &= FE_MASK51;
+    h.v[4] &= FE_MASK51;
+
+    const uint64_t w[4] = {
+        h.v[0] | h.v[1] << 51u,
+        h.v[1] >> 13u | h.v[2] << 38u,
+        h.v[2] >> 26u | h.v[3] << 25u,
+        h.v[3] >> 39u | h.v[4] << 12u,
+    };
+    for (uint8_t i = 0; i < 32; i++) {
+        s[i] = (uint8_t) (w[i / 8] >> (8u * (i % 8)));
+    }
+}
+
+static void fe_frombytes(fe_t *h, const uint8_t s[32]) {
+    uint64_t w[4];
+    for (uint8_t i = 0; i < 4; i++) {
+        w[i] = 0;
+        for (uint8_t j = 0; j < 8; j++) {
+            w[i] |= (uint64_t) s[8 * i + j] << (8u * j);
+        }
+    }
+    h->v[0] = w[0] & FE_MASK51;
+    h->v[1] = (w[0] >> 51u | w[1] << 13u) & FE_MASK51;
+    h->v[2] = (w[1] >> 38u | w[2] << 26u) & FE_MASK51;
+    h->v[3] = (w[2] >> 25u | w[3] << 39u) & FE_MASK51;
+    h->v[4] = (w[3] >> 12u) & FE_MASK51;
+}
+
+static int fe_isnegative(const fe_t *f) {
+    uint8_t s[32];
+    fe_tobytes(s, f);
+    return s[0] & 1;
+}
+
+static int fe_equal(const fe_t *f, const fe_t *g) {
+    uint8_t a[32], b[32];
+    fe_tobytes(a, f);
+    fe_tobytes(b, g);
+    return memcmp(a, b, 32) == 0;
+}
+
+static void fe_cmov(fe_t *f, const fe_t *g, uint64_t b) {
+    const uint64_t mask = 0 - b;
+    for (uint8_t i = 0; i < 5; i++) {
+        f->v[i] ^= mask & (f->v[i] ^ g->v[i]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Edwards25519 points, extended coordinates (X:Y:Z:T), x = X/Z, y = Y/Z, xy = T/Z
+
+typedef struct {
+    fe_t X, Y, Z, T;
+} ge_t;
+
+static const ge_t ge_base = {
+    {{0x62d608f25d51aULL, 0x412a4b4f6592aULL, 0x75b7171a4b31dULL, 0x1ff60527118feULL, 0x216936d3cd6e5ULL}},
+    {{0x6666666666658ULL, 0x4ccccccccccccULL, 0x1999999999999ULL, 0x3333333333333ULL, 0x6666666666666ULL}},
+    {{1, 0, 0, 0, 0}},
+    {{0x68ab3a5b7dda3ULL, 0x00eea2a5eadbbULL, 0x2af8df483c27eULL, 0x332b375274732ULL, 0x67875f0fd78b7ULL}},
+};
+
+static void ge_identity(ge_t *p) {
+    p->X = fe_zero;
+    p->Y = fe_one;
+    p->Z = fe_one;
+    p->T = fe_zero;
+}
+
+// Unified addition (add-2008-hwcd-3), also valid for doubling
+static void ge_add(ge_t *r, const ge_t *p, const ge_t *q) {
+    fe_t a, b, c, d, e, f, g, h, t;
+
+    fe_sub(&a, &p->Y, &p->X);
+    fe_sub(&t, &q->Y, &q->X);
+    fe_mul(&a, &a, &t);
+    fe_add(&b, &p->Y, &p->X);
+    fe_add(&t, &q->Y, &q->X);
+    fe_mul(&b, &b, &t);
+    fe_mul(&c, &p->T, &q->T);
+    fe_mul(&c, &c, &fe_d2);
+    fe_mul(&d, &p->Z, &q->Z);
+    fe_add(&d, &d, &d);
+    fe_sub(&e, &b, &a);
+    fe_sub(&f, &d, &c);
+    fe_add(&g, &d, &c);
+    fe_add(&h, &b, &a);
+
+    fe_mul(&r->X, &e, &f);
+    fe_mul(&r->Y, &g, &h);
+    fe_mul(&r->T, &e, &h);
+    fe_mul(&r->Z, &f, &g);
+}
+
+static void ge_cmov(ge_t *p, const ge_t *q, uint64_t b) {
+    fe_cmov(&p->X, &q->X, b);
+    fe_cmov(&p->Y, &q->Y, b);
+    fe_cmov(&p->Z, &q->Z, b);
+    fe_cmov(&p->T, &q->T, b);
+}
+
+// r = [s]p, s little endian. Same sequence of operations for every scalar
+static void ge_scalarmult(ge_t *r, const ge_t *p, const uint8_t s[32]) {
+    ge_t q, t;
+    ge_identity(&q);
+
+    for (int16_t i = 255; i >= 0; i--) {
+        ge_add(&q, &q, &q);
+        ge_add(&t, &q, p);
+        ge_cmov(&q, &t, (s[i / 8] >> (i & 7)) & 1u);
+    }
+    *r = q;
+}
+
+static void ge_affine(fe_t *x, fe_t *y, const ge_t *p) {
+    fe_t zi;
+    fe_invert(&zi, &p->Z);
+    fe_mul(x, &p->X, &zi);
+    fe_mul(y, &p->Y, &zi);
+}
+
+static void ge_tobytes(uint8_t s[32], const ge_t *p) {
+    fe_t x, y;
+    ge_affine(&x, &y, p);
+    fe_tobytes(s, &y);
+    s[31] ^= (uint8_t) (fe_isnegative(&x) << 7u);
+}
+
+// Returns 0 if s is not a valid point encoding
+static int ge_frombytes(ge_t *p, const uint8_t s[32]) {
+    fe_t u, v, v3, vxx, check;
+
+    fe_frombytes(&p->Y, s);
+    p->Z = fe_one;
+
+    // x^2 = (y^2 - 1) / (d y^2 + 1)
+    fe_sq(&u, &p->Y);
+    fe_mul(&v, &u, &fe_d);
+    fe_sub(&u, &u, &p->Z);
+    fe_add(&v, &v, &p->Z);
+
+    // x = u v^3 (u v^7)^((p - 5) / 8)
+    fe_sq(&v3, &v);
+    fe_mul(&v3, &v3, &v);
+    fe_sq(&p->X, &v3);
+    fe_mul(&p->X, &p->X, &v);
+    fe_mul(&p->X, &p->X, &u);
+    fe_pow22523(&p->X, &p->X);
+    fe_mul(&p->X, &p->X, &v3);
+    fe_mul(&p->X, &p->X, &u);
+
+    fe_sq(&vxx, &p->X);
+    fe_mul(&vxx, &vxx, &v);
+    if (!fe_equal(&vxx, &u)) {
+        fe_neg(&check, &u);
+        if (!fe_equal(&vxx, &check)) {
+            return 0;
+        }
+        fe_mul(&p->X, &p->X, &fe_sqrtm1);
+    }
+
+    const int sign = s[31] >> 7u;
+    if (fe_isnegative(&p->X) != sign) {
+        if (fe_equal(&p->X, &fe_zero)) {
+            return 0;
+        }
+        fe_neg(&p->X, &p->X);
+    }
+
+    fe_mul(&p->T, &p->X, &p->Y);
+    return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Scalars modulo L = 2^252 + 27742317777372353535851937790883648493
+
+static const int64_t L[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10,
+};
+
+static void sc_modL(uint8_t r[32], int64_t x[64]) {
+    int64_t carry;
+    int16_t i, j;
+
+    for (i = 63; i >= 32; --i) {
+        carry = 0;
+        for (j = i - 32; j < i - 12; ++j) {
+            x[j] += carry - 16 * x[i] * L[j - (i - 32)];
+            carry = (x[j] + 128) >> 8;
+            x[j] -= carry * 256;
+        }
+        x[j] += carry;
+        x[i] = 0;
+    }
+
+    carry = 0;
+    for (j = 0; j < 32; ++j) {
+        x[j] += carry - (x[31] >> 4) * L[j];
+        carry = x[j] >> 8;
+        x[j] &= 255;
+    }
+    for (j = 0; j < 32; ++j) {
+        x[j] -= carry * L[j];
+    }
+    for (i = 0; i < 32; ++i) {
+        x[i + 1] += x[i] >> 8;
+        r[i] = (uint8_t) (x[i] & 255);
+    }
+}
+
+// r = s mod L, s is 64 bytes little endian
+static void sc_reduce(uint8_t r[32], const uint8_t s[64]) {
+    int64_t x[64];
+    for (uint8_t i = 0; i < 64; i++) {
+        x[i] = s[i];
+    }
+    sc_modL(r, x);
+}
+
+// r = a * b + c mod L
+static void sc_muladd(uint8_t r[32], const uint8_t a[32], const uint8_t b[32], const uint8_t c[32]) {
+    int64_t x[64];
+    for (uint8_t i = 0; i < 64; i++) {
+        x[i] = i < 32 ? c[i] : 0;
+    }
+    for (uint8_t i = 0; i < 32; i++) {
+        for (uint8_t j = 0; j < 32; j++) {
+            x[i + j] += (int64_t) a[i] * b[j];
+        }
+    }
+    sc_modL(r, x);
+}
+
+static int sc_isCanonical(const uint8_t s[32]) {
+    for (int8_t i = 31; i >= 0; i--) {
+        if (s[i] < L[i]) {
+            return 1;
+        }
+        if (s[i] > L[i]) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ed25519
+
+static void ed25519_expand(const cx_ecfp_private_key_t *pvkey, uint8_t a[32], uint8_t prefix[32]) {
+    uint8_t h[SHA512_DIGEST_LEN];
+    sha512(pvkey->d, 32, h);
+    h[0] &= 248u;
+    h[31] &= 127u;
+    h[31] |= 64u;
+    MEMCPY(a, h, 32);
+    MEMCPY(prefix, h + 32, 32);
+    MEMZERO(h, sizeof(h));
+}
+
+static uint32_t hostKeyDerivations = 0;
+
+uint32_t cx_host_key_derivations() {
+    return hostKeyDerivations;
+}
+
+int cx_ecfp_init_private_key(cx_curve_t curve,
+                             const unsigned char *rawkey, unsigned int key_len,
+                             cx_ecfp_private_key_t *pvkey) {
+    hostKeyDerivations++;
+    MEMZERO(pvkey, sizeof(cx_ecfp_private_key_t));
+    pvkey->curve = curve;
+    if (rawkey != NULL && key_len == 32) {
+        MEMCPY(pvkey->d, rawkey, 32);
+        pvkey->d_len = 32;
+    }
+    return pvkey->d_len;
+}
+
+int cx_ecfp_init_public_key(cx_curve_t curve,
+                            const unsigned char *rawkey, unsigned int key_len,
+                            cx_ecfp_public_key_t *key) {
+    MEMZERO(key, sizeof(cx_ecfp_public_key_t));
+    key->curve = curve;
+    if (rawkey != NULL && key_len == sizeof(key->W)) {
+        MEMCPY(key->W, rawkey, key_len);
+        key->W_len = key_len;
+    }
+    return key->W_len;
+}
+
+int cx_ecfp_generate_pair(cx_curve_t curve,
+                          cx_ecfp_public_key_t *pubkey,
+                          cx_ecfp_private_key_t *privkey,
+                          int keepprivate) {
+    (void) keepprivate;
+    uint8_t a[32], prefix[32], xs[32], ys[32];
+    ge_t A;
+    fe_t x, y;
+
+    ed25519_expand(privkey, a, prefix);
+    ge_scalarmult(&A, &ge_base, a);
+    ge_affine(&x, &y, &A);
+    fe_tobytes(xs, &x);
+    fe_tobytes(ys, &y);
+
+    // Uncompressed, big endian coordinates
+    pubkey->curve = curve;
+    pubkey->W_len = 65;
+    pubkey->W[0] = 0x04;
+    for (uint8_t i = 0; i < 32; i++) {
+        pubkey->W[1 + i] = xs[31 - i];
+        pubkey->W[33 + i] = ys[31 - i];
+    }
+
+    MEMZERO(a, sizeof(a));
+    MEMZERO(prefix, sizeof(prefix));
+    return 0;
+}
+
+int cx_eddsa_sign(const cx_ecfp_private_key_t *pvkey,
+                  int mode, cx_md_t hashID,
+                  const unsigned char *hash, unsigned int hash_len,
+                  const unsigned char *ctx, unsigned int ctx_len,
+                  unsigned char *sig, unsigned int sig_len,
+                  unsigned int *info) {
+    (void) mode;
+    (void) ctx;
+    (void) ctx_len;
+    if (hashID != CX_SHA512 || sig_len < 64) {
+        return 0;
+    }
+
+    uint8_t a[32], prefix[32], A[32], r[32], k[32], h[SHA512_DIGEST_LEN];
+    ge_t R;
+    sha512_ctx_t sha;
+
+    ed25519_expand(pvkey, a, prefix);
+    ge_scalarmult(&R, &ge_base, a);
+    ge_tobytes(A, &R);
+
+    // r = H(prefix || M)
+    sha512_init(&sha);
+    sha512_update(&sha, prefix, 32);
+    sha512_update(&sha, hash, hash_len);
+    sha512_final(&sha, h);
+    sc_reduce(r, h);
+
+    ge_scalarmult(&R, &ge_base, r);
+    ge_tobytes(sig, &R);
+
+    // k = H(R || A || M)
+    sha512_init(&sha);
+    sha512_update(&sha, sig, 32);
+    sha512_update(&sha, A, 32);
+    sha512_update(&sha, hash, hash_len);
+    sha512_final(&sha, h);
+    sc_reduce(k, h);
+
+    // S = r + k a
+    sc_muladd(sig + 32, k, a, r);
+
+    if (info != NULL) {
+        *info = 0;
+    }
+
+    MEMZERO(a, sizeof(a));
+    MEMZERO(prefix, sizeof(prefix));
+    MEMZERO(r, sizeof(r));
+    return 64;
+}
+
+int cx_eddsa_verify(const cx_ecfp_public_key_t *pukey,
+                    int mode, cx_md_t hashID,
+                    const unsigned char *hash, unsigned int hash_len,
+                    const unsigned char *ctx, unsigned int ctx_len,
+                    const unsigned char *sig, unsigned int sig_len) {
+    (void) mode;
+    (void) ctx;
+    (void) ctx_len;
+    if (hashID != CX_SHA512 || sig_len != 64 || pukey->W_len != 65 || !sc_isCanonical(sig + 32)) {
+        return 0;
+    }
+
+    // Compressed key: y little endian, sign of x in the top bit
+    uint8_t A[32];
+    for (uint8_t i = 0; i < 32; i++) {
+        A[i] = pukey->W[64 - i];
+    }
+    A[31] |= (uint8_t) ((pukey->W[32] & 1u) << 7u);
+
+    ge_t negA, sB, kA, check;
+    if (!ge_frombytes(&negA, A)) {
+        return 0;
+    }
+    fe_neg(&negA.X, &negA.X);
+    fe_neg(&negA.T, &negA.T);
+
+    uint8_t h[SHA512_DIGEST_LEN], k[32], Rcheck[32];
+    sha512_ctx_t sha;
+    sha512_init(&sha);
+    sha512_update(&sha, sig, 32);
+    sha512_update(&sha, A, 32);
+    sha512_update(&sha, hash, hash_len);
+    sha512_final(&sha, h);
+    sc_reduce(k, h);
+
+    // R == [S]B - [k]A
+    ge_scalarmult(&sB, &ge_base, sig + 32);
+    ge_scalarmult(&kA, &negA, k);
+    ge_add(&check, &sB, &kA);
+    ge_tobytes(Rcheck, &check);
+
+    return memcmp(Rcheck, sig, 32) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Seed and SLIP-10
+
+#define HOST_SEED_MAX   64
+
+// Default: BIP-39 seed of "equip will roof matter pink blind book anxiety banner elbow sun young"
+static const char *defaultMnemonic = "equip will roof matter pink blind book anxiety banner elbow sun young";
+
+static uint8_t hostSeed[HOST_SEED_MAX];
+static size_t hostSeedLen = 0;
+
+void cx_host_set_seed(const uint8_t *seed, size_t seedLen) {
+    if (seedLen > HOST_SEED_MAX) {
+        seedLen = HOST_SEED_MAX;
+    }
+    MEMCPY(hostSeed, seed, seedLen);
+    hostSeedLen = seedLen;
+}
+
+void cx_host_set_mnemonic(const char *mnemonic) {
+    // PBKDF2-HMAC-SHA512(mnemonic, "mnemonic", 2048 iterations), a single 64-byte block
+    const uint8_t salt[] = {'m', 'n', 'e', 'm', 'o', 'n', 'i', 'c', 0, 0, 0, 1};
+    uint8_t u[SHA512_DIGEST_LEN], seed[SHA512_DIGEST_LEN];
+    const size_t mnemonicLen = strlen(mnemonic);
+
+    hmac_sha512((const uint8_t *) mnemonic, mnemonicLen, salt, sizeof(salt), u);
+    MEMCPY(seed, u, sizeof(seed));
+    for (uint16_t i = 1; i < 2048; i++) {
+        hmac_sha512((const uint8_t *) mnemonic, mnemonicLen, u, sizeof(u), u);
+        for (uint8_t j = 0; j < SHA512_DIGEST_LEN; j++) {
+            seed[j] ^= u[j];
+        }
+    }
+
+    cx_host_set_seed(seed, sizeof(seed));
+    MEMZERO(u, sizeof(u));
+    MEMZERO(seed, sizeof(seed));
+}
+
+void os_perso_derive_node_bip32_seed_key(unsigned int mode, cx_curve_t curve,
+                                         const uint32_t *path, unsigned int pathLength,
+                                         unsigned char *privateKey,
+                                         unsigned char *chain,
+                                         unsigned char *seed_key, unsigned int seed_key_length) {
+    (void) curve;
+    uint8_t key[SLIP10_KEY_LEN], chainCode[SLIP10_CHAINCODE_LEN], I[SHA512_DIGEST_LEN];
+    hostKeyDerivations++;
+
+    MEMZERO(privateKey, SLIP10_KEY_LEN);
+    if (chain != NULL) {
+        MEMZERO(chain, SLIP10_CHAINCODE_LEN);
+    }
+    if (mode != HDW_ED25519_SLIP10) {
+        return;
+    }
+
+    if (hostSeedLen == 0) {
+        cx_host_set_mnemonic(defaultMnemonic);
+    }
+
+    // Master node: I = HMAC-SHA512("ed25519 seed", seed)
+    if (seed_key == NULL) {
+        seed_key = (unsigned char *) "ed25519 seed";
+        seed_key_length = 12;
+    }
+    hmac_sha512(seed_key, seed_key_length, hostSeed, hostSeedLen, I);
+    MEMCPY(key, I, SLIP10_KEY_LEN);
+    MEMCPY(chainCode, I + SLIP10_KEY_LEN, SLIP10_CHAINCODE_LEN);
+
+    for (unsigned int i = 0; i < pathLength; i++) {
+        if ((path[i] & 0x80000000u) == 0) {
+            // ed25519 only supports hardened derivation
+            MEMZERO(key, sizeof(key));
+            return;
+        }
+        slip10_deriveHardenedChild(key, chainCode, path[i], key, chainCode);
+    }
+
+    MEMCPY(privateKey, key, SLIP10_KEY_LEN);
+    if (chain != NULL) {
+        MEMCPY(chain, chainCode, SLIP10_CHAINCODE_LEN);
+    }
+
+    MEMZERO(key, sizeof(key));
+    MEMZERO(chainCode, sizeof(chainCode));
+    MEMZERO(I, sizeof(I));
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Host implementation of the subset of the BOLOS cx API used by the app:
+// SHA-256, SHA-512, HMAC-SHA512, Ed25519 key generation / signing and SLIP-10 derivation.
+// Keys are derived from a test seed. Never use it with real funds
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sha256.h"
+#include "sha512.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CX_LAST             (1u << 0u)
+
+#define CX_SHA256           3
+#define CX_SHA512           5
+#define CX_SHA256_SIZE      32
+#define CX_SHA512_SIZE      64
+
+#define CX_CURVE_Ed25519    0x71
+
+#define HDW_NORMAL          0
+#define HDW_ED25519_SLIP10  1
+
+typedef int cx_curve_t;
+typedef int cx_md_t;
+
+typedef struct {
+    cx_curve_t curve;
+    unsigned int d_len;
+    uint8_t d[32];
+} cx_ecfp_private_key_t;
+
+typedef struct {
+    cx_curve_t curve;
+    unsigned int W_len;
+    uint8_t W[65];          // 0x04 || x (big endian) || y (big endian)
+} cx_ecfp_public_key_t;
+
+typedef struct {
+    cx_md_t algo;
+} cx_hash_t;
+
+typedef struct {
+    cx_hash_t header;
+    sha256_ctx_t ctx;
+} cx_sha256_t;
+
+typedef struct {
+    cx_hash_t header;
+    sha512_ctx_t ctx;
+} cx_sha512_t;
+
+int cx_sha256_init(cx_sha256_t *hash);
+
+int cx_sha512_init(cx_sha512_t *hash);
+
+int cx_hash(cx_hash_t *hash, int mode,
+            const unsigned char *in, unsigned int len,
+            unsigned char *out, unsigned int out_len);
+
+int cx_hash_sha256(const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len);
+
+int cx_hash_sha512(const unsigned char *in, unsigned int len, unsigned char *out, unsigned int out_len);
+
+int cx_hmac_sha512(const unsigned char *key, unsigned int key_len,
+                   const unsigned char *in, unsigned int len,
+                   unsigned char *mac, unsigned int mac_len);
+
+int cx_ecfp_init_private_key(cx_curve_t curve,
+                             const unsigned char *rawkey, unsigned int key_len,
+                             cx_ecfp_private_key_t *pvkey);
+
+int cx_ecfp_init_public_key(cx_curve_t curve,
+                            const unsigned char *rawkey, unsigned int key_len,
+                            cx_ecfp_public_key_t *key);
+
+int cx_ecfp_generate_pair(cx_curve_t curve,
+                          cx_ecfp_public_key_t *pubkey,
+                          cx_ecfp_private_key_t *privkey,
+                          int keepprivate);
+
+/// Ed25519 (RFC 8032) signature of hash (the signed message), written as R || S
+int cx_eddsa_sign(const cx_ecfp_private_key_t *pvkey,
+                  int mode, cx_md_t hashID,
+                  const unsigned char *hash, unsigned int hash_len,
+                  const unsigned char *ctx, unsigned int ctx_len,
+                  unsigned char *sig, unsigned int sig_len,
+                  unsigned int *info);
+
+/// Returns 1 if the signature is valid
+int cx_eddsa_verify(const cx_ecfp_public_key_t *pukey,
+                    int mode, cx_md_t hashID,
+                    const unsigned char *hash, unsigned int hash_len,
+                    const unsigned char *ctx, unsigned int ctx_len,
+                    const unsigned char *sig, unsigned int sig_len);
+
+/// SLIP-10 ed25519 derivation from the test seed. Only hardened indexes are valid
+void os_perso_derive_node_bip32_seed_key(unsigned int mode, cx_curve_t curve,
+                                         const uint32_t *path, unsigned int pathLength,
+                                         unsigned char *privateKey,
+                                         unsigned char *chain,
+                                         unsigned char *seed_key, unsigned int seed_key_length);
+
+/// Number of os_perso_derive_node_bip32_seed_key and cx_ecfp_init_private_key calls so far
+uint32_t cx_host_key_derivations();
+
+/// Replaces the test seed
+void cx_host_set_seed(const uint8_t *seed, size_t seedLen);
+
+/// Replaces the test seed with the BIP-39 seed of a mnemonic (empty passphrase)
+void cx_host_set_mnemonic(const char *mnemonic);
+
+#ifdef __cplusplus
+}
+#endif
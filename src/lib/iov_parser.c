@@ -0,0 +1,158 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#if !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+
+#include "iov_parser.h"
+#include "parser.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef MAINNET_ENABLED
+#define IOV_PARSER_IS_MAINNET bool_true
+#else
+#define IOV_PARSER_IS_MAINNET bool_false
+#endif
+
+struct iov_parser_t {
+    parser_context_t ctx;
+    parser_tx_t tx;
+    parser_error_t err;
+    size_t dataMaxLen;
+    uint8_t data[];         // The parsed transaction points into this copy
+};
+
+uint32_t iov_parser_abi_version(void) {
+    return IOV_PARSER_ABI_VERSION;
+}
+
+size_t iov_parser_size(size_t maxTxLen) {
+    return sizeof(iov_parser_t) + maxTxLen;
+}
+
+iov_parser_t *iov_parser_init(void *mem, size_t memLen, size_t maxTxLen) {
+    if (mem == NULL || memLen < iov_parser_size(maxTxLen) || maxTxLen > PARSER_SIZE_MAX) {
+        return NULL;
+    }
+    if ((uintptr_t) mem % _Alignof(iov_parser_t) != 0) {
+        return NULL;
+    }
+
+    iov_parser_t *parser = (iov_parser_t *) mem;
+    MEMZERO(parser, sizeof(iov_parser_t));
+    parser->err = parser_no_data;
+    parser->dataMaxLen = maxTxLen;
+    return parser;
+}
+
+iov_parser_t *iov_parser_create(size_t maxTxLen) {
+    const size_t size = iov_parser_size(maxTxLen);
+    void *mem = malloc(size);
+
+    iov_parser_t *parser = iov_parser_init(mem, size, maxTxLen);
+    if (parser == NULL) {
+        free(mem);
+    }
+    return parser;
+}
+
+void iov_parser_destroy(iov_parser_t *parser) {
+    free(parser);
+}
+
+int iov_parser_parse(iov_parser_t *parser, const uint8_t *data, size_t dataLen) {
+    if (parser == NULL) {
+        return parser_init_context_empty;
+    }
+
+    MEMZERO(&parser->ctx, sizeof(parser->ctx));
+    if (dataLen > parser->dataMaxLen) {
+        parser->err = parser_context_unexpected_size;
+        return parser->err;
+    }
+    if (dataLen > 0) {
+        MEMCPY(parser->data, data, dataLen);
+    }
+
+    parser->err = parser_parse(&parser->ctx, parser->data, (parser_size_t) dataLen, &parser->tx);
+    if (parser->err == parser_ok) {
+        parser->err = parser_validate(&parser->ctx, IOV_PARSER_IS_MAINNET);
+    }
+    return parser->err;
+}
+
+int iov_parser_error(const iov_parser_t *parser) {
+    return parser->err;
+}
+
+size_t iov_parser_error_offset(const iov_parser_t *parser) {
+    if (parser->ctx.buffer == NULL) {
+        return 0;
+    }
+    return parser_getErrorOffset(&parser->ctx);
+}
+
+const char *iov_parser_error_description(int err) {
+    return parser_getErrorDescription((parser_error_t) err);
+}
+
+int iov_parser_num_items(const iov_parser_t *parser) {
+    if (parser->err != parser_ok) {
+        return 0;
+    }
+    return parser_getNumItems(&parser->ctx);
+}
+
+int iov_parser_get_item(const iov_parser_t *parser,
+                        uint8_t displayIdx, uint8_t pageIdx,
+                        char *outKey, uint16_t outKeyLen,
+                        char *outValue, uint16_t outValueLen,
+                        uint8_t *pageCount) {
+    *pageCount = 0;
+    if (outKeyLen == 0 || outValueLen == 0) {
+        return parser_unexepected_error;
+    }
+    outKey[0] = 0;
+    outValue[0] = 0;
+
+    if (parser->err != parser_ok) {
+        return parser->err;
+    }
+    // The parser takes a signed index: larger ones are rejected here, before the cast
+    if (displayIdx > INT8_MAX || displayIdx >= parser_getNumItems(&parser->ctx)) {
+        return parser_display_idx_out_of_range;
+    }
+
+    // The parser formats into the scratch buffer of the handle
+    const parser_error_t err = parser_getItem(&parser->ctx, (int8_t) displayIdx,
+                                              outKey, outKeyLen,
+                                              outValue, outValueLen,
+                                              pageIdx, pageCount);
+
+    // Same key decoration as tx_getItem
+    if (err == parser_ok && *pageCount > 1) {
+        const size_t keyLen = strlen(outKey);
+        if (keyLen < outKeyLen) {
+            snprintf(outKey + keyLen, outKeyLen - keyLen, " [%d/%d]", pageIdx + 1, *pageCount);
+        }
+    }
+
+    return err;
+}
+
+#endif
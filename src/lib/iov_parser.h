@@ -0,0 +1,85 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Stable C ABI of libiovparser, for host services that need to preview transactions
+// exactly as the device shows them. Built from the same sources as the firmware.
+//
+// A parser handle has no hidden global state and never allocates after it has been
+// created, so several handles can be used concurrently from different threads.
+// Error codes are the values of parser_error_t.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define IOV_PARSER_API __declspec(dllexport)
+#else
+#define IOV_PARSER_API __attribute__((visibility("default")))
+#endif
+
+// Incremented on any incompatible change of this header
+#define IOV_PARSER_ABI_VERSION      1
+
+// Value length that gives the same pagination as the Nano S (two 18 char lines)
+#define IOV_PARSER_VALUE_LEN_NANOS  37
+
+typedef struct iov_parser_t iov_parser_t;
+
+IOV_PARSER_API uint32_t iov_parser_abi_version(void);
+
+/// Memory required by a handle that accepts transactions of up to maxTxLen bytes
+IOV_PARSER_API size_t iov_parser_size(size_t maxTxLen);
+
+/// Creates a handle in caller provided memory. Returns NULL if memLen < iov_parser_size(maxTxLen)
+IOV_PARSER_API iov_parser_t *iov_parser_init(void *mem, size_t memLen, size_t maxTxLen);
+
+/// Allocates and creates a handle. This is the only allocation done by the library
+IOV_PARSER_API iov_parser_t *iov_parser_create(size_t maxTxLen);
+
+/// Releases a handle returned by iov_parser_create
+IOV_PARSER_API void iov_parser_destroy(iov_parser_t *parser);
+
+/// Parses and validates a transaction, as the device does before showing it.
+/// data is copied, so it can be released as soon as the call returns
+IOV_PARSER_API int iov_parser_parse(iov_parser_t *parser, const uint8_t *data, size_t dataLen);
+
+/// Error of the last iov_parser_parse call
+IOV_PARSER_API int iov_parser_error(const iov_parser_t *parser);
+
+/// Byte offset in the transaction where the last iov_parser_parse call stopped
+IOV_PARSER_API size_t iov_parser_error_offset(const iov_parser_t *parser);
+
+IOV_PARSER_API const char *iov_parser_error_description(int err);
+
+/// Number of display items of the parsed transaction. 0 if the last parse failed
+IOV_PARSER_API int iov_parser_num_items(const iov_parser_t *parser);
+
+/// Writes key and value of one page of a display item as null terminated strings.
+/// outValueLen sets the page size. Keys of items with several pages get a " [i/n]" suffix
+IOV_PARSER_API int iov_parser_get_item(const iov_parser_t *parser,
+                                       uint8_t displayIdx, uint8_t pageIdx,
+                                       char *outKey, uint16_t outKeyLen,
+                                       char *outValue, uint16_t outValueLen,
+                                       uint8_t *pageCount);
+
+#ifdef __cplusplus
+}
+#endif
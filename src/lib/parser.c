@@ -19,6 +19,7 @@
 #include "parser.h"
 #include "coin.h"
 #include "bignum.h"
+#include "trace.h"
 
 #if defined(TARGET_NANOX)
 // For some reason NanoX requires this function
@@ -27,6 +28,36 @@ void __assert_fail(const char * assertion, const char * file, unsigned int line,
 }
 #endif
 
+__Z_INLINE parser_error_t parser_getItem_Send(const parser_context_t *ctx,
+                                   int8_t displayIdx,
+                                   char *outKey, uint16_t outKeyLen,
+                                   char *outValue, uint16_t outValueLen,
+                                   uint8_t pageIdx, uint8_t *pageCount);
+
+__Z_INLINE parser_error_t parser_getItem_Vote(const parser_context_t *ctx,
+                                              int8_t displayIdx,
+                                              char *outKey, uint16_t outKeyLen,
+                                              char *outValue, uint16_t outValueLen,
+                                              uint8_t pageIdx, uint8_t *pageCount);
+
+__Z_INLINE parser_error_t parser_getItem_Update(const parser_context_t *ctx,
+                                              int8_t displayIdx,
+                                              char *outKey, uint16_t outKeyLen,
+                                              char *outValue, uint16_t outValueLen,
+                                              uint8_t pageIdx, uint8_t *pageCount);
+
+__Z_INLINE parser_error_t parser_getItem_Batch(const parser_context_t *ctx,
+                                               int8_t displayIdx,
+                                               char *outKey, uint16_t outKeyLen,
+                                               char *outValue, uint16_t outValueLen,
+                                               uint8_t pageIdx, uint8_t *pageCount);
+
+__Z_INLINE parser_error_t parser_getItem_Participant(const parser_context_t *ctx,
+                                          int8_t displayIdx,
+                                          char *outKey, uint16_t outKeyLen,
+                                          char *outValue, uint16_t outValueLen,
+                                          uint8_t pageIdx, uint8_t *pageCount);
+
 #ifdef MAINNET_ENABLED
 #define OFFSET 1
 #define FIELD_CHAINID -100
@@ -39,6 +70,8 @@ void __assert_fail(const char * assertion, const char * file, unsigned int line,
 #define FIELD_TOTAL_FIXCOUNT_VOTEMSG       (4 - OFFSET)
 #define FIELD_TOTAL_FIXCOUNT_UPDATEMSG     (5 - OFFSET)
 #define FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG 2
+#define FIELD_TOTAL_FIXCOUNT_BATCHMSG      (2 - OFFSET)
+#define FIELD_TOTAL_FIXCOUNT_BATCHSENDMSG  3
 
 #define FIELD_INVALID      (-100)
 
@@ -57,9 +90,18 @@ void __assert_fail(const char * assertion, const char * file, unsigned int line,
 #define FIELD_PARTICIPANT   (2 - OFFSET)
 #define FIELD_ACTIVATION_TH (3 - OFFSET)
 #define FIELD_ADMIN_TH      (4 - OFFSET)
+// Compact review: both thresholds and the total weight in a single item
+#define FIELD_WEIGHTS       (5 - OFFSET)
 //Fields for MsgParticipant
 #define FIELD_PARTICIPANT_ADDRESS 0
 #define FIELD_PARTICIPANT_WEIGHT  1
+//Fields for TxBatch (followed by one item per ticker total)
+#define FIELD_BATCH_TOTAL         (1 - OFFSET)
+//Fields for each SendMsg in a batch
+#define FIELD_BATCHSEND_SOURCE      0
+#define FIELD_BATCHSEND_DESTINATION 1
+#define FIELD_BATCHSEND_AMOUNT      2
+#define FIELD_BATCHSEND_MEMO        3
 
 // * optional chainid for testnet mode
 // 0  source
@@ -68,21 +110,44 @@ void __assert_fail(const char * assertion, const char * file, unsigned int line,
 // 3  fees  value / ticker
 // 4  memo                      (when exists)
 
-#define UI_BUFFER 256
+#define UI_buffer (ctx->tx_obj->uiBuffer)
+#define UI_BUFFER PARSER_UI_BUFFER_LEN
+
+#define IS_COMPACT(CTX) ((CTX)->reviewMode == parser_review_compact)
+
+__Z_INLINE uint8_t parser_participantItems(const parser_context_t *ctx) {
+    return IS_COMPACT(ctx) ? 1 : FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG;
+}
+
+__Z_INLINE uint8_t parser_multisigItems(const parser_context_t *ctx) {
+    if (IS_COMPACT(ctx)) {
+        // Packed in a single list
+        return ctx->tx_obj->multisig.count > 0 ? 1 : 0;
+    }
+    return ctx->tx_obj->multisig.count;
+}
 
 parser_error_t parser_parse(parser_context_t *ctx,
                             const uint8_t *data,
-                            uint16_t dataLen) {
-    parser_init(ctx, data, dataLen);
+                            parser_size_t dataLen,
+                            parser_tx_t *tx_obj) {
+    parser_init(ctx, data, dataLen, tx_obj);
     return parser_Tx(ctx);
 }
 
+parser_size_t parser_getErrorOffset(const parser_context_t *ctx) {
+    if (ctx->errorPtr != NULL) {
+        return ctx->errorPtr - ctx->buffer;
+    }
+    return ctx->offset;
+}
+
 parser_error_t parser_validate(const parser_context_t *ctx, bool_t isMainnet) {
-    if (isMainnet != parser_IsMainnet(parser_tx_obj.chainID, parser_tx_obj.chainIDLen)) {
+    if (isMainnet != parser_IsMainnet(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen)) {
         return parser_unexpected_chain;
     }
 
-    if (parser_tx_obj.sendmsg.memoLen > TX_MEMOLEN_MAX) {
+    if (ctx->tx_obj->msgType == Msg_Send && ctx->tx_obj->sendmsg.memoLen > TX_MEMOLEN_MAX) {
         return parser_unexpected_buffer_end;
     }
 
@@ -92,19 +157,31 @@ parser_error_t parser_validate(const parser_context_t *ctx, bool_t isMainnet) {
 uint8_t parser_getNumItems(const parser_context_t *ctx) {
 
     uint8_t fields = 0;
-    switch (parser_tx_obj.msgType) {
+    switch (ctx->tx_obj->msgType) {
         case Msg_Send:
             fields = FIELD_TOTAL_FIXCOUNT_SENDMSG;
-            if (parser_tx_obj.sendmsg.memoLen == 0)
+            if (ctx->tx_obj->sendmsg.memoLen == 0)
                 fields--;
-            fields += parser_tx_obj.multisig.count;
+            fields += parser_multisigItems(ctx);
             break;
         case Msg_Vote:
             fields = FIELD_TOTAL_FIXCOUNT_VOTEMSG;
             break;
         case Msg_Update:
             fields = FIELD_TOTAL_FIXCOUNT_UPDATEMSG - 1;
-            fields += parser_tx_obj.updatemsg.participantsCount * FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG;
+            fields += ctx->tx_obj->updatemsg.participantsCount * parser_participantItems(ctx);
+            if (IS_COMPACT(ctx)) {
+                // Thresholds are merged in FIELD_WEIGHTS
+                fields--;
+            }
+            break;
+        case Msg_Batch:
+            fields = FIELD_TOTAL_FIXCOUNT_BATCHMSG;
+            fields += ctx->tx_obj->batchmsg.totalsCount;
+            for (uint8_t i = 0; i < ctx->tx_obj->batchmsg.sendmsgCount; i++) {
+                fields += FIELD_TOTAL_FIXCOUNT_BATCHSENDMSG + ctx->tx_obj->batchmsg.sendmsg_array[i].hasMemo;
+            }
+            fields += parser_multisigItems(ctx);
             break;
         default:
             return fields;
@@ -112,12 +189,10 @@ uint8_t parser_getNumItems(const parser_context_t *ctx) {
     return fields;
 }
 
-uint8_t UI_buffer[UI_BUFFER];
-
 int8_t parser_mapDisplayIdx(const parser_context_t *ctx, int8_t displayIdx) {
-    switch (parser_tx_obj.msgType) {
+    switch (ctx->tx_obj->msgType) {
         case Msg_Update: {
-            const uint8_t numItems = parser_tx_obj.updatemsg.participantsCount * FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG;
+            const uint8_t numItems = ctx->tx_obj->updatemsg.participantsCount * parser_participantItems(ctx);
 
             if (displayIdx < FIELD_PARTICIPANT) {
                 return displayIdx;
@@ -127,6 +202,10 @@ int8_t parser_mapDisplayIdx(const parser_context_t *ctx, int8_t displayIdx) {
                 return FIELD_PARTICIPANT;
             }
 
+            if (IS_COMPACT(ctx)) {
+                return displayIdx == FIELD_PARTICIPANT + numItems ? FIELD_WEIGHTS : (uint8_t) FIELD_INVALID;
+            }
+
             if (displayIdx < FIELD_TOTAL_FIXCOUNT_UPDATEMSG + numItems) {
                 return displayIdx - numItems + 1;
             }
@@ -138,7 +217,7 @@ int8_t parser_mapDisplayIdx(const parser_context_t *ctx, int8_t displayIdx) {
                 return displayIdx;
             }
 
-            if (parser_tx_obj.sendmsg.memoLen == 0) {
+            if (ctx->tx_obj->sendmsg.memoLen == 0) {
                 // SKIP Memo Field
                 return displayIdx + 1;
             }
@@ -158,6 +237,7 @@ parser_error_t parser_getItem(const parser_context_t *ctx,
                               char *outKey, uint16_t outKeyLen,
                               char *outValue, uint16_t outValueLen,
                               uint8_t pageIdx, uint8_t *pageCount) {
+    TRACE_SCOPE("parser_getItem");
 
     snprintf(outKey, outKeyLen, "?");
     snprintf(outValue, outValueLen, "?");
@@ -166,7 +246,13 @@ parser_error_t parser_getItem(const parser_context_t *ctx,
 
     *pageCount = 1;
 
-    switch (parser_tx_obj.msgType) {
+    // The review asks for the item after the last one to know when to stop
+    if (displayIdx < 0 || displayIdx >= parser_getNumItems(ctx)) {
+        *pageCount = 0;
+        return parser_display_idx_out_of_range;
+    }
+
+    switch (ctx->tx_obj->msgType) {
         case Msg_Send:
             return parser_getItem_Send(ctx, displayIdx, outKey, outKeyLen,
                                        outValue, outValueLen, pageIdx, pageCount);
@@ -176,6 +262,9 @@ parser_error_t parser_getItem(const parser_context_t *ctx,
         case Msg_Update:
             return parser_getItem_Update(ctx, displayIdx, outKey, outKeyLen,
                                          outValue, outValueLen, pageIdx, pageCount);
+        case Msg_Batch:
+            return parser_getItem_Batch(ctx, displayIdx, outKey, outKeyLen,
+                                        outValue, outValueLen, pageIdx, pageCount);
         case Msg_Invalid:
             return parser_unexpected_type;
     }
@@ -188,36 +277,54 @@ __Z_INLINE parser_error_t parser_getItem_Participant(const parser_context_t *ctx
                                                      char *outValue, uint16_t outValueLen,
                                                      uint8_t pageIdx, uint8_t *pageCount) {
     *pageCount = 1;
-    if (parser_tx_obj.updatemsg.participantsCount == 0) {
+    if (ctx->tx_obj->updatemsg.participantsCount == 0) {
         return parser_no_data;
     }
 
     //Get on which participant index we are right now
-    const uint8_t participantIdx = (displayIdx - FIELD_PARTICIPANT) / FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG;
+    const uint8_t participantIdx = (displayIdx - FIELD_PARTICIPANT) / parser_participantItems(ctx);
     //Get Participants field index
-    const uint8_t fieldIdx = (displayIdx - FIELD_PARTICIPANT) % FIELD_TOTAL_FIXCOUNT_PARTICIPANTMSG;
+    const uint8_t fieldIdx = (displayIdx - FIELD_PARTICIPANT) % parser_participantItems(ctx);
 
-    if (participantIdx >= parser_tx_obj.updatemsg.participantsCount) {
+    if (participantIdx >= ctx->tx_obj->updatemsg.participantsCount) {
         return parser_unexpected_field;
     }
 
     //Parse Participant that corresponds to participantIdx
-    const parser_participant_t *p = &parser_tx_obj.updatemsg.participant_array[participantIdx];
+    const parser_participant_t *p = &ctx->tx_obj->updatemsg.participant_array[participantIdx];
+
+    if (IS_COMPACT(ctx)) {
+        // Address and weight in the same item
+        FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
+                                        (char *) UI_buffer, UI_BUFFER,
+                                        p->signaturePtr, p->signatureLen))
+        const size_t addrLen = strlen((char *) UI_buffer);
+        snprintf((char *) UI_buffer + addrLen, UI_BUFFER - addrLen, " weight ");
+        const size_t len = strlen((char *) UI_buffer);
+        int64_to_str((char *) UI_buffer + len, UI_BUFFER - len, p->weight);
+
+        snprintf(outKey, outKeyLen, "Participant [%d/%d]",
+                 participantIdx + 1, ctx->tx_obj->updatemsg.participantsCount);
+        // page it
+        return parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                    strlen((char *) UI_buffer), pageIdx, pageCount);
+    }
 
     switch (fieldIdx) {
         case FIELD_PARTICIPANT_ADDRESS: {
-            FAIL_ON_ERROR(parser_getAddress(parser_tx_obj.chainID, parser_tx_obj.chainIDLen,
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
                                             (char *) UI_buffer, UI_BUFFER,
                                             p->signaturePtr, p->signatureLen))
             // page it
             snprintf(outKey, outKeyLen, "Participant [%d/%d] Signature",
-                     participantIdx + 1, parser_tx_obj.updatemsg.participantsCount);
-            parser_arrayToString(outValue, outValueLen, UI_buffer, strlen((char *) UI_buffer), pageIdx, pageCount);
+                     participantIdx + 1, ctx->tx_obj->updatemsg.participantsCount);
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         }
         case FIELD_PARTICIPANT_WEIGHT:
             snprintf(outKey, outKeyLen, "Participant [%d/%d] Weight",
-                     participantIdx + 1, parser_tx_obj.updatemsg.participantsCount);
+                     participantIdx + 1, ctx->tx_obj->updatemsg.participantsCount);
             int64_to_str(outValue, outValueLen, p->weight);
             break;
         default:
@@ -227,6 +334,38 @@ __Z_INLINE parser_error_t parser_getItem_Participant(const parser_context_t *ctx
     return parser_ok;
 }
 
+__Z_INLINE parser_error_t parser_getItem_Multisig(const parser_context_t *ctx, uint8_t multisigIdx,
+                                                  char *outKey, uint16_t outKeyLen,
+                                                  char *outValue, uint16_t outValueLen,
+                                                  uint8_t pageIdx, uint8_t *pageCount) {
+    const parser_multisig_t *multisig = &ctx->tx_obj->multisig;
+    snprintf(outKey, outKeyLen, "Multisig");
+
+    if (IS_COMPACT(ctx)) {
+        // Comma separated list of every ID
+        char *list = (char *) UI_buffer;
+        for (uint8_t i = 0; i < multisig->count; i++) {
+            const size_t len = strlen(list);
+            snprintf(list + len, UI_BUFFER - len, "%s", i > 0 ? ", " : "");
+            const size_t sepLen = strlen(list);
+            uint64_to_str(list + sepLen, UI_BUFFER - sepLen, multisig->values[i]);
+        }
+        // page it
+        return parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                    strlen(list), pageIdx, pageCount);
+    }
+
+    if (multisigIdx >= multisig->count) {
+        return parser_display_idx_out_of_range;
+    }
+    if (multisig->count > 1) {
+        snprintf(outKey, outKeyLen, "Multisig [%d/%d]", multisigIdx + 1, multisig->count);
+    }
+    uint64_to_str(outValue, outValueLen, multisig->values[multisigIdx]);
+
+    return parser_ok;
+}
+
 parser_error_t
 parser_getItem_Send(const parser_context_t *ctx, int8_t displayIdx,
                     char *outKey, uint16_t outKeyLen,
@@ -237,66 +376,66 @@ parser_getItem_Send(const parser_context_t *ctx, int8_t displayIdx,
         case FIELD_CHAINID:     // ChainID
             snprintf(outKey, outKeyLen, "ChainID");
             FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen,
-                                               parser_tx_obj.chainID, parser_tx_obj.chainIDLen,
+                                               ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
                                                pageIdx, pageCount))
             break;
         case FIELD_SOURCE:     // Source
             snprintf(outKey, outKeyLen, "Source");
-            FAIL_ON_ERROR(parser_getAddress(parser_tx_obj.chainID, parser_tx_obj.chainIDLen,
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
                                             (char *) UI_buffer, UI_BUFFER,
-                                            parser_tx_obj.sendmsg.sourcePtr,
-                                            parser_tx_obj.sendmsg.sourceLen))
+                                            ctx->tx_obj->sendmsg.sourcePtr,
+                                            ctx->tx_obj->sendmsg.sourceLen))
             // page it
-            parser_arrayToString(outValue, outValueLen, UI_buffer,
-                                 strlen((char *) UI_buffer), pageIdx, pageCount);
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         case FIELD_DESTINATION:     // Destination
             snprintf(outKey, outKeyLen, "Dest");
-            FAIL_ON_ERROR(parser_getAddress(parser_tx_obj.chainID, parser_tx_obj.chainIDLen,
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
                                             (char *) UI_buffer, UI_BUFFER,
-                                            parser_tx_obj.sendmsg.destinationPtr,
-                                            parser_tx_obj.sendmsg.destinationLen))
+                                            ctx->tx_obj->sendmsg.destinationPtr,
+                                            ctx->tx_obj->sendmsg.destinationLen))
             // page it
-            parser_arrayToString(outValue, outValueLen, UI_buffer,
-                                 strlen((char *) UI_buffer), pageIdx, pageCount);
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         case FIELD_AMOUNT: {
             char ticker[IOV_TICKER_MAXLEN];
             FAIL_ON_ERROR(parser_arrayToString(ticker, IOV_TICKER_MAXLEN,
-                                               parser_tx_obj.sendmsg.amount.tickerPtr,
-                                               parser_tx_obj.sendmsg.amount.tickerLen,
+                                               ctx->tx_obj->sendmsg.amount.tickerPtr,
+                                               ctx->tx_obj->sendmsg.amount.tickerLen,
                                                0, NULL))
 
             snprintf(outKey, outKeyLen, "Amount [%s]", ticker);
             FAIL_ON_ERROR(parser_formatAmountFriendly(outValue,
                                                       outValueLen,
-                                                      &parser_tx_obj.sendmsg.amount))
+                                                      &ctx->tx_obj->sendmsg.amount))
             break;
         }
         case FIELD_FEE: {
             char ticker[IOV_TICKER_MAXLEN];
             FAIL_ON_ERROR(parser_arrayToString(ticker, IOV_TICKER_MAXLEN,
-                                               parser_tx_obj.fees.coin.tickerPtr,
-                                               parser_tx_obj.fees.coin.tickerLen,
+                                               ctx->tx_obj->fees.coin.tickerPtr,
+                                               ctx->tx_obj->fees.coin.tickerLen,
                                                0, NULL))
 
             snprintf(outKey, outKeyLen, "Fees [%s]", ticker);
             FAIL_ON_ERROR(parser_formatAmountFriendly(outValue,
                                                       outValueLen,
-                                                      &parser_tx_obj.fees.coin))
+                                                      &ctx->tx_obj->fees.coin))
             break;
         }
         case FIELD_MEMO: {     // Memo
             snprintf(outKey, outKeyLen, "Memo");
             FAIL_ON_ERROR(parser_arrayToString((char *) UI_buffer, UI_BUFFER,
-                                               parser_tx_obj.sendmsg.memoPtr,
-                                               parser_tx_obj.sendmsg.memoLen,
+                                               ctx->tx_obj->sendmsg.memoPtr,
+                                               ctx->tx_obj->sendmsg.memoLen,
                                                0, NULL))
             asciify((char *) UI_buffer);
             // page it
-            parser_arrayToString(outValue, outValueLen, UI_buffer,
-                                 strlen((char *) UI_buffer),
-                                 pageIdx, pageCount);
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer),
+                                               pageIdx, pageCount))
             break;
         }
         default: {
@@ -306,14 +445,12 @@ parser_getItem_Send(const parser_context_t *ctx, int8_t displayIdx,
                 return parser_no_data;
             }
 
-            // Map variable field to multisig
-            uint8_t multisigIdx = displayIdx - FIELD_TOTAL_FIXCOUNT_SENDMSG;
-            snprintf(outKey, outKeyLen, "Multisig");
-            if (parser_tx_obj.multisig.count > 1) {
-                snprintf(outKey, outKeyLen, "Multisig [%d/%d]", multisigIdx + 1, parser_tx_obj.multisig.count);
-            }
-
-            uint64_to_str(outValue, outValueLen, parser_tx_obj.multisig.values[multisigIdx]);
+            // Map variable field to multisig. The mapped index also accounts for a missing memo
+            const uint8_t multisigIdx = parser_mapDisplayIdx(ctx, displayIdx) - FIELD_TOTAL_FIXCOUNT_SENDMSG;
+            return parser_getItem_Multisig(ctx, multisigIdx,
+                                           outKey, outKeyLen,
+                                           outValue, outValueLen,
+                                           pageIdx, pageCount);
         }
     }
     return parser_ok;
@@ -329,35 +466,38 @@ __Z_INLINE parser_error_t parser_getItem_Vote(const parser_context_t *ctx, int8_
         case FIELD_CHAINID:     // ChainID
             snprintf(outKey, outKeyLen, "ChainID");
             FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen,
-                                               parser_tx_obj.chainID,
-                                               parser_tx_obj.chainIDLen,
+                                               ctx->tx_obj->chainID,
+                                               ctx->tx_obj->chainIDLen,
                                                pageIdx, pageCount))
             break;
         case FIELD_VOTER: {     // Voter
             snprintf(outKey, outKeyLen, "Voter");
-            FAIL_ON_ERROR(parser_getAddress(parser_tx_obj.chainID, parser_tx_obj.chainIDLen,
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
                                             (char *) UI_buffer, UI_BUFFER,
-                                            parser_tx_obj.votemsg.voterPtr,
-                                            parser_tx_obj.votemsg.voterLen))
+                                            ctx->tx_obj->votemsg.voterPtr,
+                                            ctx->tx_obj->votemsg.voterLen))
             // page it
-            parser_arrayToString(outValue, outValueLen, UI_buffer,
-                                 strlen((char *) UI_buffer), pageIdx, pageCount);
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         }
         case FIELD_PROPOSAL_ID: { //Proposal Id
             snprintf(outKey, outKeyLen, "ProposalId");
-            uint8_t bcdOut[20]; //Must be  at most outValueLen/2
+            uint8_t bcdOut[20];
             uint16_t bcdOutLen = sizeof(bcdOut);
-            bignumBigEndian_to_bcd(bcdOut, bcdOutLen, parser_tx_obj.votemsg.proposalIdPtr,
-                                   parser_tx_obj.votemsg.proposalIdLen);
-            if (!bignumBigEndian_bcdprint(outValue, outValueLen, bcdOut, bcdOutLen)) {
+            bignumBigEndian_to_bcd(bcdOut, bcdOutLen, ctx->tx_obj->votemsg.proposalIdPtr,
+                                   ctx->tx_obj->votemsg.proposalIdLen);
+            // Printed in the scratch buffer: the Nano S value line is shorter than the BCD digits
+            if (!bignumBigEndian_bcdprint((char *) UI_buffer, UI_BUFFER, bcdOut, bcdOutLen)) {
                 return parser_unexpected_buffer_end;
             }
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         }
         case FIELD_SELECTION: { // Vote option
             const char *sel;
-            switch (parser_tx_obj.votemsg.voteOption) {
+            switch (ctx->tx_obj->votemsg.voteOption) {
                 case VOTE_OPTION_YES:
                     sel = VOTE_OPTION_YES_STR;
                     break;
@@ -395,19 +535,21 @@ __Z_INLINE parser_error_t parser_getItem_Update(const parser_context_t *ctx, int
         case FIELD_CHAINID:     // ChainID
             snprintf(outKey, outKeyLen, "ChainID");
             return parser_arrayToString(outValue, outValueLen,
-                                        parser_tx_obj.chainID,
-                                        parser_tx_obj.chainIDLen,
+                                        ctx->tx_obj->chainID,
+                                        ctx->tx_obj->chainIDLen,
                                         pageIdx, pageCount);
         case FIELD_CONTRACT_ID: { //Contract Id
             snprintf(outKey, outKeyLen, "ContractId");
-            uint8_t bcdOut[20]; //Must be  at most outValueLen/2
+            uint8_t bcdOut[20];
             const uint16_t bcdOutLen = sizeof(bcdOut);
             bignumBigEndian_to_bcd(bcdOut, bcdOutLen,
-                                   parser_tx_obj.updatemsg.contractIdPtr,
-                                   parser_tx_obj.updatemsg.contractIdLen);
-            if (!bignumBigEndian_bcdprint(outValue, outValueLen, bcdOut, bcdOutLen)) {
+                                   ctx->tx_obj->updatemsg.contractIdPtr,
+                                   ctx->tx_obj->updatemsg.contractIdLen);
+            if (!bignumBigEndian_bcdprint((char *) UI_buffer, UI_BUFFER, bcdOut, bcdOutLen)) {
                 return parser_unexpected_buffer_end;
             }
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
             break;
         }
         case FIELD_PARTICIPANT:   //Participant
@@ -417,15 +559,159 @@ __Z_INLINE parser_error_t parser_getItem_Update(const parser_context_t *ctx, int
                                               pageIdx, pageCount);
         case FIELD_ACTIVATION_TH:
             snprintf(outKey, outKeyLen, "ActivationTh");
-            int64_to_str(outValue, outValueLen, parser_tx_obj.updatemsg.activation_th);
+            int64_to_str(outValue, outValueLen, ctx->tx_obj->updatemsg.activation_th);
             break;
         case FIELD_ADMIN_TH:
             snprintf(outKey, outKeyLen, "AdminTh");
-            int64_to_str(outValue, outValueLen, parser_tx_obj.updatemsg.admin_th);
+            int64_to_str(outValue, outValueLen, ctx->tx_obj->updatemsg.admin_th);
             break;
+        case FIELD_WEIGHTS: {
+            // Total weight of the participants against both thresholds
+            uint64_t total = 0;
+            for (uint8_t i = 0; i < ctx->tx_obj->updatemsg.participantsCount; i++) {
+                total += ctx->tx_obj->updatemsg.participant_array[i].weight;
+            }
+            char totalStr[21], activationStr[11], adminStr[11];
+            uint64_to_str(totalStr, sizeof(totalStr), total);
+            int64_to_str(activationStr, sizeof(activationStr), ctx->tx_obj->updatemsg.activation_th);
+            int64_to_str(adminStr, sizeof(adminStr), ctx->tx_obj->updatemsg.admin_th);
+
+            snprintf(outKey, outKeyLen, "Weights");
+            snprintf((char *) UI_buffer, UI_BUFFER, "Total %s Activation %s Admin %s",
+                     totalStr, activationStr, adminStr);
+            // page it
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
+            break;
+        }
         default:
             return parser_unexepected_error;
     }
 
     return parser_ok;
 }
+
+__Z_INLINE parser_error_t parser_getItem_BatchSend(const parser_context_t *ctx, uint8_t sendIdx, uint8_t fieldIdx,
+                                                   char *outKey, uint16_t outKeyLen,
+                                                   char *outValue, uint16_t outValueLen,
+                                                   uint8_t pageIdx, uint8_t *pageCount) {
+    const uint8_t sendCount = ctx->tx_obj->batchmsg.sendmsgCount;
+
+    // Messages are not kept in memory. Parse it again
+    parser_sendmsg_t sendmsg;
+    FAIL_ON_ERROR(parser_readBatchSendMsg(&ctx->tx_obj->batchmsg, sendIdx, &sendmsg))
+
+    switch (fieldIdx) {
+        case FIELD_BATCHSEND_SOURCE:
+            snprintf(outKey, outKeyLen, "Send [%d/%d] Source", sendIdx + 1, sendCount);
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
+                                            (char *) UI_buffer, UI_BUFFER,
+                                            sendmsg.sourcePtr, sendmsg.sourceLen))
+            // page it
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
+            break;
+        case FIELD_BATCHSEND_DESTINATION:
+            snprintf(outKey, outKeyLen, "Send [%d/%d] Dest", sendIdx + 1, sendCount);
+            FAIL_ON_ERROR(parser_getAddress(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
+                                            (char *) UI_buffer, UI_BUFFER,
+                                            sendmsg.destinationPtr, sendmsg.destinationLen))
+            // page it
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer), pageIdx, pageCount))
+            break;
+        case FIELD_BATCHSEND_AMOUNT: {
+            char ticker[IOV_TICKER_MAXLEN];
+            FAIL_ON_ERROR(parser_arrayToString(ticker, IOV_TICKER_MAXLEN,
+                                               sendmsg.amount.tickerPtr,
+                                               sendmsg.amount.tickerLen,
+                                               0, NULL))
+
+            snprintf(outKey, outKeyLen, "Send [%d/%d] [%s]", sendIdx + 1, sendCount, ticker);
+            FAIL_ON_ERROR(parser_formatAmountFriendly(outValue, outValueLen, &sendmsg.amount))
+            break;
+        }
+        case FIELD_BATCHSEND_MEMO:
+            snprintf(outKey, outKeyLen, "Send [%d/%d] Memo", sendIdx + 1, sendCount);
+            FAIL_ON_ERROR(parser_arrayToString((char *) UI_buffer, UI_BUFFER,
+                                               sendmsg.memoPtr, sendmsg.memoLen,
+                                               0, NULL))
+            asciify((char *) UI_buffer);
+            // page it
+            FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                               strlen((char *) UI_buffer),
+                                               pageIdx, pageCount))
+            break;
+        default:
+            return parser_unexpected_field;
+    }
+
+    return parser_ok;
+}
+
+__Z_INLINE parser_error_t parser_getItem_Batch(const parser_context_t *ctx, int8_t displayIdx,
+                                               char *outKey, uint16_t outKeyLen,
+                                               char *outValue, uint16_t outValueLen,
+                                               uint8_t pageIdx, uint8_t *pageCount) {
+    const parser_batchmsg_t *batchmsg = &ctx->tx_obj->batchmsg;
+
+    if (displayIdx == FIELD_CHAINID) {
+        snprintf(outKey, outKeyLen, "ChainID");
+        return parser_arrayToString(outValue, outValueLen,
+                                    ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen,
+                                    pageIdx, pageCount);
+    }
+
+    // Totals by ticker
+    int16_t idx = displayIdx - FIELD_BATCH_TOTAL;
+    if (idx < batchmsg->totalsCount) {
+        const parser_cointotal_t *t = &batchmsg->totals_array[idx];
+
+        char ticker[IOV_TICKER_MAXLEN];
+        FAIL_ON_ERROR(parser_arrayToString(ticker, IOV_TICKER_MAXLEN,
+                                           t->tickerPtr, t->tickerLen,
+                                           0, NULL))
+
+        snprintf(outKey, outKeyLen, "Total [%s]", ticker);
+        FAIL_ON_ERROR(parser_formatAmountTotal((char *) UI_buffer, UI_BUFFER, &t->total))
+        // page it
+        FAIL_ON_ERROR(parser_arrayToString(outValue, outValueLen, UI_buffer,
+                                           strlen((char *) UI_buffer), pageIdx, pageCount))
+        return parser_ok;
+    }
+    idx -= batchmsg->totalsCount;
+
+    // Fees
+    if (idx == 0) {
+        char ticker[IOV_TICKER_MAXLEN];
+        FAIL_ON_ERROR(parser_arrayToString(ticker, IOV_TICKER_MAXLEN,
+                                           ctx->tx_obj->fees.coin.tickerPtr,
+                                           ctx->tx_obj->fees.coin.tickerLen,
+                                           0, NULL))
+
+        snprintf(outKey, outKeyLen, "Fees [%s]", ticker);
+        FAIL_ON_ERROR(parser_formatAmountFriendly(outValue,
+                                                  outValueLen,
+                                                  &ctx->tx_obj->fees.coin))
+        return parser_ok;
+    }
+    idx--;
+
+    // Each SendMsg (memo is only shown when present)
+    for (uint8_t i = 0; i < batchmsg->sendmsgCount; i++) {
+        const uint8_t sendItems = FIELD_TOTAL_FIXCOUNT_BATCHSENDMSG + batchmsg->sendmsg_array[i].hasMemo;
+        if (idx < sendItems) {
+            return parser_getItem_BatchSend(ctx, i, idx,
+                                            outKey, outKeyLen,
+                                            outValue, outValueLen,
+                                            pageIdx, pageCount);
+        }
+        idx -= sendItems;
+    }
+
+    // Map variable field to multisig
+    return parser_getItem_Multisig(ctx, idx,
+                                   outKey, outKeyLen,
+                                   outValue, outValueLen,
+                                   pageIdx, pageCount);
+}
@@ -25,10 +25,14 @@ extern "C" {
 
 const char *parser_getErrorDescription(parser_error_t err);
 
-//// parses a tx buffer
+//// parses a tx buffer into tx_obj. data and tx_obj must outlive ctx
 parser_error_t parser_parse(parser_context_t *ctx,
                             const uint8_t *data,
-                            uint16_t dataLen);
+                            parser_size_t dataLen,
+                            parser_tx_t *tx_obj);
+
+//// byte offset in data where the last parser_parse call stopped
+parser_size_t parser_getErrorOffset(const parser_context_t *ctx);
 
 //// verifies tx fields
 parser_error_t parser_validate(const parser_context_t *ctx, bool_t isMainnet);
@@ -43,30 +47,6 @@ parser_error_t parser_getItem(const parser_context_t *ctx,
                               char *outValue, uint16_t outValueLen,
                               uint8_t pageIdx, uint8_t *pageCount);
 
-__Z_INLINE parser_error_t parser_getItem_Send(const parser_context_t *ctx,
-                                   int8_t displayIdx,
-                                   char *outKey, uint16_t outKeyLen,
-                                   char *outValue, uint16_t outValueLen,
-                                   uint8_t pageIdx, uint8_t *pageCount);
-
-__Z_INLINE parser_error_t parser_getItem_Vote(const parser_context_t *ctx,
-                                              int8_t displayIdx,
-                                              char *outKey, uint16_t outKeyLen,
-                                              char *outValue, uint16_t outValueLen,
-                                              uint8_t pageIdx, uint8_t *pageCount);
-
-__Z_INLINE parser_error_t parser_getItem_Update(const parser_context_t *ctx,
-                                              int8_t displayIdx,
-                                              char *outKey, uint16_t outKeyLen,
-                                              char *outValue, uint16_t outValueLen,
-                                              uint8_t pageIdx, uint8_t *pageCount);
-
-__Z_INLINE parser_error_t parser_getItem_Participant(const parser_context_t *ctx,
-                                          int8_t displayIdx,
-                                          char *outKey, uint16_t outKeyLen,
-                                          char *outValue, uint16_t outValueLen,
-                                          uint8_t pageIdx, uint8_t *pageCount);
-
 #ifdef __cplusplus
 }
 #endif
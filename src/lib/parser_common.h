@@ -58,11 +58,38 @@ typedef enum {
     parser_required_method,
 } parser_error_t;
 
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX)
+typedef uint16_t parser_size_t;
+#define PARSER_SIZE_MAX UINT16_MAX
+#else
+// Host builds are not limited by the device buffers
+typedef uint32_t parser_size_t;
+#define PARSER_SIZE_MAX UINT32_MAX
+#endif
+
+typedef struct parser_tx_t parser_tx_t;
+
+typedef enum {
+    // One display item per field
+    parser_review_full = 0,
+    // Participants on one item each, multisig IDs in a single list and thresholds in a summary
+    parser_review_compact = 1,
+} parser_review_mode_e;
+
 typedef struct {
     const uint8_t *buffer;
-    uint16_t bufferLen;
-    uint16_t offset;
-    uint16_t lastConsumed;
+    parser_size_t bufferLen;
+    parser_size_t offset;
+    parser_size_t lastConsumed;
+
+    // Where a nested message failed. NULL when the error happened in this buffer
+    const uint8_t *errorPtr;
+
+    // Parsed transaction. Owned by the caller, only set in the root context
+    parser_tx_t *tx_obj;
+
+    // parser_review_mode_e. Selects how display items are laid out, set after parsing
+    uint8_t reviewMode;
 } parser_context_t;
 
 #ifdef __cplusplus
@@ -18,25 +18,44 @@
 #include "parser_impl.h"
 #include "parser_txdef.h"
 #include <bech32.h>
+#include <bignum.h>
 #include "coin.h"
+#include "trace.h"
 
-parser_tx_t parser_tx_obj;
+// A 128-bit value has at most 39 decimal digits
+#define IOV_TOTAL_DIGITS 40
 
 #define CHECK_NOT_DUPLICATED(FIELD) if (FIELD) return parser_duplicated_field; else FIELD = 1;
 
 #define WITH_CONTEXT(PTR, LEN, CALL) { \
     parser_context_t __tmpctx; \
     parser_error_t __err = parser_init_context(&__tmpctx, PTR, LEN); \
-    if ( __err != parser_no_data) FAIL_ON_ERROR(CALL) }
+    if ( __err != parser_no_data) FAIL_ON_ERROR_IN(&__tmpctx, CALL) }
+
+// Same as FAIL_ON_ERROR, keeping track of the failing position inside a nested context
+#define FAIL_ON_ERROR_IN(SUBCTX, CALL) { \
+    parser_error_t __suberr = CALL; \
+    if (__suberr != parser_ok) { ctx->errorPtr = _errorPtr(SUBCTX); return __suberr; } }
 
 #define READ_NONNEGATIVE_INT64(FIELD) err = _readNonNegativeInt64(ctx, &FIELD); if (err!=parser_ok) return err;
 #define READ_UINT32(FIELD) FAIL_ON_ERROR(_readUInt32(ctx, &FIELD))
 #define READ_UINT8(FIELD) FAIL_ON_ERROR(_readUInt8(ctx, &FIELD))
 #define READ_ARRAY(FIELD) FAIL_ON_ERROR(_readArray(ctx, &FIELD##Ptr, &FIELD##Len))
 
-parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer, uint16_t bufferSize) {
+// Position of the byte that failed to parse, following nested contexts
+__Z_INLINE const uint8_t *_errorPtr(const parser_context_t *ctx) {
+    if (ctx->errorPtr != NULL) {
+        return ctx->errorPtr;
+    }
+    return ctx->buffer + ctx->offset;
+}
+
+parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer, parser_size_t bufferSize) {
     ctx->offset = 0;
     ctx->lastConsumed = 0;
+    ctx->errorPtr = NULL;
+    ctx->tx_obj = NULL;
+    ctx->reviewMode = parser_review_full;
 
     if (bufferSize == 0 || buffer == NULL) {
         // Not available, use defaults
@@ -51,10 +70,14 @@ parser_error_t parser_init_context(parser_context_t *ctx, const uint8_t *buffer,
     return parser_ok;
 }
 
-parser_error_t parser_init(parser_context_t *ctx, const uint8_t *buffer, uint16_t bufferSize) {
-    FAIL_ON_ERROR(parser_init_context(ctx, buffer, bufferSize))
+parser_error_t parser_init(parser_context_t *ctx,
+                           const uint8_t *buffer, parser_size_t bufferSize,
+                           parser_tx_t *tx_obj) {
+    const parser_error_t err = parser_init_context(ctx, buffer, bufferSize);
+    ctx->tx_obj = tx_obj;
+    FAIL_ON_ERROR(err)
 
-    parser_txInit(&parser_tx_obj);
+    parser_txInit(tx_obj);
 
     return parser_ok;
 }
@@ -82,14 +105,18 @@ const char *parser_getErrorDescription(parser_error_t err) {
             return "Unexpected chain";
         case parser_unexpected_field_length:
             return "Unexpected field length";
+        case parser_unexpected_number_items:
+            return "Unexpected number of items";
+        case parser_value_out_of_range:
+            return "Value out of range";
         default:
             return "Unrecognized error code";
     }
 }
 
 parser_error_t _readRawVarint(parser_context_t *ctx, uint64_t *value) {
-    uint16_t offset = ctx->offset + ctx->lastConsumed;
-    uint16_t consumed = 0;
+    parser_size_t offset = ctx->offset + ctx->lastConsumed;
+    parser_size_t consumed = 0;
 
     const uint8_t *p = ctx->buffer + offset;
     const uint8_t *end = ctx->buffer + ctx->bufferLen + 1;
@@ -185,7 +212,7 @@ parser_error_t _readUInt8(parser_context_t *ctx, uint8_t *value) {
     return parser_ok;
 }
 
-parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, uint16_t *arrayLength) {
+parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, parser_size_t *arrayLength) {
     ctx->lastConsumed = 0;
 
     // First retrieve array type and confirm
@@ -203,7 +230,7 @@ parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, uint1
     // Now get number of bytes
     uint64_t tmpValue;
     err = _readRawVarint(ctx, &tmpValue);
-    if (tmpValue >= (uint64_t) UINT16_MAX) {
+    if (tmpValue >= (uint64_t) PARSER_SIZE_MAX) {
         err = parser_value_out_of_range;
     }
     if (err != parser_ok) {
@@ -213,7 +240,8 @@ parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, uint1
     *arrayLength = tmpValue;
 
     // check that the returned buffer is not out of bounds
-    if (ctx->offset + ctx->lastConsumed + *arrayLength > ctx->bufferLen) {
+    const parser_size_t arrayStart = ctx->offset + ctx->lastConsumed;
+    if (arrayStart > ctx->bufferLen || *arrayLength > ctx->bufferLen - arrayStart) {
         ctx->lastConsumed = 0;
         return parser_unexpected_buffer_end;
     }
@@ -227,8 +255,8 @@ parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, uint1
     return parser_ok;
 }
 
-parser_error_t _checkValidReadableChars(const uint8_t *p, uint16_t len) {
-    for (uint16_t i = 0; i < len; i++) {
+parser_error_t _checkValidReadableChars(const uint8_t *p, parser_size_t len) {
+    for (parser_size_t i = 0; i < len; i++) {
         uint8_t tmp = *(p + i);
         if (tmp < 33 || tmp > 127) {
             return parser_unexpected_characters;
@@ -237,8 +265,8 @@ parser_error_t _checkValidReadableChars(const uint8_t *p, uint16_t len) {
     return parser_ok;
 }
 
-parser_error_t _checkUppercaseLetters(const uint8_t *p, uint16_t len) {
-    for (uint16_t i = 0; i < len; i++) {
+parser_error_t _checkUppercaseLetters(const uint8_t *p, parser_size_t len) {
+    for (parser_size_t i = 0; i < len; i++) {
         uint8_t tmp = *(p + i);
         if (tmp < 'A' || tmp > 'Z') {
             return parser_unexpected_characters;
@@ -247,8 +275,8 @@ parser_error_t _checkUppercaseLetters(const uint8_t *p, uint16_t len) {
     return parser_ok;
 }
 
-parser_error_t _checkChainIDValid(const uint8_t *p, uint16_t len) {
-    for (uint16_t i = 0; i < len; i++) {
+parser_error_t _checkChainIDValid(const uint8_t *p, parser_size_t len) {
+    for (parser_size_t i = 0; i < len; i++) {
         uint8_t tmp = *(p + i);
 
 //        [a-zA-Z0-9_.-]
@@ -265,6 +293,7 @@ parser_error_t _checkChainIDValid(const uint8_t *p, uint16_t len) {
 }
 
 parser_error_t parser_readPB_Metadata(parser_context_t *ctx, parser_metadata_t *metadata) {
+    TRACE_SCOPE("parser_readPB_Metadata");
 
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
@@ -286,6 +315,7 @@ parser_error_t parser_readPB_Metadata(parser_context_t *ctx, parser_metadata_t *
 }
 
 parser_error_t parser_readPB_Coin(parser_context_t *ctx, parser_coin_t *coin) {
+    TRACE_SCOPE("parser_readPB_Coin");
     parser_error_t err;
     uint64_t v;
 
@@ -317,7 +347,7 @@ parser_error_t parser_readPB_Coin(parser_context_t *ctx, parser_coin_t *coin) {
     // Validation
     if (coin->whole < 0)
         return parser_value_out_of_range;
-    if (coin->fractional < 0)
+    if (coin->fractional < 0 || coin->fractional >= IOV_FRAC_UNIT)
         return parser_value_out_of_range;
     if (coin->tickerLen < 3 || coin->tickerLen > 4)
         return parser_value_out_of_range;
@@ -328,6 +358,7 @@ parser_error_t parser_readPB_Coin(parser_context_t *ctx, parser_coin_t *coin) {
 }
 
 parser_error_t parser_readPB_Fees(parser_context_t *ctx, parser_fees_t *fees) {
+    TRACE_SCOPE("parser_readPB_Fees");
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
         FAIL_ON_ERROR( _readRawVarint(ctx, &v))
@@ -356,6 +387,7 @@ parser_error_t parser_readPB_Fees(parser_context_t *ctx, parser_fees_t *fees) {
 }
 
 parser_error_t parser_readPB_Multisig(parser_context_t *ctx, parser_multisig_t *m) {
+    TRACE_SCOPE("parser_readPB_Multisig");
     union {
         uint64_t v;
         uint8_t bytes[8];
@@ -366,7 +398,7 @@ parser_error_t parser_readPB_Multisig(parser_context_t *ctx, parser_multisig_t *
     }
 
     const uint8_t *p;
-    uint16_t pLen;
+    parser_size_t pLen;
     FAIL_ON_ERROR( _readArray(ctx, &p, &pLen))
 
     if (pLen != 8) {
@@ -381,6 +413,7 @@ parser_error_t parser_readPB_Multisig(parser_context_t *ctx, parser_multisig_t *
 }
 
 parser_error_t parser_readPB_SendMsg(parser_context_t *ctx, parser_sendmsg_t *sendmsg) {
+    TRACE_SCOPE("parser_readPB_SendMsg");
 
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
@@ -434,6 +467,7 @@ parser_error_t parser_readPB_SendMsg(parser_context_t *ctx, parser_sendmsg_t *se
 }
 
 parser_error_t parser_readPB_VoteMsg(parser_context_t *ctx, parser_votemsg_t *votemsg) {
+    TRACE_SCOPE("parser_readPB_VoteMsg");
 
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
@@ -473,6 +507,7 @@ parser_error_t parser_readPB_VoteMsg(parser_context_t *ctx, parser_votemsg_t *vo
 }
 
 parser_error_t parser_readPB_UpdateMultisigMsg(parser_context_t *ctx, parser_updatemultisigmsg_t *updatemultisigmsg) {
+    TRACE_SCOPE("parser_readPB_UpdateMultisigMsg");
 
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
@@ -498,10 +533,14 @@ parser_error_t parser_readPB_UpdateMultisigMsg(parser_context_t *ctx, parser_upd
                 FAIL_ON_ERROR(_readArray(ctx, &local_ctx.buffer, &local_ctx.bufferLen))
                 local_ctx.offset = 0;
                 local_ctx.lastConsumed = 0;
+                local_ctx.errorPtr = NULL;
+                local_ctx.tx_obj = NULL;
 
-                FAIL_ON_ERROR(parser_readPB_Participant(
-                        &local_ctx,
-                        &updatemultisigmsg->participant_array[updatemultisigmsg->participantsCount]))
+                parser_participant_t *participant =
+                        &updatemultisigmsg->participant_array[updatemultisigmsg->participantsCount];
+                parser_ParticipantmsgInit(participant);
+
+                FAIL_ON_ERROR_IN(&local_ctx, parser_readPB_Participant(&local_ctx, participant))
 
                 updatemultisigmsg->participantsCount++;
                 break;
@@ -529,6 +568,7 @@ parser_error_t parser_readPB_UpdateMultisigMsg(parser_context_t *ctx, parser_upd
 }
 
 parser_error_t parser_readPB_Participant(parser_context_t *ctx, parser_participant_t *participant) {
+    TRACE_SCOPE("parser_readPB_Participant");
 
     uint64_t v;
     while (ctx->offset < ctx->bufferLen) {
@@ -554,7 +594,145 @@ parser_error_t parser_readPB_Participant(parser_context_t *ctx, parser_participa
     return parser_ok;
 }
 
+__Z_INLINE void _uint128_add(parser_uint128_t *acc, uint64_t high, uint64_t low) {
+    acc->low += low;
+    if (acc->low < low) {
+        acc->high++;
+    }
+    acc->high += high;
+}
+
+void _addCoinToTotal(parser_uint128_t *total, const parser_coin_t *coin) {
+    // total += whole * 10^IOV_FRAC_DIGITS + fractional
+    // 64-bit multiplication is split in two to avoid overflowing
+    const uint64_t whole = (uint64_t) coin->whole;
+    const uint64_t lo = (whole & 0xFFFFFFFFu) * IOV_FRAC_UNIT;
+    const uint64_t hi = (whole >> 32u) * IOV_FRAC_UNIT;
+
+    _uint128_add(total, hi >> 32u, hi << 32u);
+    _uint128_add(total, 0, lo);
+    _uint128_add(total, 0, (uint64_t) coin->fractional);
+}
+
+parser_error_t _accumulateCoin(parser_batchmsg_t *batchmsg, const parser_coin_t *coin) {
+    for (uint8_t i = 0; i < batchmsg->totalsCount; i++) {
+        parser_cointotal_t *t = &batchmsg->totals_array[i];
+        if (t->tickerLen == coin->tickerLen && MEMCMP(t->tickerPtr, coin->tickerPtr, coin->tickerLen) == 0) {
+            _addCoinToTotal(&t->total, coin);
+            return parser_ok;
+        }
+    }
+
+    if (batchmsg->totalsCount >= PBIDX_BATCHMSG_TICKERS_MAX) {
+        return parser_unexpected_number_items;
+    }
+
+    parser_cointotal_t *t = &batchmsg->totals_array[batchmsg->totalsCount];
+    t->tickerPtr = coin->tickerPtr;
+    t->tickerLen = coin->tickerLen;
+    t->total.high = 0;
+    t->total.low = 0;
+    _addCoinToTotal(&t->total, coin);
+    batchmsg->totalsCount++;
+
+    return parser_ok;
+}
+
+parser_error_t parser_readPB_BatchUnion(parser_context_t *ctx, parser_batchmsg_t *batchmsg) {
+    TRACE_SCOPE("parser_readPB_BatchUnion");
+    uint8_t seen = 0;
+    parser_batchsend_t *send = &batchmsg->sendmsg_array[batchmsg->sendmsgCount];
+
+    uint64_t v;
+    while (ctx->offset < ctx->bufferLen) {
+        FAIL_ON_ERROR(_readRawVarint(ctx, &v))
+
+        switch (FIELD_NUM(v)) {
+            case PBIDX_BATCHMSG_UNION_SENDMSG: {
+                CHECK_NOT_DUPLICATED(seen)
+                READ_ARRAY(send->sendmsg)
+                break;
+            }
+            default:
+                // Only SendMsg is supported inside a batch
+                return parser_unexpected_field;
+        }
+    }
+
+    if (!seen) {
+        return parser_unexpected_type;
+    }
+
+    // Validate the message and aggregate its amount
+    parser_sendmsg_t sendmsg;
+    parser_sendmsgInit(&sendmsg);
+    WITH_CONTEXT(send->sendmsgPtr, send->sendmsgLen,
+                 parser_readPB_SendMsg(&__tmpctx, &sendmsg))
+
+    if (sendmsg.memoLen > TX_MEMOLEN_MAX) {
+        return parser_unexpected_buffer_end;
+    }
+    send->hasMemo = sendmsg.memoLen > 0;
+
+    FAIL_ON_ERROR(_accumulateCoin(batchmsg, &sendmsg.amount))
+
+    batchmsg->sendmsgCount++;
+    return parser_ok;
+}
+
+parser_error_t parser_readPB_BatchMsg(parser_context_t *ctx, parser_batchmsg_t *batchmsg) {
+    TRACE_SCOPE("parser_readPB_BatchMsg");
+
+    uint64_t v;
+    while (ctx->offset < ctx->bufferLen) {
+        FAIL_ON_ERROR(_readRawVarint(ctx, &v))
+
+        switch (FIELD_NUM(v)) {
+            case PBIDX_BATCHMSG_MESSAGES: {
+                // This is a repeated field
+                if (batchmsg->sendmsgCount >= PBIDX_BATCHMSG_SENDMSG_MAX) {
+                    return parser_unexpected_number_items;
+                }
+
+                parser_context_t local_ctx;
+                FAIL_ON_ERROR(_readArray(ctx, &local_ctx.buffer, &local_ctx.bufferLen))
+                local_ctx.offset = 0;
+                local_ctx.lastConsumed = 0;
+                local_ctx.errorPtr = NULL;
+                local_ctx.tx_obj = NULL;
+
+                FAIL_ON_ERROR_IN(&local_ctx, parser_readPB_BatchUnion(&local_ctx, batchmsg))
+                break;
+            }
+            default:
+                // Unknown fields are rejected to avoid malleability
+                return parser_unexpected_field;
+        }
+    }
+
+    return parser_ok;
+}
+
+parser_error_t parser_readBatchSendMsg(const parser_batchmsg_t *batchmsg, uint8_t sendIdx, parser_sendmsg_t *sendmsg) {
+    if (sendIdx >= PBIDX_BATCHMSG_SENDMSG_MAX) {
+        return parser_unexpected_field;
+    }
+
+    const parser_batchsend_t *send = &batchmsg->sendmsg_array[sendIdx];
+
+    parser_sendmsgInit(sendmsg);
+
+    // Already validated by parser_readPB_BatchUnion
+    parser_context_t sendCtx;
+    if (parser_init_context(&sendCtx, send->sendmsgPtr, send->sendmsgLen) != parser_no_data) {
+        FAIL_ON_ERROR(parser_readPB_SendMsg(&sendCtx, sendmsg))
+    }
+
+    return parser_ok;
+}
+
 parser_error_t parser_readPB_Root(parser_context_t *ctx) {
+    TRACE_SCOPE("parser_readPB_Root");
     parser_error_t err = parser_ok;
     uint64_t v;
     while (ctx->offset < ctx->bufferLen && err == parser_ok) {
@@ -563,31 +741,37 @@ parser_error_t parser_readPB_Root(parser_context_t *ctx) {
 
         switch (FIELD_NUM(v)) {
             case PBIDX_TX_FEES: {
-                CHECK_NOT_DUPLICATED(parser_tx_obj.seen.fees)
-                err = _readArray(ctx, &parser_tx_obj.feesPtr, &parser_tx_obj.feesLen);
+                CHECK_NOT_DUPLICATED(ctx->tx_obj->seen.fees)
+                err = _readArray(ctx, &ctx->tx_obj->feesPtr, &ctx->tx_obj->feesLen);
                 break;
             }
             case PBIDX_TX_MULTISIG: {
                 // This is a repeated field
-                err = parser_readPB_Multisig(ctx, &parser_tx_obj.multisig);
+                err = parser_readPB_Multisig(ctx, &ctx->tx_obj->multisig);
                 break;
             }
             case PBIDX_TX_SENDMSG: {
-                CHECK_NOT_DUPLICATED(parser_tx_obj.seen.tx_message)
-                err = _readArray(ctx, &parser_tx_obj.sendmsgPtr, &parser_tx_obj.sendmsgLen);
-                parser_tx_obj.msgType = Msg_Send;
+                CHECK_NOT_DUPLICATED(ctx->tx_obj->seen.tx_message)
+                err = _readArray(ctx, &ctx->tx_obj->sendmsgPtr, &ctx->tx_obj->sendmsgLen);
+                ctx->tx_obj->msgType = Msg_Send;
                 break;
             }
             case PBIDX_TX_VOTEMSG: {
-                CHECK_NOT_DUPLICATED(parser_tx_obj.seen.tx_message)
-                err = _readArray(ctx, &parser_tx_obj.votemsgPtr, &parser_tx_obj.votemsgLen);
-                parser_tx_obj.msgType = Msg_Vote;
+                CHECK_NOT_DUPLICATED(ctx->tx_obj->seen.tx_message)
+                err = _readArray(ctx, &ctx->tx_obj->votemsgPtr, &ctx->tx_obj->votemsgLen);
+                ctx->tx_obj->msgType = Msg_Vote;
                 break;
             }
             case PBIDX_TX_UPDATEMSG: {
-                CHECK_NOT_DUPLICATED(parser_tx_obj.seen.tx_message)
-                err = _readArray(ctx, &parser_tx_obj.updatemsgPtr, &parser_tx_obj.updatemsgLen);
-                parser_tx_obj.msgType = Msg_Update;
+                CHECK_NOT_DUPLICATED(ctx->tx_obj->seen.tx_message)
+                err = _readArray(ctx, &ctx->tx_obj->updatemsgPtr, &ctx->tx_obj->updatemsgLen);
+                ctx->tx_obj->msgType = Msg_Update;
+                break;
+            }
+            case PBIDX_TX_BATCHMSG: {
+                CHECK_NOT_DUPLICATED(ctx->tx_obj->seen.tx_message)
+                err = _readArray(ctx, &ctx->tx_obj->batchmsgPtr, &ctx->tx_obj->batchmsgLen);
+                ctx->tx_obj->msgType = Msg_Batch;
                 break;
             }
             default:
@@ -600,6 +784,7 @@ parser_error_t parser_readPB_Root(parser_context_t *ctx) {
 }
 
 parser_error_t parser_readRoot(parser_context_t *ctx) {
+    TRACE_SCOPE("parser_readRoot");
     // ---------- READ CUSTOM HEADER (not protobuf)
     //version | len(chainID) | chainID      | nonce             | signBytes
     //4bytes  | uint8        | ascii string | int64 (bigendian) | serialized transaction
@@ -608,24 +793,24 @@ parser_error_t parser_readRoot(parser_context_t *ctx) {
         return parser_unexpected_buffer_end;
     }
 
-    parser_tx_obj.version = (uint32_t *) (ctx->buffer + 0);
-    parser_tx_obj.chainIDLen = *(ctx->buffer + 4);
+    ctx->tx_obj->version = (uint32_t *) (ctx->buffer + 0);
+    ctx->tx_obj->chainIDLen = *(ctx->buffer + 4);
 
-    if (parser_tx_obj.chainIDLen < TX_CHAINIDLEN_MIN) {
+    if (ctx->tx_obj->chainIDLen < TX_CHAINIDLEN_MIN) {
         return parser_unexpected_chain;
     }
 
-    if (parser_tx_obj.chainIDLen > TX_CHAINIDLEN_MAX) {
+    if (ctx->tx_obj->chainIDLen > TX_CHAINIDLEN_MAX) {
         return parser_unexpected_buffer_end;
     }
 
-    parser_tx_obj.chainID = ctx->buffer + 5;
-    if (_checkChainIDValid(parser_tx_obj.chainID, parser_tx_obj.chainIDLen)) {
+    ctx->tx_obj->chainID = ctx->buffer + 5;
+    if (_checkChainIDValid(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen)) {
         return parser_unexpected_characters;
     }
 
-    const uint8_t *p_src = ctx->buffer + 5 + parser_tx_obj.chainIDLen;
-    uint8_t *p_dst = (uint8_t *) &parser_tx_obj.nonce;
+    const uint8_t *p_src = ctx->buffer + 5 + ctx->tx_obj->chainIDLen;
+    uint8_t *p_dst = (uint8_t *) &ctx->tx_obj->nonce;
     p_dst[0] = *(p_src + 7);
     p_dst[1] = *(p_src + 6);
     p_dst[2] = *(p_src + 5);
@@ -635,7 +820,7 @@ parser_error_t parser_readRoot(parser_context_t *ctx) {
     p_dst[6] = *(p_src + 1);
     p_dst[7] = *(p_src + 0);
 
-    ctx->lastConsumed = 5 + parser_tx_obj.chainIDLen + 8;
+    ctx->lastConsumed = 5 + ctx->tx_obj->chainIDLen + 8;
 
     if (ctx->lastConsumed > ctx->bufferLen) {
         return parser_unexpected_buffer_end;
@@ -643,11 +828,11 @@ parser_error_t parser_readRoot(parser_context_t *ctx) {
 
     // ---------- VALIDATE HEADER
     // Check version
-    if (*parser_tx_obj.version != 0x00feca00) {
+    if (*ctx->tx_obj->version != 0x00feca00) {
         return parser_unexpected_version;
     }
 
-    FAIL_ON_ERROR( _checkValidReadableChars(parser_tx_obj.chainID, parser_tx_obj.chainIDLen))
+    FAIL_ON_ERROR( _checkValidReadableChars(ctx->tx_obj->chainID, ctx->tx_obj->chainIDLen))
 
     ctx->offset += ctx->lastConsumed;
     ctx->lastConsumed = 0;
@@ -662,24 +847,33 @@ parser_error_t parser_Tx(parser_context_t *ctx) {
 
     FAIL_ON_ERROR(parser_readRoot(ctx))
 
-    WITH_CONTEXT(parser_tx_obj.feesPtr, parser_tx_obj.feesLen,
-                 parser_readPB_Fees(&__tmpctx, &parser_tx_obj.fees))
+    WITH_CONTEXT(ctx->tx_obj->feesPtr, ctx->tx_obj->feesLen,
+                 parser_readPB_Fees(&__tmpctx, &ctx->tx_obj->fees))
 
     //Tx should contains only one of the following
-    switch (parser_tx_obj.msgType) {
+    switch (ctx->tx_obj->msgType) {
         case Msg_Send: {
-            WITH_CONTEXT(parser_tx_obj.sendmsgPtr, parser_tx_obj.sendmsgLen,
-                         parser_readPB_SendMsg(&__tmpctx, &parser_tx_obj.sendmsg))
+            WITH_CONTEXT(ctx->tx_obj->sendmsgPtr, ctx->tx_obj->sendmsgLen,
+                         parser_readPB_SendMsg(&__tmpctx, &ctx->tx_obj->sendmsg))
             break;
         }
         case Msg_Vote: {
-            WITH_CONTEXT(parser_tx_obj.votemsgPtr, parser_tx_obj.votemsgLen,
-                         parser_readPB_VoteMsg(&__tmpctx, &parser_tx_obj.votemsg))
+            WITH_CONTEXT(ctx->tx_obj->votemsgPtr, ctx->tx_obj->votemsgLen,
+                         parser_readPB_VoteMsg(&__tmpctx, &ctx->tx_obj->votemsg))
             break;
         }
         case Msg_Update: {
-            WITH_CONTEXT(parser_tx_obj.updatemsgPtr, parser_tx_obj.updatemsgLen,
-                         parser_readPB_UpdateMultisigMsg(&__tmpctx, &parser_tx_obj.updatemsg))
+            WITH_CONTEXT(ctx->tx_obj->updatemsgPtr, ctx->tx_obj->updatemsgLen,
+                         parser_readPB_UpdateMultisigMsg(&__tmpctx, &ctx->tx_obj->updatemsg))
+            break;
+        }
+        case Msg_Batch: {
+            WITH_CONTEXT(ctx->tx_obj->batchmsgPtr, ctx->tx_obj->batchmsgLen,
+                         parser_readPB_BatchMsg(&__tmpctx, &ctx->tx_obj->batchmsg))
+            // Also catches an empty BatchMsg, which is never read
+            if (ctx->tx_obj->batchmsg.sendmsgCount == 0) {
+                return parser_unexpected_number_items;
+            }
             break;
         }
         default:
@@ -738,6 +932,9 @@ parser_error_t parser_arrayToString(char *out, uint16_t outLen,
 
     if (pageCount != NULL) {
         *pageCount = 1 + inLen / (outLen - 1);
+        if (pageIdx >= *pageCount) {
+            return parser_display_page_out_of_range;
+        }
     } else {
         pageIdx = 0;
     }
@@ -779,3 +976,29 @@ parser_error_t parser_formatAmountFriendly(char *out, uint16_t outLen, parser_co
 
     return parser_ok;
 }
+
+parser_error_t parser_formatAmountTotal(char *out, uint16_t outLen, const parser_uint128_t *total) {
+    if (outLen < IOV_TOTAL_DIGITS + 2) {
+        return parser_unexpected_buffer_end;
+    }
+
+    uint8_t bigEndian[16];
+    for (uint8_t i = 0; i < 8; i++) {
+        bigEndian[7 - i] = (uint8_t) (total->high >> (8u * i));
+        bigEndian[15 - i] = (uint8_t) (total->low >> (8u * i));
+    }
+
+    uint8_t bcd[(IOV_TOTAL_DIGITS + 1) / 2];
+    bignumBigEndian_to_bcd(bcd, sizeof(bcd), bigEndian, sizeof(bigEndian));
+
+    char digits[IOV_TOTAL_DIGITS + 1];
+    if (!bignumBigEndian_bcdprint(digits, sizeof(digits), bcd, sizeof(bcd))) {
+        return parser_unexpected_buffer_end;
+    }
+
+    if (fpstr_to_str(out, outLen, digits, IOV_FRAC_DIGITS) != 0) {
+        return parser_unexpected_buffer_end;
+    }
+
+    return parser_ok;
+}
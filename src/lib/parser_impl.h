@@ -26,8 +26,6 @@ extern "C" {
 #include <stddef.h>
 #include "parser_txdef.h"
 
-extern parser_tx_t parser_tx_obj;
-
 #define WIRE_TYPE_VARINT   0            // Zigzag is not supported
 #define WIRE_TYPE_64BIT    1            // Not supported
 #define WIRE_TYPE_LEN      2
@@ -38,7 +36,8 @@ extern parser_tx_t parser_tx_obj;
 
 parser_error_t parser_init(parser_context_t *ctx,
                            const uint8_t *buffer,
-                           uint16_t bufferSize);
+                           parser_size_t bufferSize,
+                           parser_tx_t *tx_obj);
 
 parser_error_t _readRawVarint(parser_context_t *ctx, uint64_t *value);
 
@@ -48,7 +47,7 @@ parser_error_t _readUInt32(parser_context_t *ctx, uint32_t *value);
 
 parser_error_t _readUInt8(parser_context_t *ctx, uint8_t *value);
 
-parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, uint16_t *arrayLength);
+parser_error_t _readArray(parser_context_t *ctx, const uint8_t **arrayPtr, parser_size_t *arrayLength);
 
 parser_error_t parser_readPB_Metadata(parser_context_t *ctx, parser_metadata_t *metadata);
 
@@ -64,6 +63,12 @@ parser_error_t parser_readPB_UpdateMultisigMsg(parser_context_t *ctx, parser_upd
 
 parser_error_t parser_readPB_Participant(parser_context_t *ctx, parser_participant_t *participant);
 
+parser_error_t parser_readPB_BatchMsg(parser_context_t *ctx, parser_batchmsg_t *batchmsg);
+
+parser_error_t parser_readPB_BatchUnion(parser_context_t *ctx, parser_batchmsg_t *batchmsg);
+
+parser_error_t parser_readBatchSendMsg(const parser_batchmsg_t *batchmsg, uint8_t sendIdx, parser_sendmsg_t *sendmsg);
+
 parser_error_t parser_readPB_Root(parser_context_t *ctx);
 
 parser_error_t parser_readRoot(parser_context_t *ctx);
@@ -84,6 +89,7 @@ parser_error_t parser_arrayToString(char *out, uint16_t outLen,
 
 parser_error_t parser_formatAmount(char *out, uint16_t outLen, parser_coin_t *coin);
 parser_error_t parser_formatAmountFriendly(char *out, uint16_t outLen, parser_coin_t *coin);
+parser_error_t parser_formatAmountTotal(char *out, uint16_t outLen, const parser_uint128_t *total);
 
 #ifdef __cplusplus
 }
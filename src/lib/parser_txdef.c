@@ -113,6 +113,11 @@ void parser_updatemsgInit(parser_updatemultisigmsg_t *msg) {
     msg->contractIdLen = 0;
 }
 
+void parser_batchmsgInit(parser_batchmsg_t *msg) {
+    msg->sendmsgCount = 0;
+    msg->totalsCount = 0;
+}
+
 void parser_ParticipantmsgInit(parser_participant_t *msg) {
     msg->seen.weight = 0;
     msg->seen.signature = 0;
@@ -153,5 +158,9 @@ void parser_txInit(parser_tx_t *tx) {
     tx->updatemsgPtr = NULL;
     tx->updatemsgLen = 0;
     parser_updatemsgInit(&tx->updatemsg);
+
+    tx->batchmsgPtr = NULL;
+    tx->batchmsgLen = 0;
+    parser_batchmsgInit(&tx->batchmsg);
 }
 
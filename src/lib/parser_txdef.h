@@ -30,6 +30,9 @@
 //51, 5   SendMsg: Memo         [String]
 //51, 6   SendMsg: Ref          [?????]
 
+//60, 1   BatchMsg: Messages    [repeated Union]
+//60, 1, 51  Union: SendMsg     [SendMsg]
+
 //[Coin] -> Stringify
 //?, 1    Whole
 //?, 2    Fractional
@@ -41,6 +44,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <stddef.h>
+#include "parser_common.h"
 
 #define TX_BUFFER_MIN       4
 #define TX_CHAINIDLEN_MIN   4
@@ -72,7 +76,7 @@ typedef struct {
     int64_t whole;
     int64_t fractional;
     const uint8_t *tickerPtr;
-    uint16_t tickerLen;
+    parser_size_t tickerLen;
 } parser_coin_t;
 
 #define PBIDX_FEES_PAYER           2
@@ -86,10 +90,10 @@ typedef struct {
     } seen;
 
     const uint8_t *payerPtr;
-    uint16_t payerLen;
+    parser_size_t payerLen;
 
     const uint8_t *coinPtr;
-    uint16_t coinLen;
+    parser_size_t coinLen;
     parser_coin_t coin;
 } parser_fees_t;
 
@@ -120,24 +124,24 @@ typedef struct {
     } seen;
 
     const uint8_t *metadataPtr;
-    uint16_t metadataLen;
+    parser_size_t metadataLen;
     parser_metadata_t metadata;
 
     const uint8_t *sourcePtr;
-    uint16_t sourceLen;
+    parser_size_t sourceLen;
 
     const uint8_t *destinationPtr;
-    uint16_t destinationLen;
+    parser_size_t destinationLen;
 
     const uint8_t *amountPtr;
-    uint16_t amountLen;
+    parser_size_t amountLen;
     parser_coin_t amount;
 
     const uint8_t *memoPtr;
-    uint16_t memoLen;
+    parser_size_t memoLen;
 
     const uint8_t *refPtr;
-    uint16_t refLen;
+    parser_size_t refLen;
 } parser_sendmsg_t;
 
 #define PBIDX_VOTEMSG_METADATA      1
@@ -165,14 +169,14 @@ typedef struct {
     } seen;
 
     const uint8_t *metadataPtr;
-    uint16_t metadataLen;
+    parser_size_t metadataLen;
     parser_metadata_t metadata;
 
     const uint8_t *proposalIdPtr;
-    uint16_t proposalIdLen;
+    parser_size_t proposalIdLen;
 
     const uint8_t *voterPtr;
-    uint16_t voterLen;
+    parser_size_t voterLen;
 
     uint8_t voteOption;
 } parser_votemsg_t;
@@ -196,7 +200,7 @@ typedef struct {
     } seen;
 
     const uint8_t *signaturePtr;
-    uint16_t signatureLen;
+    parser_size_t signatureLen;
 
     uint32_t weight;
 } parser_participant_t;
@@ -211,11 +215,11 @@ typedef struct {
     } seen;
 
     const uint8_t *metadataPtr;
-    uint16_t metadataLen;
+    parser_size_t metadataLen;
     parser_metadata_t metadata;
 
     const uint8_t *contractIdPtr;
-    uint16_t contractIdLen;
+    parser_size_t contractIdLen;
 
     //Participants is a repeated field
     uint8_t participantsCount; //Total participants fields in Tx
@@ -226,10 +230,45 @@ typedef struct {
 } parser_updatemultisigmsg_t;
 
 
+#define PBIDX_BATCHMSG_MESSAGES           1
+#define PBIDX_BATCHMSG_UNION_SENDMSG      51
+
+#define PBIDX_BATCHMSG_SENDMSG_MAX        16
+#define PBIDX_BATCHMSG_TICKERS_MAX        4
+
+// 128-bit unsigned value. Used to accumulate amounts without overflow
+typedef struct {
+    uint64_t high;
+    uint64_t low;
+} parser_uint128_t;
+
+typedef struct {
+    const uint8_t *tickerPtr;
+    parser_size_t tickerLen;
+    parser_uint128_t total;         // Fixed point with IOV_FRAC_DIGITS decimals
+} parser_cointotal_t;
+
+typedef struct {
+    const uint8_t *sendmsgPtr;
+    parser_size_t sendmsgLen;
+    uint8_t hasMemo;
+} parser_batchsend_t;
+
+typedef struct {
+    //Messages is a repeated field. Only SendMsg is supported
+    uint8_t sendmsgCount;
+    parser_batchsend_t sendmsg_array[PBIDX_BATCHMSG_SENDMSG_MAX];
+
+    //Amounts aggregated by ticker
+    uint8_t totalsCount;
+    parser_cointotal_t totals_array[PBIDX_BATCHMSG_TICKERS_MAX];
+} parser_batchmsg_t;
+
 #define PBIDX_TX_FEES           1
 #define PBIDX_TX_MULTISIG       4
 #define PBIDX_TX_SENDMSG        51
 #define PBIDX_TX_UPDATEMSG      57
+#define PBIDX_TX_BATCHMSG       60
 #define PBIDX_TX_VOTEMSG        75
 
 typedef enum {
@@ -237,9 +276,12 @@ typedef enum {
     Msg_Send,
     Msg_Vote,
     Msg_Update,
+    Msg_Batch,
 } MsgType;
 
-typedef struct {
+#define PARSER_UI_BUFFER_LEN    256
+
+struct parser_tx_t {
     const uint32_t *version;
     uint8_t chainIDLen;
     const uint8_t *chainID;
@@ -253,33 +295,41 @@ typedef struct {
     } seen;
 
     const uint8_t *feesPtr;
-    uint16_t feesLen;
+    parser_size_t feesLen;
     parser_fees_t fees;             // PB Field 1
 
     const uint8_t *multisigPtr;
-    uint16_t multisigLen;
+    parser_size_t multisigLen;
     parser_multisig_t multisig;     // PB Field 4
 
     //TxMsg has only one of the following
     union {
         struct {
             const uint8_t *sendmsgPtr;
-            uint16_t sendmsgLen;
+            parser_size_t sendmsgLen;
             parser_sendmsg_t sendmsg;       // PB Field 51
         };
         struct {
             const uint8_t *updatemsgPtr;
-            uint16_t updatemsgLen;
+            parser_size_t updatemsgLen;
             parser_updatemultisigmsg_t updatemsg;   // PB Field 57
         };
+        struct {
+            const uint8_t *batchmsgPtr;
+            parser_size_t batchmsgLen;
+            parser_batchmsg_t batchmsg;     // PB Field 60
+        };
         struct {
             const uint8_t *votemsgPtr;
-            uint16_t votemsgLen;
+            parser_size_t votemsgLen;
             parser_votemsg_t votemsg;       // PB Field 75
         };
         //
     };
-} parser_tx_t;
+
+    // Scratch space used to format display items
+    uint8_t uiBuffer[PARSER_UI_BUFFER_LEN];
+};
 
 void parser_coinInit(parser_coin_t *coin);
 void parser_feesInit(parser_fees_t *fees);
@@ -287,6 +337,7 @@ void parser_multisigInit(parser_multisig_t *msg);
 void parser_sendmsgInit(parser_sendmsg_t *msg);
 void parser_votemsgInit(parser_votemsg_t *msg);
 void parser_updatemsgInit(parser_updatemultisigmsg_t *msg);
+void parser_batchmsgInit(parser_batchmsg_t *msg);
 void parser_ParticipantmsgInit(parser_participant_t *msg);
 void parser_txInit(parser_tx_t *tx);
 
@@ -0,0 +1,258 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "pubkey_cache.h"
+#include "coin.h"
+#include "stats.h"
+#include "zxmacros.h"
+#include <string.h>
+
+typedef struct {
+    uint32_t path[HDPATH_LEN_DEFAULT];
+    uint8_t pubKey[PK_LEN];
+} pubkey_cache_entry_t;
+
+typedef struct {
+    pubkey_cache_entry_t entry;
+    uint32_t lastUse;           // 0 means the slot is empty
+#if defined(PUBKEY_CACHE_NVM)
+    bool persisted;             // already in the flash tier
+#endif
+} pubkey_cache_slot_t;
+
+pubkey_cache_slot_t pubkey_cache[PUBKEY_CACHE_SIZE];
+uint32_t pubkey_cache_clock = 0;
+
+__Z_INLINE bool path_equals(const uint32_t a[HDPATH_LEN_DEFAULT], const uint32_t b[HDPATH_LEN_DEFAULT]) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+pubkey_cache_slot_t *pubkey_cache_ram_find(const uint32_t path[HDPATH_LEN_DEFAULT]) {
+    for (uint8_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        pubkey_cache_slot_t *slot = &pubkey_cache[i];
+        if (slot->lastUse != 0 && path_equals(slot->entry.path, path)) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+pubkey_cache_slot_t *pubkey_cache_ram_put(const uint32_t path[HDPATH_LEN_DEFAULT], const uint8_t *pubKey) {
+    // Evict the least recently used slot (empty slots have lastUse == 0)
+    pubkey_cache_slot_t *victim = &pubkey_cache[0];
+    for (uint8_t i = 0; i < PUBKEY_CACHE_SIZE; i++) {
+        pubkey_cache_slot_t *slot = &pubkey_cache[i];
+        if (slot->lastUse != 0 && path_equals(slot->entry.path, path)) {
+            victim = slot;
+            break;
+        }
+        if (slot->lastUse < victim->lastUse) {
+            victim = slot;
+        }
+    }
+
+    if (pubkey_cache_clock == UINT32_MAX) {
+        pubkey_cache_clear();
+        victim = &pubkey_cache[0];
+    }
+
+    MEMCPY(victim->entry.path, path, sizeof(victim->entry.path));
+    MEMCPY(victim->entry.pubKey, pubKey, PK_LEN);
+    victim->lastUse = ++pubkey_cache_clock;
+#if defined(PUBKEY_CACHE_NVM)
+    victim->persisted = false;
+#endif
+    return victim;
+}
+
+#if defined(PUBKEY_CACHE_NVM)
+// Flash tier. Entries are only valid for the seed that produced them, so the public key
+// of 44'/234'/0' is stored alongside them and checked once per session.
+// A key is only written when it is looked up again while in RAM, or when its path signs:
+// a one-off scan of many accounts does not wear flash nor evict the accounts in use
+#define PUBKEY_CACHE_NVM_MAGIC 0xCA
+
+typedef struct {
+    uint8_t magic;
+    uint8_t next;               // slot to overwrite next (round robin)
+    uint8_t seedCheck[PK_LEN];
+    uint8_t used[PUBKEY_CACHE_NVM_SIZE];
+    pubkey_cache_entry_t entries[PUBKEY_CACHE_NVM_SIZE];
+} pubkey_cache_storage_t;
+
+#if defined(TARGET_NANOS)
+pubkey_cache_storage_t N_pubkey_cache_impl __attribute__ ((aligned(64)));
+#define N_pubkey_cache (*(pubkey_cache_storage_t *)PIC(&N_pubkey_cache_impl))
+
+#elif defined(TARGET_NANOX)
+pubkey_cache_storage_t const N_pubkey_cache_impl __attribute__ ((aligned(64)));
+#define N_pubkey_cache (*(volatile pubkey_cache_storage_t *)PIC(&N_pubkey_cache_impl))
+
+#else
+pubkey_cache_storage_t N_pubkey_cache_impl;
+#define N_pubkey_cache N_pubkey_cache_impl
+#endif
+
+typedef enum {
+    nvm_unchecked = 0,
+    nvm_valid,
+    nvm_stale,
+} pubkey_cache_nvm_state_e;
+
+pubkey_cache_nvm_state_e pubkey_cache_nvm_state = nvm_unchecked;
+uint8_t pubkey_cache_seed_check[PK_LEN];
+
+void pubkey_cache_nvm_check() {
+    if (pubkey_cache_nvm_state != nvm_unchecked) {
+        return;
+    }
+
+    const uint32_t checkPath[HDPATH_LEN_DEFAULT] = {HDPATH_0_DEFAULT, HDPATH_1_DEFAULT, 0x80000000u};
+    crypto_derivePublicKey(checkPath, pubkey_cache_seed_check, PK_LEN);
+    // Account 0 is usually requested anyway
+    pubkey_cache_ram_put(checkPath, pubkey_cache_seed_check);
+
+    pubkey_cache_nvm_state = nvm_stale;
+    if (N_pubkey_cache.magic == PUBKEY_CACHE_NVM_MAGIC &&
+        MEMCMP((const void *) N_pubkey_cache.seedCheck, pubkey_cache_seed_check, PK_LEN) == 0) {
+        pubkey_cache_nvm_state = nvm_valid;
+    }
+}
+
+// Returns the index of the flash entry of a path, or PUBKEY_CACHE_NVM_SIZE
+uint8_t pubkey_cache_nvm_find(const uint32_t path[HDPATH_LEN_DEFAULT]) {
+    for (uint8_t i = 0; i < PUBKEY_CACHE_NVM_SIZE; i++) {
+        if (N_pubkey_cache.used[i] &&
+            path_equals((const uint32_t *) N_pubkey_cache.entries[i].path, path)) {
+            return i;
+        }
+    }
+    return PUBKEY_CACHE_NVM_SIZE;
+}
+
+bool pubkey_cache_nvm_get(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey) {
+    pubkey_cache_nvm_check();
+    if (pubkey_cache_nvm_state != nvm_valid) {
+        return false;
+    }
+
+    const uint8_t i = pubkey_cache_nvm_find(path);
+    if (i >= PUBKEY_CACHE_NVM_SIZE) {
+        return false;
+    }
+    MEMCPY(pubKey, (const void *) N_pubkey_cache.entries[i].pubKey, PK_LEN);
+    return true;
+}
+
+void pubkey_cache_nvm_put(const uint32_t path[HDPATH_LEN_DEFAULT], const uint8_t *pubKey) {
+    pubkey_cache_nvm_check();
+
+    if (pubkey_cache_nvm_state == nvm_stale) {
+        // Entries belong to another seed: start over for the current one
+        const uint8_t zeroes[PUBKEY_CACHE_NVM_SIZE] = {0};
+        MEMCPY_NV((void *) PIC(N_pubkey_cache.used), (void *) zeroes, sizeof(zeroes));
+        MEMCPY_NV((void *) PIC(N_pubkey_cache.seedCheck), pubkey_cache_seed_check, PK_LEN);
+        SET_NV(&N_pubkey_cache.next, uint8_t, 0);
+        SET_NV(&N_pubkey_cache.magic, uint8_t, PUBKEY_CACHE_NVM_MAGIC);
+        STATS_NVM_WRITE(N_pubkey_cache.used, sizeof(zeroes));
+        STATS_NVM_WRITE(N_pubkey_cache.seedCheck, PK_LEN);
+        STATS_NVM_WRITE(&N_pubkey_cache.next, 1);
+        STATS_NVM_WRITE(&N_pubkey_cache.magic, 1);
+        pubkey_cache_nvm_state = nvm_valid;
+    }
+
+    const uint8_t stored = pubkey_cache_nvm_find(path);
+    if (stored < PUBKEY_CACHE_NVM_SIZE &&
+        MEMCMP((const void *) N_pubkey_cache.entries[stored].pubKey, pubKey, PK_LEN) == 0) {
+        // Already there: nothing to write
+        return;
+    }
+
+    uint8_t slot = N_pubkey_cache.next;
+    if (slot >= PUBKEY_CACHE_NVM_SIZE) {
+        slot = 0;
+    }
+
+    pubkey_cache_entry_t entry;
+    MEMCPY(entry.path, path, sizeof(entry.path));
+    MEMCPY(entry.pubKey, pubKey, PK_LEN);
+
+    MEMCPY_NV((void *) PIC(&N_pubkey_cache.entries[slot]), &entry, sizeof(entry));
+    SET_NV(&N_pubkey_cache.used[slot], uint8_t, 1);
+    SET_NV(&N_pubkey_cache.next, uint8_t, (slot + 1) % PUBKEY_CACHE_NVM_SIZE);
+    STATS_NVM_WRITE(&N_pubkey_cache.entries[slot], sizeof(entry));
+    STATS_NVM_WRITE(&N_pubkey_cache.used[slot], 1);
+    STATS_NVM_WRITE(&N_pubkey_cache.next, 1);
+}
+#endif
+
+bool pubkey_cache_get(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey) {
+    pubkey_cache_slot_t *slot = pubkey_cache_ram_find(path);
+    if (slot != NULL) {
+        slot->lastUse = ++pubkey_cache_clock;
+        MEMCPY(pubKey, slot->entry.pubKey, PK_LEN);
+#if defined(PUBKEY_CACHE_NVM)
+        // Second use of the key: it is worth keeping across restarts
+        if (!slot->persisted) {
+            pubkey_cache_nvm_put(path, pubKey);
+            slot->persisted = true;
+        }
+#endif
+        STATS_INC(pubkeyCacheHits);
+        return true;
+    }
+
+#if defined(PUBKEY_CACHE_NVM)
+    if (pubkey_cache_nvm_get(path, pubKey)) {
+        // Promote to RAM so the next lookup does not touch flash
+        pubkey_cache_ram_put(path, pubKey)->persisted = true;
+        STATS_INC(pubkeyCacheHits);
+        return true;
+    }
+#endif
+
+    STATS_INC(pubkeyCacheMisses);
+    return false;
+}
+
+void pubkey_cache_put(const uint32_t path[HDPATH_LEN_DEFAULT], const uint8_t *pubKey) {
+    pubkey_cache_ram_put(path, pubKey);
+}
+
+void pubkey_cache_persist(const uint32_t path[HDPATH_LEN_DEFAULT]) {
+#if defined(PUBKEY_CACHE_NVM)
+    // The check may add account 0 to RAM: done first so that it cannot evict the slot below
+    pubkey_cache_nvm_check();
+
+    pubkey_cache_slot_t *slot = pubkey_cache_ram_find(path);
+    if (slot != NULL && !slot->persisted) {
+        pubkey_cache_nvm_put(path, slot->entry.pubKey);
+        slot->persisted = true;
+    }
+#else
+    (void) path;
+#endif
+}
+
+void pubkey_cache_clear() {
+    MEMZERO(pubkey_cache, sizeof(pubkey_cache));
+    pubkey_cache_clock = 0;
+#if defined(PUBKEY_CACHE_NVM)
+    // The seed may change (e.g. passphrase) while the device is locked
+    pubkey_cache_nvm_state = nvm_unchecked;
+#endif
+}
+
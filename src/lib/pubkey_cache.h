@@ -0,0 +1,55 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "crypto.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(TARGET_NANOX)
+#define PUBKEY_CACHE_SIZE       8
+#else
+#define PUBKEY_CACHE_SIZE       4
+#endif
+
+// Entries kept in flash when PUBKEY_CACHE_NVM is defined
+#define PUBKEY_CACHE_NVM_SIZE   8
+
+/// Looks up the public key of a path. Returns true and fills pubKey on a hit
+bool pubkey_cache_get(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey);
+
+/// Stores the public key of a path, evicting the least recently used entry if needed.
+/// With PUBKEY_CACHE_NVM the key goes to flash the next time it is looked up
+void pubkey_cache_put(const uint32_t path[HDPATH_LEN_DEFAULT], const uint8_t *pubKey);
+
+/// Path about to sign: keeps its public key in flash if it is cached (PUBKEY_CACHE_NVM only)
+void pubkey_cache_persist(const uint32_t path[HDPATH_LEN_DEFAULT]);
+
+/// Drops all RAM entries. The NVM tier (if enabled) is kept
+void pubkey_cache_clear();
+
+#if defined(PUBKEY_CACHE_NVM)
+/// Looks up the public key of a path in the NVM tier only
+bool pubkey_cache_nvm_get(const uint32_t path[HDPATH_LEN_DEFAULT], uint8_t *pubKey);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,56 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA256_DIGEST_LEN   32
+#define SHA256_BLOCK_LEN    64
+
+typedef struct {
+    uint32_t state[8];
+    uint64_t totalLen;
+    uint8_t block[SHA256_BLOCK_LEN];
+    uint8_t blockLen;
+} sha256_ctx_t;
+
+extern const uint32_t sha256_iv[8];
+extern const uint32_t sha256_k[64];
+
+/// Portable SHA-256 (FIPS 180-4). Used where the cx library is not available
+void sha256_init(sha256_ctx_t *ctx);
+
+void sha256_update(sha256_ctx_t *ctx, const uint8_t *data, size_t len);
+
+void sha256_final(sha256_ctx_t *ctx, uint8_t out[SHA256_DIGEST_LEN]);
+
+void sha256(const uint8_t *data, size_t len, uint8_t out[SHA256_DIGEST_LEN]);
+
+/// Compresses one block into state, starting at round firstRound.
+/// working holds the working variables (a..h) after the skipped rounds
+void sha256_compress_from(uint32_t state[8],
+                          const uint32_t working[8],
+                          const uint8_t block[SHA256_BLOCK_LEN],
+                          uint8_t firstRound);
+
+#ifdef __cplusplus
+}
+#endif
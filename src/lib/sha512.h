@@ -0,0 +1,51 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHA512_DIGEST_LEN   64
+#define SHA512_BLOCK_LEN    128
+
+typedef struct {
+    uint64_t state[8];
+    uint64_t totalLen;
+    uint8_t block[SHA512_BLOCK_LEN];
+    uint8_t blockLen;
+} sha512_ctx_t;
+
+/// Portable SHA-512 (FIPS 180-4). Used where the cx library is not available
+void sha512_init(sha512_ctx_t *ctx);
+
+void sha512_update(sha512_ctx_t *ctx, const uint8_t *data, size_t len);
+
+void sha512_final(sha512_ctx_t *ctx, uint8_t out[SHA512_DIGEST_LEN]);
+
+void sha512(const uint8_t *data, size_t len, uint8_t out[SHA512_DIGEST_LEN]);
+
+/// HMAC-SHA512 (RFC 2104)
+void hmac_sha512(const uint8_t *key, size_t keyLen,
+                 const uint8_t *data, size_t len,
+                 uint8_t out[SHA512_DIGEST_LEN]);
+
+#ifdef __cplusplus
+}
+#endif
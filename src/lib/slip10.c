@@ -0,0 +1,57 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "slip10.h"
+#include "zxmacros.h"
+#include <string.h>
+
+#if defined(TARGET_NANOS) || defined(TARGET_NANOX)
+#include "cx.h"
+#define SLIP10_HMAC_LEN CX_SHA512_SIZE
+#define SLIP10_HMAC(KEY, KEYLEN, IN, INLEN, OUT) cx_hmac_sha512(KEY, KEYLEN, IN, INLEN, OUT, CX_SHA512_SIZE)
+#else
+#include "sha512.h"
+#define SLIP10_HMAC_LEN SHA512_DIGEST_LEN
+#define SLIP10_HMAC(KEY, KEYLEN, IN, INLEN, OUT) hmac_sha512(KEY, KEYLEN, IN, INLEN, OUT)
+#endif
+
+void slip10_deriveHardenedChild(const uint8_t parentKey[SLIP10_KEY_LEN],
+                                const uint8_t parentChainCode[SLIP10_CHAINCODE_LEN],
+                                uint32_t index,
+                                uint8_t childKey[SLIP10_KEY_LEN],
+                                uint8_t *childChainCode) {
+    // I = HMAC-SHA512(Key = c_par, Data = 0x00 || k_par || ser32(i))
+    uint8_t data[1 + SLIP10_KEY_LEN + 4];
+    uint8_t I[SLIP10_HMAC_LEN];
+
+    data[0] = 0;
+    MEMCPY(data + 1, parentKey, SLIP10_KEY_LEN);
+    data[1 + SLIP10_KEY_LEN + 0] = (uint8_t) (index >> 24u);
+    data[1 + SLIP10_KEY_LEN + 1] = (uint8_t) (index >> 16u);
+    data[1 + SLIP10_KEY_LEN + 2] = (uint8_t) (index >> 8u);
+    data[1 + SLIP10_KEY_LEN + 3] = (uint8_t) index;
+
+    SLIP10_HMAC(parentChainCode, SLIP10_CHAINCODE_LEN, data, sizeof(data), I);
+
+    // ed25519 keys are used as is: k_i = I_L, c_i = I_R
+    MEMCPY(childKey, I, SLIP10_KEY_LEN);
+    if (childChainCode != NULL) {
+        MEMCPY(childChainCode, I + SLIP10_KEY_LEN, SLIP10_CHAINCODE_LEN);
+    }
+
+    MEMZERO(data, sizeof(data));
+    MEMZERO(I, sizeof(I));
+}
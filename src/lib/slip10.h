@@ -0,0 +1,37 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SLIP10_KEY_LEN          32
+#define SLIP10_CHAINCODE_LEN    32
+
+/// Derives a hardened ed25519 child node (SLIP-0010). index must have the hardened bit set.
+/// childChainCode can be NULL when the child is a leaf
+void slip10_deriveHardenedChild(const uint8_t parentKey[SLIP10_KEY_LEN],
+                                const uint8_t parentChainCode[SLIP10_CHAINCODE_LEN],
+                                uint32_t index,
+                                uint8_t childKey[SLIP10_KEY_LEN],
+                                uint8_t *childChainCode);
+
+#ifdef __cplusplus
+}
+#endif
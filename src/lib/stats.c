@@ -0,0 +1,99 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#include "stats.h"
+
+#if defined(APP_STATS)
+
+#include "zxmacros.h"
+
+app_stats_counters_t app_stats;
+
+void stats_inc32(uint32_t *counter) {
+    if (*counter != UINT32_MAX) {
+        (*counter)++;
+    }
+}
+
+void stats_inc16(uint16_t *counter) {
+    if (*counter != UINT16_MAX) {
+        (*counter)++;
+    }
+}
+
+void stats_add32(uint32_t *counter, uint32_t value) {
+    *counter = value > UINT32_MAX - *counter ? UINT32_MAX : *counter + value;
+}
+
+void stats_nvm_write(const void *dst, uint32_t len) {
+    if (len == 0) {
+        return;
+    }
+    const uintptr_t first = (uintptr_t) dst / STATS_NVM_PAGE_SIZE;
+    const uintptr_t last = ((uintptr_t) dst + len - 1) / STATS_NVM_PAGE_SIZE;
+    stats_add32(&app_stats.nvmPageWrites, (uint32_t) (last - first + 1));
+}
+
+void stats_buffer_use(uint8_t inFlash, uint16_t ramPos, uint16_t flashPos) {
+    if (inFlash) {
+        stats_inc32(&app_stats.txFlash);
+    } else {
+        stats_inc32(&app_stats.txRam);
+    }
+    if (ramPos > app_stats.ramMax) {
+        app_stats.ramMax = ramPos;
+    }
+    if (flashPos > app_stats.flashMax) {
+        app_stats.flashMax = flashPos;
+    }
+}
+
+uint16_t stats_fill(uint8_t *out, uint16_t outLen) {
+    if (outLen < sizeof(app_stats_t)) {
+        return 0;
+    }
+
+    // Member accesses through the packed type are split into byte accesses by the compiler
+    app_stats_t *const wire = (app_stats_t *) out;
+    wire->version = STATS_VERSION;
+    wire->ticks = app_stats.ticks;
+    for (uint8_t i = 0; i < STATS_INS_COUNT; i++) {
+        wire->apdus[i] = app_stats.apdus[i];
+    }
+    wire->bytesAppended = app_stats.bytesAppended;
+    wire->txRam = app_stats.txRam;
+    wire->txFlash = app_stats.txFlash;
+    wire->ramMax = app_stats.ramMax;
+    wire->flashMax = app_stats.flashMax;
+    wire->nvmPageWrites = app_stats.nvmPageWrites;
+    for (uint8_t i = 0; i < STATS_ERRORS_COUNT; i++) {
+        wire->parseErrors[i] = app_stats.parseErrors[i];
+    }
+    for (uint8_t i = 0; i < STATS_ITEMS_COUNT; i++) {
+        wire->renders[i] = app_stats.renders[i];
+    }
+    wire->pubkeyCacheHits = app_stats.pubkeyCacheHits;
+    wire->pubkeyCacheMisses = app_stats.pubkeyCacheMisses;
+    wire->lastParseTick = app_stats.lastParseTick;
+    wire->lastSignTick = app_stats.lastSignTick;
+    return sizeof(app_stats_t);
+}
+
+void stats_reset() {
+    MEMZERO(&app_stats, sizeof(app_stats));
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Performance counters kept in RAM since app start, returned by INS_GET_STATS.
+// Only built with APP_STATS (make APP_STATS=1, CMake option STATS): otherwise the
+// STATS_* macros expand to nothing and the command is not supported.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(APP_STATS)
+
+#define STATS_VERSION           1
+#define STATS_INS_COUNT         16  // last bucket counts any higher INS
+#define STATS_ERRORS_COUNT      32  // indexed by parser_error_t
+#define STATS_ITEMS_COUNT       16  // pages shown by display item, last bucket counts any higher item
+// Flash write granularity used to turn NVM writes into page writes
+#define STATS_NVM_PAGE_SIZE     64
+
+/// Counters kept since app start. Naturally aligned: the Cortex-M0 faults on unaligned word access.
+/// Counters saturate instead of wrapping
+typedef struct {
+    uint32_t ticks;                             // ticker events since app start (100 ms each)
+    uint32_t apdus[STATS_INS_COUNT];            // by INS
+    uint32_t bytesAppended;                     // transaction bytes received
+    uint32_t txRam;                             // transactions parsed from the RAM buffer
+    uint32_t txFlash;                           // transactions that spilled to the flash buffer
+    uint16_t ramMax;                            // largest use of the RAM buffer
+    uint16_t flashMax;                          // largest use of the flash buffer
+    uint32_t nvmPageWrites;
+    uint16_t parseErrors[STATS_ERRORS_COUNT];   // parse and validation failures by parser_error_t
+    uint16_t renders[STATS_ITEMS_COUNT];        // review pages put on screen, by display item
+    uint32_t pubkeyCacheHits;
+    uint32_t pubkeyCacheMisses;
+    uint32_t lastParseTick;
+    uint32_t lastSignTick;
+} app_stats_counters_t;
+
+/// Response layout of INS_GET_STATS, little endian: a version byte and the counters.
+/// Only written by stats_fill, field by field
+typedef struct {
+    uint8_t version;
+    uint32_t ticks;
+    uint32_t apdus[STATS_INS_COUNT];
+    uint32_t bytesAppended;
+    uint32_t txRam;
+    uint32_t txFlash;
+    uint16_t ramMax;
+    uint16_t flashMax;
+    uint32_t nvmPageWrites;
+    uint16_t parseErrors[STATS_ERRORS_COUNT];
+    uint16_t renders[STATS_ITEMS_COUNT];
+    uint32_t pubkeyCacheHits;
+    uint32_t pubkeyCacheMisses;
+    uint32_t lastParseTick;
+    uint32_t lastSignTick;
+} __attribute__((packed)) app_stats_t;
+
+extern app_stats_counters_t app_stats;
+
+#define STATS_INC(FIELD)                    stats_inc32(&app_stats.FIELD)
+#define STATS_APDU(INS)                     stats_inc32(&app_stats.apdus[(INS) < STATS_INS_COUNT ? (INS) : STATS_INS_COUNT - 1])
+#define STATS_PARSE_ERROR(ERR)              stats_inc16(&app_stats.parseErrors[(ERR) < STATS_ERRORS_COUNT ? (ERR) : STATS_ERRORS_COUNT - 1])
+#define STATS_RENDER(IDX)                   stats_inc16(&app_stats.renders[(IDX) < STATS_ITEMS_COUNT ? (IDX) : STATS_ITEMS_COUNT - 1])
+#define STATS_APPENDED(LEN)                 stats_add32(&app_stats.bytesAppended, (LEN))
+#define STATS_NVM_WRITE(DST, LEN)           stats_nvm_write((const void *) (DST), (LEN))
+#define STATS_MARK(FIELD)                   (app_stats.FIELD = app_stats.ticks)
+
+void stats_inc32(uint32_t *counter);
+
+void stats_inc16(uint16_t *counter);
+
+void stats_add32(uint32_t *counter, uint32_t value);
+
+/// Counts the flash pages touched by a write of len bytes at dst
+void stats_nvm_write(const void *dst, uint32_t len);
+
+/// Records the buffer that holds a complete transaction
+void stats_buffer_use(uint8_t inFlash, uint16_t ramPos, uint16_t flashPos);
+
+/// Writes the counters to out in the app_stats_t layout
+/// \return bytes written, 0 if outLen is too small
+uint16_t stats_fill(uint8_t *out, uint16_t outLen);
+
+void stats_reset();
+
+#else
+
+#define STATS_INC(FIELD)
+#define STATS_APDU(INS)
+#define STATS_PARSE_ERROR(ERR)
+#define STATS_RENDER(IDX)
+#define STATS_APPENDED(LEN)
+#define STATS_NVM_WRITE(DST, LEN)
+#define STATS_MARK(FIELD)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,153 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+
+#if defined(APP_TRACE) && !defined(TARGET_NANOS) && !defined(TARGET_NANOX)
+
+#include "trace.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct {
+    const char *name;
+    uint64_t ts;            // ns, CLOCK_MONOTONIC
+    char phase;
+} trace_event_t;
+
+typedef struct trace_ring_t {
+    trace_event_t events[TRACE_RING_SIZE];
+    _Atomic uint32_t head;  // total events written, only the owner thread writes it
+    uint32_t tid;
+    struct trace_ring_t *next;
+} trace_ring_t;
+
+// Rings are never freed: a dump may run after their thread is gone
+static _Atomic(trace_ring_t *) trace_rings = NULL;
+static _Atomic uint32_t trace_tids = 0;
+static atomic_bool trace_on = false;
+static _Thread_local trace_ring_t *trace_ring = NULL;
+
+static trace_ring_t *trace_ring_get() {
+    if (trace_ring != NULL) {
+        return trace_ring;
+    }
+
+    trace_ring_t *ring = calloc(1, sizeof(trace_ring_t));
+    if (ring == NULL) {
+        return NULL;
+    }
+    ring->tid = atomic_fetch_add(&trace_tids, 1) + 1;
+
+    ring->next = atomic_load(&trace_rings);
+    while (!atomic_compare_exchange_weak(&trace_rings, &ring->next, ring)) {}
+
+    trace_ring = ring;
+    return ring;
+}
+
+void trace_event(const char *name, char phase) {
+    if (!atomic_load_explicit(&trace_on, memory_order_relaxed)) {
+        return;
+    }
+
+    trace_ring_t *ring = trace_ring_get();
+    if (ring == NULL) {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    trace_event_t *ev = &ring->events[head % TRACE_RING_SIZE];
+    ev->name = name;
+    ev->ts = (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+    ev->phase = phase;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void trace_scope_end(const char **name) {
+    trace_event(*name, 'E');
+}
+
+void trace_enable(bool enabled) {
+    atomic_store(&trace_on, enabled);
+}
+
+bool trace_enabled() {
+    return atomic_load(&trace_on);
+}
+
+void trace_reset() {
+    for (trace_ring_t *r = atomic_load(&trace_rings); r != NULL; r = r->next) {
+        atomic_store(&r->head, 0);
+    }
+}
+
+static uint32_t trace_ring_count(const trace_ring_t *r) {
+    const uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    return head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+}
+
+uint32_t trace_count() {
+    uint32_t count = 0;
+    for (trace_ring_t *r = atomic_load(&trace_rings); r != NULL; r = r->next) {
+        count += trace_ring_count(r);
+    }
+    return count;
+}
+
+uint32_t trace_write_chrome(FILE *f) {
+    // Timestamps are written relative to the oldest event
+    uint64_t base = UINT64_MAX;
+    for (trace_ring_t *r = atomic_load(&trace_rings); r != NULL; r = r->next) {
+        const uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (head != 0) {
+            const uint64_t ts = r->events[(head - trace_ring_count(r)) % TRACE_RING_SIZE].ts;
+            base = ts < base ? ts : base;
+        }
+    }
+
+    uint32_t written = 0;
+    fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    for (trace_ring_t *r = atomic_load(&trace_rings); r != NULL; r = r->next) {
+        const uint32_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+        uint32_t depth = 0;
+
+        for (uint32_t i = head - trace_ring_count(r); i != head; i++) {
+            const trace_event_t *ev = &r->events[i % TRACE_RING_SIZE];
+            // The begin of an end may have been overwritten
+            if (ev->phase == 'E') {
+                if (depth == 0) {
+                    continue;
+                }
+                depth--;
+            } else {
+                depth++;
+            }
+
+            fprintf(f, "%s\n{\"name\":\"%s\",\"cat\":\"iov\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                    written == 0 ? "" : ",", ev->name, ev->phase,
+                    (double) (ev->ts - base) / 1000.0, r->tid);
+            written++;
+        }
+    }
+    fprintf(f, "\n]}\n");
+
+    return written;
+}
+
+#endif
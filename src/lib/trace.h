@@ -0,0 +1,78 @@
+/*******************************************************************************
+*  (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Tracing hooks around the expensive stages (chunk processing, parsing, rendering, signing).
+//
+// Firmware builds never define APP_TRACE: the macros expand to nothing.
+// Host builds (CMake option TRACE) record begin / end events with a monotonic timestamp into a
+// per-thread ring buffer once trace_enable(true) was called. trace_write_chrome() writes the
+// recorded events as chrome://tracing / Perfetto JSON.
+//
+// Names must be string literals (or live as long as the trace): only the pointer is recorded.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(APP_TRACE)
+
+/// Events kept per thread, the oldest ones are overwritten
+#define TRACE_RING_SIZE     (1u << 14u)
+
+#define TRACE_BEGIN(NAME)   trace_event((NAME), 'B')
+#define TRACE_END(NAME)     trace_event((NAME), 'E')
+
+/// Begin here, end when the enclosing scope is left (functions with many return paths)
+#define TRACE_SCOPE(NAME) \
+    const char *__trace_scope __attribute__((cleanup(trace_scope_end), unused)) = (NAME); \
+    TRACE_BEGIN(NAME)
+
+/// Records one event for the calling thread. Lock free: every thread writes to its own ring
+void trace_event(const char *name, char phase);
+
+void trace_scope_end(const char **name);
+
+/// Recording is off by default, the hooks then cost a function call and a load
+void trace_enable(bool enabled);
+
+bool trace_enabled();
+
+/// Drops the recorded events of all threads. Threads must not be recording
+void trace_reset();
+
+/// Number of events currently held by all rings
+uint32_t trace_count();
+
+/// Writes the events of all threads as Chrome trace JSON. Threads must not be recording
+/// \return number of events written
+uint32_t trace_write_chrome(FILE *f);
+
+#else
+
+#define TRACE_BEGIN(NAME)
+#define TRACE_END(NAME)
+#define TRACE_SCOPE(NAME)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
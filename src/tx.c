@@ -17,18 +17,13 @@
 #include "tx.h"
 #include "apdu_codes.h"
 #include "buffering.h"
+#include "lib/crypto.h"
 #include "lib/parser.h"
+#include "lib/stats.h"
+#include "lib/trace.h"
 #include <string.h>
 #include "zxmacros.h"
 
-#if defined(TARGET_NANOX)
-#define RAM_BUFFER_SIZE 8192
-#define FLASH_BUFFER_SIZE 16384
-#elif defined(TARGET_NANOS)
-#define RAM_BUFFER_SIZE 384
-#define FLASH_BUFFER_SIZE 8192
-#endif
-
 // Ram
 uint8_t ram_buffer[RAM_BUFFER_SIZE];
 
@@ -44,9 +39,47 @@ storage_t N_appdata_impl __attribute__ ((aligned(64)));
 #elif defined(TARGET_NANOX)
 storage_t const N_appdata_impl __attribute__ ((aligned(64)));
 #define N_appdata (*(volatile storage_t *)PIC(&N_appdata_impl))
+
+#else
+storage_t N_appdata_impl;
+#define N_appdata N_appdata_impl
+#endif
+
+// Settings
+typedef struct {
+    uint8_t reviewMode;
+} settings_t;
+
+#if defined(TARGET_NANOS)
+settings_t N_settings_impl __attribute__ ((aligned(64)));
+#define N_settings (*(settings_t *)PIC(&N_settings_impl))
+
+#elif defined(TARGET_NANOX)
+settings_t const N_settings_impl __attribute__ ((aligned(64)));
+#define N_settings (*(volatile settings_t *)PIC(&N_settings_impl))
+
+#else
+settings_t N_settings_impl;
+#define N_settings N_settings_impl
 #endif
 
 parser_context_t ctx_parsed_tx;
+parser_tx_t parser_tx_obj;
+
+// Batch of transactions stored back to back in the transaction buffer
+// Each entry is prefixed with its length (uint16, little endian)
+typedef struct {
+    uint8_t count;
+    int8_t parsedIdx;
+    uint16_t offset[TX_BATCH_COUNT_MAX];
+    uint16_t length[TX_BATCH_COUNT_MAX];
+    uint8_t numItems[TX_BATCH_COUNT_MAX];
+} tx_batch_t;
+
+tx_batch_t tx_batch;
+
+// Review mode of the transaction being reviewed. Starts from the setting on every parse
+tx_review_mode_e tx_review_mode = tx_review_full;
 
 void tx_initialize() {
     buffering_init(
@@ -59,10 +92,35 @@ void tx_initialize() {
 
 void tx_reset() {
     buffering_reset();
+    tx_batch.count = 0;
+    tx_batch.parsedIdx = -1;
 }
 
 uint32_t tx_append(unsigned char *buffer, uint32_t length) {
-    return buffering_append(buffer, length);
+#if defined(APP_STATS)
+    const buffer_state_t *flash = buffering_get_flash_buffer();
+    const uint16_t flashPos = flash->pos;
+#endif
+
+    TRACE_BEGIN("buffering_append");
+    const uint32_t added = buffering_append(buffer, length);
+    TRACE_END("buffering_append");
+
+    STATS_APPENDED(added);
+    STATS_NVM_WRITE(flash->data + flashPos, flash->pos - flashPos);
+    return added;
+}
+
+tx_review_mode_e tx_settings_get_review_mode() {
+    return N_settings.reviewMode == tx_review_compact ? tx_review_compact : tx_review_full;
+}
+
+void tx_settings_set_review_mode(tx_review_mode_e mode) {
+    if (N_settings.reviewMode == mode) {
+        return;
+    }
+    SET_NV(&N_settings.reviewMode, uint8_t, mode);
+    STATS_NVM_WRITE(&N_settings.reviewMode, 1);
 }
 
 uint32_t tx_get_buffer_length() {
@@ -73,29 +131,242 @@ uint8_t *tx_get_buffer() {
     return buffering_get_buffer()->data;
 }
 
+#if defined(APP_STATS)
+__Z_INLINE void tx_stats_parsed() {
+    STATS_MARK(lastParseTick);
+    stats_buffer_use(buffering_get_flash_buffer()->in_use,
+                     buffering_get_ram_buffer()->pos,
+                     buffering_get_flash_buffer()->pos);
+}
+#else
+#define tx_stats_parsed()
+#endif
+
+// True when the compact layout of the parsed transaction has fewer items than the full one
+__Z_INLINE bool_t tx_review_collapses() {
+    ctx_parsed_tx.reviewMode = parser_review_full;
+    const uint8_t fullItems = parser_getNumItems(&ctx_parsed_tx);
+    ctx_parsed_tx.reviewMode = parser_review_compact;
+    const uint8_t compactItems = parser_getNumItems(&ctx_parsed_tx);
+    ctx_parsed_tx.reviewMode = tx_review_mode;
+    return compactItems < fullItems;
+}
+
 const char *tx_parse(bool_t isMainnet) {
+    tx_batch.count = 0;
+    tx_batch.parsedIdx = -1;
+    tx_review_mode = tx_settings_get_review_mode();
+    tx_stats_parsed();
+
     uint8_t err = parser_parse(
         &ctx_parsed_tx,
         tx_get_buffer(),
-        tx_get_buffer_length());
+        tx_get_buffer_length(),
+        &parser_tx_obj);
+    ctx_parsed_tx.reviewMode = tx_review_mode;
 
     if (err != parser_ok) {
+        STATS_PARSE_ERROR(err);
         return parser_getErrorDescription(err);
     }
 
     err = parser_validate(&ctx_parsed_tx, isMainnet);
     if (err != parser_ok) {
+        STATS_PARSE_ERROR(err);
         return parser_getErrorDescription(err);
     }
 
+    // Nothing to collapse: "View details" would repeat the same review
+    if (tx_review_mode == tx_review_compact && !tx_review_collapses()) {
+        tx_set_review_mode(tx_review_full);
+    }
+
+    return NULL;
+}
+
+__Z_INLINE uint8_t tx_batch_select(uint8_t batchIdx) {
+    if (tx_batch.parsedIdx == batchIdx) {
+        return parser_ok;
+    }
+
+    tx_batch.parsedIdx = -1;
+    uint8_t err = parser_parse(&ctx_parsed_tx,
+                               tx_batch_get_buffer(batchIdx),
+                               tx_batch_get_buffer_length(batchIdx),
+                               &parser_tx_obj);
+    ctx_parsed_tx.reviewMode = tx_review_mode;
+    if (err == parser_ok) {
+        tx_batch.parsedIdx = batchIdx;
+    }
+
+    return err;
+}
+
+const char *tx_batch_parse(bool_t isMainnet) {
+    const uint8_t *buffer = tx_get_buffer();
+    const uint32_t bufferLen = tx_get_buffer_length();
+
+    tx_batch.count = 0;
+    tx_batch.parsedIdx = -1;
+    tx_review_mode = tx_settings_get_review_mode();
+    tx_stats_parsed();
+
+    uint32_t offset = 0;
+    while (offset < bufferLen) {
+        if (tx_batch.count >= TX_BATCH_COUNT_MAX) {
+            return "Too many transactions";
+        }
+        if (bufferLen - offset < TX_BATCH_LENGTH_PREFIX) {
+            return parser_getErrorDescription(parser_unexpected_buffer_end);
+        }
+
+        const uint16_t txLen = buffer[offset] + (buffer[offset + 1] << 8u);
+        offset += TX_BATCH_LENGTH_PREFIX;
+
+        if (txLen == 0 || txLen > bufferLen - offset) {
+            return parser_getErrorDescription(parser_unexpected_buffer_end);
+        }
+
+        tx_batch.offset[tx_batch.count] = offset;
+        tx_batch.length[tx_batch.count] = txLen;
+        tx_batch.count++;
+        offset += txLen;
+    }
+
+    if (tx_batch.count == 0) {
+        return parser_getErrorDescription(parser_no_data);
+    }
+
+    // Every transaction is validated before review starts
+    bool_t collapses = bool_false;
+    for (uint8_t i = 0; i < tx_batch.count; i++) {
+        uint8_t err = tx_batch_select(i);
+        if (err != parser_ok) {
+            tx_batch.count = 0;
+            STATS_PARSE_ERROR(err);
+            return parser_getErrorDescription(err);
+        }
+
+        err = parser_validate(&ctx_parsed_tx, isMainnet);
+        if (err != parser_ok) {
+            tx_batch.count = 0;
+            STATS_PARSE_ERROR(err);
+            return parser_getErrorDescription(err);
+        }
+
+        tx_batch.numItems[i] = parser_getNumItems(&ctx_parsed_tx);
+        if (tx_review_mode == tx_review_compact && tx_review_collapses()) {
+            collapses = bool_true;
+        }
+    }
+
+    if (tx_review_mode == tx_review_compact && !collapses) {
+        tx_set_review_mode(tx_review_full);
+    }
+
     return NULL;
 }
 
-uint8_t tx_getNumItems() {
-    return parser_getNumItems(&ctx_parsed_tx);
+uint8_t tx_batch_get_count() {
+    return tx_batch.count;
+}
+
+const uint8_t *tx_batch_get_buffer(uint8_t batchIdx) {
+    return tx_get_buffer() + tx_batch.offset[batchIdx];
+}
+
+uint16_t tx_batch_get_buffer_length(uint8_t batchIdx) {
+    return tx_batch.length[batchIdx];
+}
+
+tx_review_mode_e tx_get_review_mode() {
+    return tx_review_mode;
+}
+
+void tx_set_review_mode(tx_review_mode_e mode) {
+    tx_review_mode = mode;
+    ctx_parsed_tx.reviewMode = mode;
+
+    // Item counts of a batch depend on the mode. Transactions were validated by tx_batch_parse
+    for (uint8_t i = 0; i < tx_batch.count; i++) {
+        if (tx_batch_select(i) == parser_ok) {
+            tx_batch.numItems[i] = parser_getNumItems(&ctx_parsed_tx);
+        }
+    }
+}
+
+__Z_INLINE uint16_t tx_getNumTxItems() {
+    if (tx_batch.count == 0) {
+        return parser_getNumItems(&ctx_parsed_tx);
+    }
+
+    // Summary + (header + items) per transaction
+    uint16_t numItems = 1;
+    for (uint8_t i = 0; i < tx_batch.count; i++) {
+        numItems += 1 + tx_batch.numItems[i];
+    }
+    return numItems;
+}
+
+uint16_t tx_getNumItems() {
+    // INS_SIGN_MULTIPATH: one item per signing path after the transaction
+    return tx_getNumTxItems() + hdPathListCount;
+}
+
+__Z_INLINE tx_error_t tx_signer_getItem(uint8_t signerIdx,
+                                        char *outKey, uint16_t outKeyLen,
+                                        char *outVal, uint16_t outValLen,
+                                        uint8_t *pageCount) {
+    *pageCount = 1;
+    // Paths were validated as 44'/234'/i'
+    const uint32_t *path = hdPathList[signerIdx];
+    snprintf(outKey, outKeyLen, "Sign with [%d/%d]", signerIdx + 1, hdPathListCount);
+    snprintf(outVal, outValLen, "%u'/%u'/%u'",
+             (unsigned) (path[0] & 0x7FFFFFFFu),
+             (unsigned) (path[1] & 0x7FFFFFFFu),
+             (unsigned) (path[2] & 0x7FFFFFFFu));
+    return tx_no_error;
 }
 
-tx_error_t tx_getItem(int8_t displayIdx,
+// Batch summary and transaction headers. Items of a transaction are only mapped to their
+// parser index: tx_getItem renders them, with their page
+__Z_INLINE tx_error_t tx_batch_getItem(int16_t displayIdx,
+                                       char *outKey, uint16_t outKeyLen,
+                                       char *outVal, uint16_t outValLen,
+                                       uint8_t *pageCount,
+                                       int8_t *parserDisplayIdx) {
+    *pageCount = 1;
+    *parserDisplayIdx = -1;
+
+    if (displayIdx == 0) {
+        snprintf(outKey, outKeyLen, "Batch");
+        snprintf(outVal, outValLen, "%d transactions", tx_batch.count);
+        return tx_no_error;
+    }
+    displayIdx--;
+
+    for (uint8_t i = 0; i < tx_batch.count; i++) {
+        if (displayIdx == 0) {
+            snprintf(outKey, outKeyLen, "Transaction");
+            snprintf(outVal, outValLen, "[%d/%d]", i + 1, tx_batch.count);
+            return tx_no_error;
+        }
+        displayIdx--;
+
+        if (displayIdx < tx_batch.numItems[i]) {
+            if (tx_batch_select(i) != parser_ok) {
+                return (tx_error_t) parser_unexepected_error;
+            }
+            *parserDisplayIdx = (int8_t) displayIdx;
+            return tx_no_error;
+        }
+        displayIdx -= tx_batch.numItems[i];
+    }
+
+    return tx_no_data;
+}
+
+tx_error_t tx_getItem(int16_t displayIdx,
                       char *outKey, uint16_t outKeyLen,
                       char *outVal, uint16_t outValLen,
                       uint8_t pageIdx, uint8_t *pageCount) {
@@ -105,11 +376,31 @@ tx_error_t tx_getItem(int8_t displayIdx,
         return tx_no_data;
     }
 
-    err = (tx_error_t) parser_getItem(&ctx_parsed_tx,
-                                      displayIdx,
-                                      outKey, outKeyLen,
-                                      outVal, outValLen,
-                                      pageIdx, pageCount);
+    const uint16_t numTxItems = tx_getNumTxItems();
+    if (displayIdx >= numTxItems && displayIdx < numTxItems + hdPathListCount) {
+        if (pageIdx > 0) {
+            return tx_no_data;
+        }
+        return tx_signer_getItem(displayIdx - numTxItems, outKey, outKeyLen, outVal, outValLen, pageCount);
+    }
+
+    int8_t parserDisplayIdx = (int8_t) displayIdx;
+    if (tx_batch.count > 0) {
+        err = tx_batch_getItem(displayIdx,
+                               outKey, outKeyLen,
+                               outVal, outValLen,
+                               pageCount,
+                               &parserDisplayIdx);
+        if (err != tx_no_error || parserDisplayIdx < 0) {
+            return err;
+        }
+    }
+
+    const parser_error_t parserErr = parser_getItem(&ctx_parsed_tx,
+                                                    parserDisplayIdx,
+                                                    outKey, outKeyLen,
+                                                    outVal, outValLen,
+                                                    pageIdx, pageCount);
 
     if (*pageCount > 1) {
         uint8_t keyLen = strlen(outKey);
@@ -119,13 +410,13 @@ tx_error_t tx_getItem(int8_t displayIdx,
     }
 
     // Convert error codes
-    if (err == parser_no_data ||
-        err == parser_display_idx_out_of_range ||
-        err == parser_display_page_out_of_range)
+    if (parserErr == parser_no_data ||
+        parserErr == parser_display_idx_out_of_range ||
+        parserErr == parser_display_page_out_of_range)
         return tx_no_data;
 
-    if (err == parser_ok)
+    if (parserErr == parser_ok)
         return tx_no_error;
 
-    return err;
+    return (tx_error_t) parserErr;
 }
@@ -24,6 +24,26 @@ typedef enum {
     tx_no_data = 1,
 } tx_error_t;
 
+typedef enum {
+    // One screen per field
+    tx_review_full = 0,
+    // Repeated fields collapsed: one item per participant, multisig IDs packed in a list
+    tx_review_compact = 1,
+} tx_review_mode_e;
+
+#if defined(TARGET_NANOX)
+// Transaction buffer: a transaction larger than RAM_BUFFER_SIZE is moved to flash
+#define RAM_BUFFER_SIZE 8192
+#define FLASH_BUFFER_SIZE 16384
+#else
+// Nano S sizes: also used by host builds, so buffering limits match the smallest device
+#define RAM_BUFFER_SIZE 384
+#define FLASH_BUFFER_SIZE 8192
+#endif
+
+#define TX_BATCH_COUNT_MAX        16
+#define TX_BATCH_LENGTH_PREFIX    2
+
 void tx_initialize();
 
 /// Clears the transaction buffer
@@ -49,11 +69,39 @@ uint8_t *tx_get_buffer();
 /// \return It returns NULL if json is valid or error message otherwise.
 const char *tx_parse(bool_t isMainnet);
 
+/// Parse a batch of transactions stored in transaction buffer
+/// Each transaction is prefixed by its length (uint16 little endian)
+/// \return It returns NULL if all transactions are valid or error message otherwise.
+const char *tx_batch_parse(bool_t isMainnet);
+
+/// Returns the number of transactions in the current batch (0 when not in batch mode)
+uint8_t tx_batch_get_count();
+
+/// Returns the buffer of a given transaction in the batch
+const uint8_t *tx_batch_get_buffer(uint8_t batchIdx);
+
+/// Returns the size of a given transaction in the batch
+uint16_t tx_batch_get_buffer_length(uint8_t batchIdx);
+
+/// Returns the review mode chosen in the settings menu (kept in flash, full by default)
+tx_review_mode_e tx_settings_get_review_mode();
+
+/// Stores the review mode used for every following transaction
+void tx_settings_set_review_mode(tx_review_mode_e mode);
+
+/// Returns the review mode of the current transaction. Compact falls back to full when it
+/// would not collapse any field
+tx_review_mode_e tx_get_review_mode();
+
+/// Changes the review mode of the current transaction only (e.g. to show every detail)
+/// Item indexes change, so the review has to start over
+void tx_set_review_mode(tx_review_mode_e mode);
+
 /// Return the number of items in the transaction
-uint8_t tx_getNumItems();
+uint16_t tx_getNumItems();
 
 /// Gets an specific item from the transaction (including paging)
-tx_error_t tx_getItem(int8_t displayIdx,
+tx_error_t tx_getItem(int16_t displayIdx,
                            char *outKey, uint16_t outKeyLen,
                            char *outValue, uint16_t outValueLen,
                            uint8_t pageIdx, uint8_t *pageCount);
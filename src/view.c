@@ -26,12 +26,17 @@
 #include "zxmacros.h"
 #include "view_templates.h"
 #include "tx.h"
+#include "lib/stats.h"
 
 #include <string.h>
 #include <stdio.h>
 
 view_t viewdata;
 
+#if defined(VIEW_LOOKAHEAD)
+view_lookahead_t view_lookahead;
+#endif
+
 void h_address_accept(unsigned int _) {
     UNUSED(_);
     view_idle_show(0);
@@ -49,13 +54,15 @@ void h_error_accept(unsigned int _) {
 void h_sign_accept(unsigned int _) {
     UNUSED(_);
 
-    const uint8_t replyLen = app_sign();
+    const uint16_t replyLen = app_sign();
 
     view_idle_show(0);
     UX_WAIT();
 
     if (replyLen > 0) {
-        set_code(G_io_apdu_buffer, replyLen, APDU_CODE_OK);
+        // Multi-path signatures fill 256 bytes, past the 8-bit offset of set_code
+        G_io_apdu_buffer[replyLen] = APDU_CODE_OK >> 8u;
+        G_io_apdu_buffer[replyLen + 1] = APDU_CODE_OK & 0xFFu;
         io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, replyLen + 2);
     } else {
         set_code(G_io_apdu_buffer, 0, APDU_CODE_SIGN_VERIFY_ERROR);
@@ -65,6 +72,7 @@ void h_sign_accept(unsigned int _) {
 
 void h_sign_reject(unsigned int _) {
     UNUSED(_);
+    app_sign_clear();
     view_idle_show(0);
     UX_WAIT();
 
@@ -72,59 +80,161 @@ void h_sign_reject(unsigned int _) {
     io_exchange(CHANNEL_APDU | IO_RETURN_AFTER_TX, 2);
 }
 
-void h_review_init() {
-    viewdata.idx = 0;
-    viewdata.pageIdx = 0;
-    viewdata.pageCount = 1;
+void h_review_details(unsigned int _) {
+    UNUSED(_);
+    // Review the same transaction again with one item per field
+    tx_set_review_mode(tx_review_full);
+    view_sign_show_impl();
 }
 
-void h_review_increase() {
-    viewdata.pageIdx++;
-    if (viewdata.pageIdx >= viewdata.pageCount) {
-        viewdata.idx++;
-        viewdata.pageIdx = 0;
+void h_review_mode_select(tx_review_mode_e mode) {
+    tx_settings_set_review_mode(mode);
+    h_review_mode_label();
+}
+
+void h_review_mode_label() {
+    snprintf(viewdata.value, MAX_CHARS_PER_VALUE1_LINE, "%s",
+             tx_settings_get_review_mode() == tx_review_compact ? "Compact" : "Full");
+}
+
+__Z_INLINE void h_review_increase_pos(int16_t *idx, int8_t *pageIdx, uint8_t pageCount) {
+    (*pageIdx)++;
+    if (*pageIdx >= pageCount) {
+        (*idx)++;
+        *pageIdx = 0;
     }
 }
 
-void h_review_decrease() {
-    viewdata.pageIdx--;
-    if (viewdata.pageIdx < 0) {
-        viewdata.idx--;
-        viewdata.pageIdx = 0;
+__Z_INLINE void h_review_decrease_pos(int16_t *idx, int8_t *pageIdx) {
+    (*pageIdx)--;
+    if (*pageIdx < 0) {
+        (*idx)--;
+        *pageIdx = 0;
     }
 }
 
-view_error_t h_review_update_data() {
+// Renders the page at idx / pageIdx. Items without pages are skipped, so both can move forward
+__Z_INLINE view_error_t h_review_render(int16_t *idx, int8_t *pageIdx, uint8_t *pageCount,
+                                        char *key, char *value) {
     tx_error_t err = tx_no_error;
 
     do {
-        err = tx_getItem(viewdata.idx,
-                         viewdata.key, MAX_CHARS_PER_KEY_LINE,
-                         viewdata.value, MAX_CHARS_PER_VALUE1_LINE,
-                         viewdata.pageIdx, &viewdata.pageCount);
+        err = tx_getItem(*idx,
+                         key, MAX_CHARS_PER_KEY_LINE,
+                         value, MAX_CHARS_PER_VALUE1_LINE,
+                         *pageIdx, pageCount);
 
         if (err == tx_no_data) {
             return view_no_data;
         }
 
-        if (viewdata.pageCount == 0) {
-            h_review_increase();
+        if (*pageCount == 0) {
+            h_review_increase_pos(idx, pageIdx, *pageCount);
         }
-    } while (viewdata.pageCount == 0);
+    } while (*pageCount == 0);
 
     if (err != tx_no_error) {
         return view_error_detected;
     }
 
-    splitValueField();
     return view_no_error;
 }
 
+void h_review_init() {
+    viewdata.idx = 0;
+    viewdata.pageIdx = 0;
+    viewdata.pageCount = 1;
+#if defined(VIEW_LOOKAHEAD)
+    // Pages of a previous transaction or review mode are stale
+    MEMZERO(&view_lookahead, sizeof(view_lookahead));
+    view_lookahead.active = 1;
+#endif
+}
+
+void h_review_increase() {
+    h_review_increase_pos(&viewdata.idx, &viewdata.pageIdx, viewdata.pageCount);
+}
+
+void h_review_decrease() {
+    h_review_decrease_pos(&viewdata.idx, &viewdata.pageIdx);
+}
+
+#if defined(VIEW_LOOKAHEAD)
+__Z_INLINE view_lookahead_page_t *h_review_lookahead_find(int16_t idx, int8_t pageIdx) {
+    for (uint8_t i = 0; i < VIEW_LOOKAHEAD_PAGES; i++) {
+        view_lookahead_page_t *page = &view_lookahead.pages[i];
+        if (page->valid && page->fromIdx == idx && page->fromPageIdx == pageIdx) {
+            return page;
+        }
+    }
+    return NULL;
+}
+#endif
+
+view_error_t h_review_update_data() {
+#if defined(VIEW_LOOKAHEAD)
+    const view_lookahead_page_t *page = h_review_lookahead_find(viewdata.idx, viewdata.pageIdx);
+    if (page != NULL) {
+        view_lookahead.hits++;
+        viewdata.idx = page->idx;
+        viewdata.pageIdx = page->pageIdx;
+        viewdata.pageCount = page->pageCount;
+        MEMCPY(viewdata.key, page->key, MAX_CHARS_PER_KEY_LINE);
+        MEMCPY(viewdata.value, page->value, MAX_CHARS_PER_VALUE1_LINE);
+        if (page->err == view_no_error) {
+            STATS_RENDER(viewdata.idx);
+            splitValueField();
+        }
+        return page->err;
+    }
+#endif
+
+    const view_error_t err = h_review_render(&viewdata.idx, &viewdata.pageIdx, &viewdata.pageCount,
+                                             viewdata.key, viewdata.value);
+    if (err == view_no_error) {
+        // Only pages put on screen are counted, not look-ahead renders
+        STATS_RENDER(viewdata.idx);
+        splitValueField();
+    }
+    return err;
+}
+
+void view_review_prefetch() {
+#if defined(VIEW_LOOKAHEAD)
+    if (!view_lookahead.active) {
+        return;
+    }
+
+    // Where the right (pages[0]) and left (pages[1]) buttons lead from the page on screen
+    int16_t idx[VIEW_LOOKAHEAD_PAGES] = {viewdata.idx, viewdata.idx};
+    int8_t pageIdx[VIEW_LOOKAHEAD_PAGES] = {viewdata.pageIdx, viewdata.pageIdx};
+    h_review_increase_pos(&idx[0], &pageIdx[0], viewdata.pageCount);
+    h_review_decrease_pos(&idx[1], &pageIdx[1]);
+
+    // At most one page per ticker event
+    for (uint8_t i = 0; i < VIEW_LOOKAHEAD_PAGES; i++) {
+        if (idx[i] < 0 || h_review_lookahead_find(idx[i], pageIdx[i]) != NULL) {
+            continue;
+        }
+
+        view_lookahead_page_t *page = &view_lookahead.pages[i];
+        page->valid = 0;
+        page->fromIdx = page->idx = idx[i];
+        page->fromPageIdx = page->pageIdx = pageIdx[i];
+        page->err = h_review_render(&page->idx, &page->pageIdx, &page->pageCount, page->key, page->value);
+        page->valid = 1;
+        return;
+    }
+#endif
+}
+
 view_error_t h_addr_update_item(uint8_t idx) {
     MEMZERO(viewdata.addr, MAX_CHARS_ADDR);
     switch (idx) {
         case 0:
-            snprintf(viewdata.addr, MAX_CHARS_ADDR, "%s", (char *) (G_io_apdu_buffer + PK_LEN));
+            if (snprintf(viewdata.addr, MAX_CHARS_ADDR, "%s", (char *) (G_io_apdu_buffer + PK_LEN)) >= MAX_CHARS_ADDR) {
+                return view_error_detected;
+            }
             break;
         case 1:
             snprintf(viewdata.addr, MAX_CHARS_ADDR, "%d%s%d%s%d%s",
@@ -145,6 +255,10 @@ void view_init(void) {
 }
 
 void view_idle_show(unsigned int ignored) {
+    UNUSED(ignored);
+#if defined(VIEW_LOOKAHEAD)
+    view_lookahead.active = 0;
+#endif
     view_idle_show_impl();
 }
 
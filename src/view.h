@@ -40,3 +40,6 @@ void view_address_show();
 
 // Shows review screen + later sign menu
 void view_sign_show();
+
+// Renders the review pages next to the one on screen. Called from ticker events
+void view_review_prefetch();
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "tx.h"
 
 #define MENU_MAIN_APP_LINE1 "IOV"
 
@@ -56,13 +57,42 @@ typedef struct {
             char addr[MAX_CHARS_ADDR];
         };
     };
-    int8_t idx;
+    int16_t idx;
     int8_t pageIdx;
     uint8_t pageCount;
 } view_t;
 
 extern view_t viewdata;
 
+#if !defined(TARGET_NANOX)
+// Pages next to the one on screen are rendered on ticker events, so button presses only copy them.
+// Nano X pages inside the SDK flow and its value buffer is too large to keep copies
+#define VIEW_LOOKAHEAD
+#define VIEW_LOOKAHEAD_PAGES        2
+
+typedef struct {
+    uint8_t valid;
+    // Position asked for (after h_review_increase / h_review_decrease)
+    int16_t fromIdx;
+    int8_t fromPageIdx;
+    // Position rendered. Items without pages are skipped
+    int16_t idx;
+    int8_t pageIdx;
+    uint8_t pageCount;
+    uint8_t err;    // view_error_t
+    char key[MAX_CHARS_PER_KEY_LINE];
+    char value[MAX_CHARS_PER_VALUE1_LINE];
+} view_lookahead_page_t;
+
+typedef struct {
+    uint8_t active;     // a review is on screen
+    uint16_t hits;
+    view_lookahead_page_t pages[VIEW_LOOKAHEAD_PAGES];
+} view_lookahead_t;
+
+extern view_lookahead_t view_lookahead;
+#endif
+
 typedef enum {
     view_no_error = 0,
     view_no_data = 1,
@@ -104,6 +134,15 @@ void h_sign_accept(unsigned int _);
 
 void h_sign_reject(unsigned int _);
 
+/// Restarts the review of a compact transaction with every detail
+void h_review_details(unsigned int _);
+
+/// Stores the review mode chosen in the settings menu and updates h_review_mode_label
+void h_review_mode_select(tx_review_mode_e mode);
+
+/// Writes the name of the stored review mode to viewdata.value
+void h_review_mode_label();
+
 void h_review_init();
 
 void h_review_increase();
@@ -41,13 +41,34 @@ void os_exit(uint32_t id) {
     os_sched_exit(0);
 }
 
+void h_review_mode_menu(unsigned int _);
+void h_review_mode_set(unsigned int mode);
+
 const ux_menu_entry_t menu_main[] = {
     {NULL, NULL, 0, &C_icon_app, MENU_MAIN_APP_LINE1, MENU_MAIN_APP_LINE2, 33, 12},
+    {NULL, h_review_mode_menu, 0, NULL, "Review mode", viewdata.value, 0, 0},
     {NULL, NULL, 0, NULL, "v"APPVERSION, NULL, 0, 0},
     {NULL, os_exit, 0, &C_icon_dashboard, "Quit", NULL, 50, 29},
     UX_MENU_END
 };
 
+// Entries are in tx_review_mode_e order
+const ux_menu_entry_t menu_review_mode[] = {
+    {NULL, h_review_mode_set, tx_review_full, NULL, "Full", "Every field", 0, 0},
+    {NULL, h_review_mode_set, tx_review_compact, NULL, "Compact", "Grouped fields", 0, 0},
+    UX_MENU_END
+};
+
+void h_review_mode_menu(unsigned int _) {
+    UNUSED(_);
+    UX_MENU_DISPLAY(tx_settings_get_review_mode(), menu_review_mode, NULL);
+}
+
+void h_review_mode_set(unsigned int mode) {
+    h_review_mode_select((tx_review_mode_e) mode);
+    UX_MENU_DISPLAY(1, menu_main, NULL);
+}
+
 UX_STEP_NOCB_INIT(ux_addr_flow_1_step, paging,
         { h_addr_update_item(CUR_FLOW.index); },
         { .title = "Address", .text = viewdata.addr, });
@@ -72,6 +93,15 @@ const ux_menu_entry_t menu_sign[] = {
     UX_MENU_END
 };
 
+// Compact review: every detail is one click away
+const ux_menu_entry_t menu_sign_compact[] = {
+    {NULL, h_review, 0, NULL, "View transaction", NULL, 0, 0},
+    {NULL, h_review_details, 0, NULL, "View details", NULL, 0, 0},
+    {NULL, h_sign_accept, 0, NULL, "Sign transaction", NULL, 0, 0},
+    {NULL, h_sign_reject, 0, &C_icon_back, "Reject", NULL, 60, 40},
+    UX_MENU_END
+};
+
 static const bagl_element_t view_review[] = {
     UI_BACKGROUND_LEFT_RIGHT_ICONS,
     UI_LabelLine(UIID_LABEL + 0, 0, 8, UI_SCREEN_WIDTH, UI_11PX, UI_WHITE, UI_BLACK, viewdata.key),
@@ -190,6 +220,7 @@ void splitValueField() {
 //////////////////////////
 
 void view_idle_show_impl() {
+    h_review_mode_label();
     UX_MENU_DISPLAY(0, menu_main, NULL);
 }
 
@@ -224,6 +255,10 @@ void view_sign_show_impl() {
 }
 
 void view_sign_show_s(void){
+    if (tx_get_review_mode() == tx_review_compact) {
+        UX_MENU_DISPLAY(0, menu_sign_compact, NULL);
+        return;
+    }
     UX_MENU_DISPLAY(0, menu_sign, NULL);
 }
 
@@ -39,11 +39,15 @@ ux_state_t G_ux;
 bolos_ux_params_t G_ux_params;
 uint8_t flow_inside_loop;
 
+void h_review_mode_toggle();
+
 UX_FLOW_DEF_NOCB(ux_idle_flow_1_step, pbb, { &C_icon_app, MENU_MAIN_APP_LINE1, MENU_MAIN_APP_LINE2,});
+UX_STEP_CB_INIT(ux_idle_flow_2_step, bn, h_review_mode_label(), h_review_mode_toggle(), { "Review mode", viewdata.value, });
 UX_FLOW_DEF_NOCB(ux_idle_flow_3_step, bn, { "Version", APPVERSION, });
 UX_FLOW_DEF_VALID(ux_idle_flow_4_step, pb, os_sched_exit(-1), { &C_icon_dashboard, "Quit",});
 const ux_flow_step_t *const ux_idle_flow [] = {
   &ux_idle_flow_1_step,
+  &ux_idle_flow_2_step,
   &ux_idle_flow_3_step,
   &ux_idle_flow_4_step,
   FLOW_END_STEP,
@@ -96,6 +100,19 @@ const ux_flow_step_t *const ux_sign_flow[] = {
   FLOW_END_STEP,
 };
 
+// Compact review: every detail is one click away
+UX_STEP_VALID(ux_sign_flow_details_step, pbb, h_review_details(0), { &C_icon_eye, "View", "Details" });
+const ux_flow_step_t *const ux_sign_compact_flow[] = {
+  &ux_sign_flow_1_step,
+  &ux_sign_flow_2_start_step,
+  &ux_sign_flow_2_step,
+  &ux_sign_flow_2_end_step,
+  &ux_sign_flow_details_step,
+  &ux_sign_flow_3_step,
+  &ux_sign_flow_4_step,
+  FLOW_END_STEP,
+};
+
 //////////////////////////
 //////////////////////////
 //////////////////////////
@@ -177,6 +194,11 @@ void h_review_loop_end() {
     ux_flow_relayout();
 }
 
+void h_review_mode_toggle() {
+    h_review_mode_select(tx_settings_get_review_mode() == tx_review_compact ? tx_review_full : tx_review_compact);
+    ux_flow_init(0, ux_idle_flow, &ux_idle_flow_2_step);
+}
+
 void splitValueField() {}
 
 //////////////////////////
@@ -216,6 +238,10 @@ void view_sign_show_impl(){
     if(G_ux.stack_count == 0) {
         ux_stack_push();
     }
+    if (tx_get_review_mode() == tx_review_compact) {
+        ux_flow_init(0, ux_sign_compact_flow, NULL);
+        return;
+    }
     ux_flow_init(0, ux_sign_flow, NULL);
 }
 
@@ -0,0 +1,105 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include <vector>
+#include <random>
+#include "lib/address.h"
+#include "lib/address_batch.h"
+
+namespace {
+    std::vector<uint8_t> randomKeys(size_t count) {
+        std::mt19937 rng(1234);
+        std::vector<uint8_t> keys(count * ADDRESS_PK_LEN);
+        for (auto &b : keys) {
+            b = (uint8_t) rng();
+        }
+        return keys;
+    }
+
+    TEST(ADDRESS, known_address) {
+        uint8_t pubKey[ADDRESS_PK_LEN];
+        for (uint8_t i = 0; i < ADDRESS_PK_LEN; i++) {
+            pubKey[i] = i * 7 + 1;
+        }
+
+        char addr[ADDRESS_STR_LEN(3)];
+        ASSERT_EQ(address_fromPubKey(addr, sizeof(addr), "iov", pubKey), 42);
+        ASSERT_STREQ(addr, "iov1j47xdlz0w0cdmzqdrm6aml9k778vltztq644dt");
+
+        // Output too small
+        ASSERT_EQ(address_fromPubKey(addr, sizeof(addr) - 1, "iov", pubKey), 0);
+    }
+
+    class AddressBatchTest : public ::testing::TestWithParam<address_kernel_e> {
+    };
+
+    // Every kernel must match the single key path, for all tail sizes
+    TEST_P(AddressBatchTest, matches_single_key) {
+        const address_kernel_e kernel = GetParam();
+        if (!address_kernel_supported(kernel)) {
+            GTEST_SKIP() << address_kernel_name(kernel) << " not supported on this CPU";
+        }
+
+        const size_t maxCount = 3 * ADDRESS_KERNEL_LANES_MAX + 5;
+        const auto keys = randomKeys(maxCount);
+
+        std::vector<uint8_t> expected(maxCount * ADDRESS_HASH_LEN);
+        for (size_t i = 0; i < maxCount; i++) {
+            address_hash(keys.data() + i * ADDRESS_PK_LEN, expected.data() + i * ADDRESS_HASH_LEN);
+        }
+
+        for (size_t count = 0; count <= maxCount; count++) {
+            std::vector<uint8_t> hashes(count * ADDRESS_HASH_LEN + 1, 0xAA);
+            ASSERT_TRUE(address_hash_batch(kernel, keys.data(), count, hashes.data()));
+            ASSERT_EQ(0, memcmp(hashes.data(), expected.data(), count * ADDRESS_HASH_LEN)) << "count " << count;
+            // Nothing is written past the last hash
+            ASSERT_EQ(hashes[count * ADDRESS_HASH_LEN], 0xAA);
+        }
+    }
+
+    TEST_P(AddressBatchTest, addresses_match_single_key) {
+        const address_kernel_e kernel = GetParam();
+        if (!address_kernel_supported(kernel)) {
+            GTEST_SKIP() << address_kernel_name(kernel) << " not supported on this CPU";
+        }
+
+        const size_t count = 37;
+        const size_t stride = ADDRESS_STR_LEN(4);
+        const auto keys = randomKeys(count);
+
+        std::vector<char> out(count * stride);
+        ASSERT_TRUE(address_fromPubKey_batch(kernel, out.data(), stride, "tiov", keys.data(), count));
+
+        for (size_t i = 0; i < count; i++) {
+            char expected[ADDRESS_STR_LEN(4)];
+            address_fromPubKey(expected, sizeof(expected), "tiov", keys.data() + i * ADDRESS_PK_LEN);
+            ASSERT_STREQ(out.data() + i * stride, expected) << "key " << i;
+        }
+
+        // Stride too small for the hrp
+        ASSERT_FALSE(address_fromPubKey_batch(kernel, out.data(), stride - 1, "tiov", keys.data(), count));
+    }
+
+    INSTANTIATE_TEST_SUITE_P(Kernels, AddressBatchTest,
+                             ::testing::Values(address_kernel_auto,
+                                               address_kernel_scalar,
+                                               address_kernel_sse2,
+                                               address_kernel_avx2,
+                                               address_kernel_avx512),
+                             [](const ::testing::TestParamInfo<address_kernel_e> &info) {
+                                 return std::string(address_kernel_name(info.param));
+                             });
+}
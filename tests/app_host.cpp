@@ -0,0 +1,750 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+#include "app_host.h"
+#include "app_main.h"
+#include "lib/cx_host.h"
+#include "lib/coin.h"
+#include "lib/crypto.h"
+#include "lib/parser.h"
+#include "lib/parser_txdef.h"
+#include "lib/pubkey_cache.h"
+#include "lib/stats.h"
+extern "C" {
+#include "tx.h"
+#include "view.h"
+#include "view_internal.h"
+}
+#include "tx_builder.h"
+#include "tx_worst.h"
+
+using namespace iov_test;
+
+namespace {
+    struct reply_t {
+        bytes_t data;
+        uint16_t sw;
+    };
+
+    reply_t exchange(const bytes_t &command) {
+        uint8_t buffer[300];
+        const uint16_t len = app_host_exchange(command.data(), command.size(), buffer, sizeof(buffer));
+        if (len < 2) {
+            return {bytes_t(), 0};
+        }
+        return {bytes_t(buffer, buffer + len - 2), (uint16_t) (buffer[len - 2] << 8u | buffer[len - 1])};
+    }
+
+    reply_t sign(uint8_t ins, const bytes_t &pathData, const bytes_t &message) {
+        reply_t r{};
+        for (const auto &command : sign_apdus(ins, pathData, message)) {
+            r = exchange(command);
+            if (r.sw != APDU_CODE_OK || !r.data.empty()) {
+                break;
+            }
+        }
+        return r;
+    }
+
+    cx_ecfp_public_key_t accountKey(uint32_t account) {
+        const uint32_t path[3] = {HDPATH_0_DEFAULT, HDPATH_1_DEFAULT, 0x80000000u | account};
+        uint8_t privateKeyData[32];
+        os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519,
+                                            path, 3, privateKeyData, nullptr, nullptr, 0);
+        cx_ecfp_private_key_t privateKey;
+        cx_ecfp_public_key_t publicKey;
+        cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, 32, &privateKey);
+        cx_ecfp_generate_pair(CX_CURVE_Ed25519, &publicKey, &privateKey, 1);
+        return publicKey;
+    }
+
+    bool verify(const cx_ecfp_public_key_t &publicKey, const bytes_t &message, const bytes_t &signature) {
+        uint8_t digest[CX_SHA512_SIZE];
+        cx_hash_sha512(message.data(), message.size(), digest, sizeof(digest));
+        return cx_eddsa_verify(&publicKey, CX_LAST, CX_SHA512, digest, sizeof(digest),
+                               nullptr, 0, signature.data(), signature.size()) == 1;
+    }
+
+    class AppHostTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            cx_host_set_mnemonic("equip will roof matter pink blind book anxiety banner elbow sun young");
+            app_host_init();
+        }
+    };
+
+    TEST_F(AppHostTest, get_version) {
+        const auto r = exchange(apdu(INS_GET_VERSION, 0, 0, {}));
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), 9u);
+        EXPECT_EQ(r.data[1], LEDGER_MAJOR_VERSION);
+        EXPECT_EQ(r.data[2], LEDGER_MINOR_VERSION);
+        EXPECT_EQ(r.data[3], LEDGER_PATCH_VERSION);
+    }
+
+    TEST_F(AppHostTest, wrong_cla) {
+        bytes_t command = apdu(INS_GET_VERSION, 0, 0, {});
+        command[0] = 0x55;
+        EXPECT_EQ(exchange(command).sw, APDU_CODE_CLA_NOT_SUPPORTED);
+    }
+
+    TEST_F(AppHostTest, status_words) {
+        EXPECT_EQ(exchange(apdu(0x7F, 0, 0, {})).sw, APDU_CODE_INS_NOT_SUPPORTED);
+        EXPECT_EQ(exchange(bytes_t{CLA, INS_GET_VERSION, 0, 0}).sw, APDU_CODE_WRONG_LENGTH);
+
+        bytes_t wrongPath = path(0);
+        wrongPath[0] = 0;
+        EXPECT_EQ(exchange(apdu(INS_GET_ADDR_ED25519, 0, 0, wrongPath)).sw, APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_GET_ADDR_ED25519, 0, 0, {1, 2, 3})).sw, APDU_CODE_WRONG_LENGTH);
+
+        EXPECT_EQ(exchange(apdu(INS_SIGN_ED25519, PAYLOAD_TYPE_INIT, 1, path(0))).sw, APDU_CODE_INVALIDP1P2);
+        EXPECT_EQ(exchange(apdu(INS_SIGN_ED25519, 7, 0, {})).sw, APDU_CODE_INVALIDP1P2);
+        // Chunks that are not the last one are acknowledged without data
+        const auto r = exchange(apdu(INS_SIGN_ED25519, PAYLOAD_TYPE_INIT, 0, path(0)));
+        EXPECT_EQ(r.sw, APDU_CODE_OK);
+        EXPECT_TRUE(r.data.empty());
+
+        // The parser error message is returned with the status word
+        const auto invalid = exchange(apdu(INS_SIGN_ED25519, PAYLOAD_TYPE_LAST, 0, {0xFF}));
+        EXPECT_EQ(invalid.sw, APDU_CODE_DATA_INVALID);
+        EXPECT_FALSE(invalid.data.empty());
+    }
+
+    TEST_F(AppHostTest, get_address) {
+        const auto r = exchange(apdu(INS_GET_ADDR_ED25519, 0, 0, path(0)));
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_GT(r.data.size(), 32u);
+
+        const std::string addr(r.data.begin() + 32, r.data.end());
+        EXPECT_EQ(addr.rfind("iov1", 0), 0u) << addr;
+
+        // Showing the address first gives the same answer
+        const auto confirmed = exchange(apdu(INS_GET_ADDR_ED25519, 1, 0, path(0)));
+        ASSERT_EQ(confirmed.sw, APDU_CODE_OK);
+        EXPECT_EQ(confirmed.data, r.data);
+    }
+
+    TEST_F(AppHostTest, sign_verifies) {
+        std::vector<std::string> keys;
+        app_host_set_review_callback([](const char *key, const char *, void *userdata) {
+            static_cast<std::vector<std::string> *>(userdata)->push_back(key);
+        }, &keys);
+
+        const bytes_t message = build(send_tx());
+        const auto r = sign(INS_SIGN_ED25519, path(3), message);
+        app_host_set_review_callback(nullptr, nullptr);
+
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), ED25519_SIG_LEN);
+        EXPECT_TRUE(verify(accountKey(3), message, r.data));
+
+        EXPECT_EQ(app_host_review_count(), keys.size());
+        EXPECT_THAT(keys, ::testing::ElementsAre("Source [1/2]", "Source [2/2]",
+                                                "Dest [1/2]", "Dest [2/2]",
+                                                "Amount [IOV]", "Fees [IOV]", "Memo"));
+    }
+
+    TEST_F(AppHostTest, sign_long_message) {
+        send_tx tx;
+        tx.memo = std::string(128, 'm');
+        const bytes_t message = build(tx);
+        ASSERT_GT(message.size(), 250u);
+
+        const auto r = sign(INS_SIGN_ED25519, path(0), message);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        EXPECT_TRUE(verify(accountKey(0), message, r.data));
+    }
+
+    TEST_F(AppHostTest, sign_prepared_during_review) {
+        send_tx tx;
+        tx.memo = std::string(128, 'm');
+        const bytes_t message = build(tx);
+
+        // Without ticker events the key is derived on accept
+        const uint32_t before = cx_host_key_derivations();
+        auto r = sign(INS_SIGN_ED25519, path(1), message);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        EXPECT_GT(cx_host_key_derivations(), before);
+
+        // Enough ticker events while the confirmation is shown: accept only signs
+        struct ticks_t {
+            size_t count;
+            uint32_t derivations;
+        } ticks{message.size() / SIGN_PREPARE_DIGEST_STEP + 3, 0};
+        app_host_set_event_callback([](app_host_event_e event, void *userdata) {
+            auto t = static_cast<ticks_t *>(userdata);
+            if (event == app_host_event_user) {
+                for (size_t i = 0; i < t->count; i++) {
+                    app_host_ticker();
+                }
+                t->derivations = cx_host_key_derivations();
+            }
+        }, &ticks);
+        crypto_accountNodeClear();
+        r = sign(INS_SIGN_ED25519, path(1), message);
+        app_host_set_event_callback(nullptr, nullptr);
+
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        EXPECT_EQ(cx_host_key_derivations(), ticks.derivations);
+        EXPECT_TRUE(verify(accountKey(1), message, r.data));
+
+        // A rejected review wipes the prepared key
+        app_host_set_user(app_host_user_reject);
+        app_host_set_event_callback([](app_host_event_e event, void *userdata) {
+            if (event == app_host_event_user) {
+                for (size_t i = 0; i < static_cast<ticks_t *>(userdata)->count; i++) {
+                    app_host_ticker();
+                }
+            }
+        }, &ticks);
+        r = sign(INS_SIGN_ED25519, path(1), message);
+        app_host_set_event_callback(nullptr, nullptr);
+        EXPECT_EQ(r.sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+        uint8_t signature[ED25519_SIG_LEN];
+        EXPECT_EQ(crypto_batchSign(signature, sizeof(signature), message.data(), message.size()), 0u);
+    }
+
+    TEST_F(AppHostTest, sign_reject) {
+        app_host_set_user(app_host_user_reject);
+        const auto r = sign(INS_SIGN_ED25519, path(0), build(send_tx()));
+        EXPECT_EQ(r.sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+        EXPECT_TRUE(r.data.empty());
+    }
+
+    TEST_F(AppHostTest, sign_wrong_chain) {
+        send_tx tx;
+        tx.chainID = "test-chain";
+        const auto r = sign(INS_SIGN_ED25519, path(0), build(tx));
+        EXPECT_EQ(r.sw, APDU_CODE_DATA_INVALID);
+    }
+
+    TEST_F(AppHostTest, sign_update) {
+        const bytes_t message = build_msg(PBIDX_TX_UPDATEMSG, update_msg(2));
+        const auto r = sign(INS_SIGN_ED25519, path(0), message);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        EXPECT_TRUE(verify(accountKey(0), message, r.data));
+        EXPECT_EQ(app_host_review_count(), 9u);
+    }
+
+    /// INS_SIGN_BATCH payload: each transaction prefixed with its length (2 bytes, little endian)
+    bytes_t batch(const std::vector<bytes_t> &messages) {
+        bytes_t out;
+        for (const auto &m : messages) {
+            out.push_back(m.size() & 0xFFu);
+            out.push_back(m.size() >> 8u);
+            out.insert(out.end(), m.begin(), m.end());
+        }
+        return out;
+    }
+
+    TEST_F(AppHostTest, sign_batch) {
+        std::vector<bytes_t> messages;
+        for (uint64_t nonce = 1; nonce <= 3; nonce++) {
+            send_tx tx;
+            tx.nonce = nonce;
+            messages.push_back(build(tx));
+        }
+
+        std::vector<std::pair<std::string, std::string>> items;
+        app_host_set_review_callback([](const char *key, const char *value, void *userdata) {
+            static_cast<std::vector<std::pair<std::string, std::string>> *>(userdata)->emplace_back(key, value);
+        }, &items);
+
+        // The first signature comes with the accepted review, the others are read one by one
+        const auto r = sign(INS_SIGN_BATCH, path(2), batch(messages));
+        app_host_set_review_callback(nullptr, nullptr);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), ED25519_SIG_LEN);
+        EXPECT_TRUE(verify(accountKey(2), messages[0], r.data));
+
+        for (size_t i = 1; i < messages.size(); i++) {
+            const auto next = exchange(apdu(INS_SIGN_BATCH, PAYLOAD_TYPE_NEXT_SIGNATURE, 0, {}));
+            ASSERT_EQ(next.sw, APDU_CODE_OK);
+            ASSERT_EQ(next.data.size(), ED25519_SIG_LEN);
+            EXPECT_TRUE(verify(accountKey(2), messages[i], next.data)) << i;
+            EXPECT_FALSE(verify(accountKey(2), messages[i - 1], next.data)) << i;
+        }
+        EXPECT_EQ(exchange(apdu(INS_SIGN_BATCH, PAYLOAD_TYPE_NEXT_SIGNATURE, 0, {})).sw,
+                  APDU_CODE_COMMAND_NOT_ALLOWED);
+
+        // Summary, then a header and every page of each transaction
+        ASSERT_EQ(items.size(), 1 + messages.size() * 8);
+        EXPECT_EQ(items[0].first, "Batch");
+        for (size_t i = 0; i < messages.size(); i++) {
+            const auto *tx = &items[1 + i * 8];
+            EXPECT_EQ(tx[0].first, "Transaction");
+            EXPECT_EQ(tx[0].second, "[" + std::to_string(i + 1) + "/3]");
+            EXPECT_EQ(tx[1].first, "Source [1/2]");
+            EXPECT_EQ(tx[2].first, "Source [2/2]");
+            EXPECT_EQ((tx[1].second + tx[2].second).rfind("iov1", 0), 0u);
+            EXPECT_NE(tx[2].second, tx[1].second);
+            EXPECT_EQ(tx[7].first, "Memo");
+        }
+    }
+
+    TEST_F(AppHostTest, sign_batch_invalid) {
+        const bytes_t message = build(send_tx());
+
+        // Every transaction is validated before the review
+        send_tx wrongChain;
+        wrongChain.chainID = "test-chain";
+        const uint16_t reviewed = app_host_review_count();
+        auto r = sign(INS_SIGN_BATCH, path(0), batch({message, build(wrongChain)}));
+        EXPECT_EQ(r.sw, APDU_CODE_DATA_INVALID);
+        EXPECT_FALSE(r.data.empty());
+        EXPECT_EQ(app_host_review_count(), reviewed);
+
+        // Length prefix past the end of the buffer
+        bytes_t truncated = batch({message, message});
+        truncated.pop_back();
+        r = sign(INS_SIGN_BATCH, path(0), truncated);
+        EXPECT_EQ(r.sw, APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(std::string(r.data.begin(), r.data.end()),
+                  parser_getErrorDescription(parser_unexpected_buffer_end));
+
+        EXPECT_EQ(sign(INS_SIGN_BATCH, path(0), bytes_t{0, 0}).sw, APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_SIGN_BATCH, PAYLOAD_TYPE_NEXT_SIGNATURE, 0, {})).sw,
+                  APDU_CODE_COMMAND_NOT_ALLOWED);
+
+        // A rejected batch is not signed
+        app_host_set_user(app_host_user_reject);
+        EXPECT_EQ(sign(INS_SIGN_BATCH, path(0), batch({message, message})).sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+        EXPECT_EQ(exchange(apdu(INS_SIGN_BATCH, PAYLOAD_TYPE_NEXT_SIGNATURE, 0, {})).sw,
+                  APDU_CODE_COMMAND_NOT_ALLOWED);
+    }
+
+    bytes_t pubkeys_request(uint32_t startIndex, uint8_t count) {
+        return {(uint8_t) startIndex, (uint8_t) (startIndex >> 8u), (uint8_t) (startIndex >> 16u),
+                (uint8_t) (startIndex >> 24u), count};
+    }
+
+    void account_path(uint32_t account, uint32_t out[HDPATH_LEN_DEFAULT]) {
+        out[0] = HDPATH_0_DEFAULT;
+        out[1] = HDPATH_1_DEFAULT;
+        out[2] = 0x80000000u | account;
+    }
+
+    TEST_F(AppHostTest, get_pubkeys) {
+        for (uint8_t withHash = 0; withHash <= 1; withHash++) {
+            const uint8_t count = withHash ? PUBKEYS_WITH_HASH_COUNT_MAX : PUBKEYS_COUNT_MAX;
+            const size_t entryLen = ED25519_PK_LEN + (withHash ? ADDRESS_HASH_LEN : 0);
+            const uint32_t startIndex = 3;
+
+            const auto r = exchange(apdu(INS_GET_PUBKEYS_ED25519, withHash, 0, pubkeys_request(startIndex, count)));
+            ASSERT_EQ(r.sw, APDU_CODE_OK);
+            ASSERT_EQ(r.data.size(), count * entryLen);
+
+            for (uint8_t i = 0; i < count; i++) {
+                uint32_t keyPath[HDPATH_LEN_DEFAULT];
+                account_path(startIndex + i, keyPath);
+                uint8_t expected[ED25519_PK_LEN];
+                crypto_derivePublicKey(keyPath, expected, sizeof(expected));
+
+                const uint8_t *entry = r.data.data() + i * entryLen;
+                EXPECT_EQ(bytes_t(entry, entry + ED25519_PK_LEN), bytes_t(expected, expected + ED25519_PK_LEN)) << +i;
+                if (withHash) {
+                    // sha256("sigs/ed25519/" | key), first 20 bytes
+                    bytes_t message(IOV_PK_PREFIX, IOV_PK_PREFIX + IOV_PK_PREFIX_LEN);
+                    message.insert(message.end(), expected, expected + ED25519_PK_LEN);
+                    uint8_t hash[32];
+                    cx_hash_sha256(message.data(), message.size(), hash, sizeof(hash));
+                    EXPECT_EQ(bytes_t(entry + ED25519_PK_LEN, entry + entryLen), bytes_t(hash, hash + ADDRESS_HASH_LEN))
+                                        << +i;
+                }
+            }
+        }
+    }
+
+    TEST_F(AppHostTest, get_pubkeys_bounds) {
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(0, 0))).sw, APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(0, PUBKEYS_COUNT_MAX + 1))).sw,
+                  APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 1, 0, pubkeys_request(0, PUBKEYS_WITH_HASH_COUNT_MAX + 1))).sw,
+                  APDU_CODE_DATA_INVALID);
+
+        // Indexes are hardened: the last key must stay below 2^31
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(0x80000000u, 1))).sw,
+                  APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(0x7FFFFFFFu, 2))).sw,
+                  APDU_CODE_DATA_INVALID);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(0x7FFFFFFFu, 1))).sw, APDU_CODE_OK);
+
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 2, 0, pubkeys_request(0, 1))).sw, APDU_CODE_INVALIDP1P2);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 1, pubkeys_request(0, 1))).sw, APDU_CODE_INVALIDP1P2);
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, {0, 0, 0, 0})).sw, APDU_CODE_WRONG_LENGTH);
+    }
+
+    TEST_F(AppHostTest, pubkey_cache) {
+        uint32_t keyPath[HDPATH_LEN_DEFAULT];
+        account_path(3, keyPath);
+        uint8_t cached[ED25519_PK_LEN];
+        ASSERT_FALSE(pubkey_cache_get(keyPath, cached));
+
+        const auto r = exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(3, 1)));
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_TRUE(pubkey_cache_get(keyPath, cached));
+        EXPECT_EQ(bytes_t(cached, cached + ED25519_PK_LEN), r.data);
+        // A second request is answered from the cache with the same key
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(3, 1))).data, r.data);
+
+        // The least recently used entry is evicted first
+        ASSERT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(4, PUBKEY_CACHE_SIZE - 1))).sw,
+                  APDU_CODE_OK);
+        EXPECT_TRUE(pubkey_cache_get(keyPath, cached));
+        ASSERT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(4 + PUBKEY_CACHE_SIZE, 1))).sw,
+                  APDU_CODE_OK);
+        uint32_t evictedPath[HDPATH_LEN_DEFAULT];
+        account_path(4, evictedPath);
+        EXPECT_FALSE(pubkey_cache_get(evictedPath, cached));
+        EXPECT_TRUE(pubkey_cache_get(keyPath, cached));
+
+        // Ticks keep the cache while the device is unlocked, the first tick after locking drops it
+        app_host_ticker();
+        EXPECT_TRUE(pubkey_cache_get(keyPath, cached));
+        app_host_set_locked(true);
+        app_host_ticker();
+        app_host_set_locked(false);
+        EXPECT_FALSE(pubkey_cache_get(keyPath, cached));
+
+        // Derived again with the same result
+        EXPECT_EQ(exchange(apdu(INS_GET_PUBKEYS_ED25519, 0, 0, pubkeys_request(3, 1))).data, r.data);
+    }
+
+    typedef std::vector<std::pair<std::string, std::string>> items_t;
+
+    items_t review(const bytes_t &message) {
+        items_t items;
+        app_host_set_review_callback([](const char *key, const char *value, void *userdata) {
+            static_cast<items_t *>(userdata)->emplace_back(key, value);
+        }, &items);
+        EXPECT_EQ(sign(INS_SIGN_ED25519, path(0), message).sw, APDU_CODE_OK);
+        app_host_set_review_callback(nullptr, nullptr);
+        return items;
+    }
+
+    /// Parses message as INS_SIGN_ED25519 does, without starting the review
+    std::string load(bytes_t message) {
+        tx_initialize();
+        tx_reset();
+        if (tx_append(message.data(), message.size()) != message.size()) {
+            return "Transaction too large";
+        }
+        const char *err = tx_parse(bool_true);
+        return err == nullptr ? "" : err;
+    }
+
+    /// SendMsg without memo, authorized by two multisig contracts
+    bytes_t multisig_send() {
+        send_tx tx;
+        tx.memo = "";
+        pb_writer root;
+        root.bytes(PBIDX_TX_FEES, pb_writer().bytes(PBIDX_FEES_PAYER, address(1)).bytes(PBIDX_FEES_COIN, coin(0, 10, "IOV")).data)
+            .bytes(PBIDX_TX_MULTISIG, bytes_t{0, 0, 0, 0, 0, 0, 0, 5})
+            .bytes(PBIDX_TX_MULTISIG, bytes_t{0, 0, 0, 0, 0, 0, 1, 0})
+            .bytes(PBIDX_TX_SENDMSG, send_msg(tx));
+
+        bytes_t out = tx_header(tx.chainID, tx.nonce);
+        out.insert(out.end(), root.data.begin(), root.data.end());
+        return out;
+    }
+
+    TEST_F(AppHostTest, review_multisig) {
+        const items_t items = review(multisig_send());
+        ASSERT_EQ(items.size(), 8u);
+        EXPECT_EQ(items[6], std::make_pair(std::string("Multisig [1/2]"), std::string("5")));
+        EXPECT_EQ(items[7], std::make_pair(std::string("Multisig [2/2]"), std::string("256")));
+    }
+
+    TEST_F(AppHostTest, review_compact) {
+        tx_settings_set_review_mode(tx_review_compact);
+
+        const items_t update = review(build_msg(PBIDX_TX_UPDATEMSG, update_msg(2)));
+        EXPECT_EQ(tx_get_review_mode(), tx_review_compact);
+        std::vector<std::string> keys;
+        for (const auto &item : update) {
+            keys.push_back(item.first);
+        }
+        EXPECT_THAT(keys, ::testing::ElementsAre("ContractId",
+                                                "Participant [1/2] [1/2]", "Participant [1/2] [2/2]",
+                                                "Participant [2/2] [1/2]", "Participant [2/2] [2/2]",
+                                                "Weights"));
+        EXPECT_THAT(update[2].second, ::testing::EndsWith(" weight 1"));
+        EXPECT_THAT(update[4].second, ::testing::EndsWith(" weight 2"));
+        EXPECT_EQ(update[5].second, "Total 3 Activation 2 Admin 3");
+
+        const items_t send = review(multisig_send());
+        ASSERT_EQ(send.size(), 7u);
+        EXPECT_EQ(send[6], std::make_pair(std::string("Multisig"), std::string("5, 256")));
+
+        // Nothing to collapse
+        EXPECT_EQ(review(build(send_tx())).size(), 7u);
+        EXPECT_EQ(tx_get_review_mode(), tx_review_full);
+
+        // "View details" shows every field of the same transaction
+        ASSERT_EQ(load(build_msg(PBIDX_TX_UPDATEMSG, update_msg(2))), "");
+        EXPECT_EQ(tx_getNumItems(), 4u);
+        tx_set_review_mode(tx_review_full);
+        EXPECT_EQ(tx_getNumItems(), 7u);
+        EXPECT_EQ(tx_settings_get_review_mode(), tx_review_compact);
+    }
+
+    /// Pages seen pressing right until the end, then left back to the first one
+    std::vector<std::string> walk(bool ticks) {
+        std::vector<std::string> pages;
+        auto show = [&]() {
+            const view_error_t err = h_review_update_data();
+            pages.push_back(std::to_string(err) + " " + std::to_string(viewdata.idx) + "." +
+                            std::to_string(viewdata.pageIdx) + " " + viewdata.key + " " + viewdata.value);
+            if (ticks) {
+                // The user reads the screen: the next and the previous page get rendered
+                app_host_ticker();
+                app_host_ticker();
+            }
+            return err;
+        };
+
+        h_review_init();
+        while (show() == view_no_error) {
+            h_review_increase();
+        }
+        h_review_decrease();
+        while (viewdata.idx >= 0 && show() == view_no_error) {
+            h_review_decrease();
+        }
+        return pages;
+    }
+
+    TEST_F(AppHostTest, review_lookahead) {
+        for (const auto &c : worst_cases()) {
+            ASSERT_EQ(load(c.second), "") << c.first;
+
+            const std::vector<std::string> expected = walk(false);
+            EXPECT_EQ(view_lookahead.hits, 0u);
+            const std::vector<std::string> pages = walk(true);
+            EXPECT_EQ(pages, expected) << c.first;
+            // Every page but the first one was ready when the button was pressed
+            EXPECT_EQ(view_lookahead.hits, pages.size() - 1) << c.first;
+        }
+
+        // Nothing is rendered once the review is over
+        view_idle_show(0);
+        view_lookahead.pages[0].valid = 0;
+        view_lookahead.pages[1].valid = 0;
+        app_host_ticker();
+        EXPECT_FALSE(view_lookahead.pages[0].valid || view_lookahead.pages[1].valid);
+    }
+
+    TEST_F(AppHostTest, get_caps) {
+        EXPECT_EQ(exchange(apdu(INS_GET_CAPS, 0, 1, {})).sw, APDU_CODE_INVALIDP1P2);
+        const auto r = exchange(apdu(INS_GET_CAPS, 0, 0, {}));
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), sizeof(app_caps_t));
+
+        app_caps_t caps;
+        MEMCPY(&caps, r.data.data(), sizeof(caps));
+        EXPECT_EQ(caps.version, CAPS_VERSION);
+        // Every command listed is answered, the others are not supported
+        for (uint8_t ins = 0; ins < 32; ins++) {
+            const bool listed = (caps.commands >> ins) & 1u;
+            const uint16_t sw = exchange(apdu(ins, 0xFF, 0xFF, {})).sw;
+            EXPECT_EQ(listed, sw != APDU_CODE_INS_NOT_SUPPORTED) << (int) ins;
+        }
+        EXPECT_TRUE(caps.commands & (1u << INS_SIGN_BATCH));
+        EXPECT_EQ(caps.features & CAPS_FEATURE_MAINNET, CAPS_FEATURE_MAINNET);
+        EXPECT_EQ(caps.features & CAPS_FEATURE_REVIEW_COMPACT, 0u);
+        EXPECT_EQ(caps.chunkMax, 255u);
+        EXPECT_EQ(caps.ramBuffer, RAM_BUFFER_SIZE);
+        EXPECT_EQ(caps.flashBuffer, FLASH_BUFFER_SIZE);
+        EXPECT_EQ(caps.memoMax, TX_MEMOLEN_MAX);
+        EXPECT_EQ(caps.participantsMax, PBIDX_UPDATEMSG_PARTICIPANTS_MAX);
+
+        tx_settings_set_review_mode(tx_review_compact);
+        MEMCPY(&caps, exchange(apdu(INS_GET_CAPS, 0, 0, {})).data.data(), sizeof(caps));
+        EXPECT_EQ(caps.features & CAPS_FEATURE_REVIEW_COMPACT, CAPS_FEATURE_REVIEW_COMPACT);
+    }
+
+    TEST_F(AppHostTest, sign_multipath) {
+        bytes_t paths = path(0);
+        const bytes_t second = path(5);
+        paths.insert(paths.end(), second.begin(), second.end());
+
+        items_t items;
+        app_host_set_review_callback([](const char *key, const char *value, void *userdata) {
+            static_cast<items_t *>(userdata)->emplace_back(key, value);
+        }, &items);
+        const bytes_t message = build(send_tx());
+        const auto r = sign(INS_SIGN_MULTIPATH, paths, message);
+        app_host_set_review_callback(nullptr, nullptr);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        // The signing paths are reviewed after the transaction
+        ASSERT_GE(items.size(), 2u);
+        EXPECT_EQ(items[items.size() - 2], items_t::value_type("Sign with [1/2]", "44'/234'/0'"));
+        EXPECT_EQ(items[items.size() - 1], items_t::value_type("Sign with [2/2]", "44'/234'/5'"));
+        EXPECT_EQ(items.size(), review(message).size() + 2);
+
+        ASSERT_EQ(r.data.size(), 2 * ED25519_SIG_LEN);
+        EXPECT_TRUE(verify(accountKey(0), message, bytes_t(r.data.begin(), r.data.begin() + ED25519_SIG_LEN)));
+        EXPECT_TRUE(verify(accountKey(5), message, bytes_t(r.data.begin() + ED25519_SIG_LEN, r.data.end())));
+    }
+
+    // Item stream bytes per reply: IO_APDU_BUFFER_SIZE without the status word
+    const size_t STREAM_CHUNK = 258;
+
+    /// Uploads message with INS_PARSE_ONLY and reads the item stream up to the end record
+    reply_t parse_only(const bytes_t &message, bytes_t *stream) {
+        reply_t r = sign(INS_PARSE_ONLY, {}, message);
+        while (r.sw == APDU_CODE_OK) {
+            EXPECT_FALSE(r.data.empty());
+            stream->insert(stream->end(), r.data.begin(), r.data.end());
+            if (r.data.size() < STREAM_CHUNK) {
+                break;
+            }
+            r = exchange(apdu(INS_PARSE_ONLY, PAYLOAD_TYPE_NEXT_ITEMS, 0, {}));
+        }
+        return r;
+    }
+
+    /// Splits the stream into (key, value) pages, checking the header, item and end records
+    items_t parse_stream(const bytes_t &stream) {
+        items_t items;
+        size_t pos = 0;
+        uint16_t numItems = 0;
+        int lastIdx = -1;
+        while (pos + PARSE_RECORD_HEAD_LEN <= stream.size()) {
+            const uint8_t tag = stream[pos];
+            const uint16_t len = stream[pos + 1] | stream[pos + 2] << 8u;
+            const uint8_t *p = stream.data() + pos + PARSE_RECORD_HEAD_LEN;
+            pos += PARSE_RECORD_HEAD_LEN + len;
+            EXPECT_LE(pos, stream.size());
+
+            if (tag == PARSE_TAG_HEADER) {
+                EXPECT_EQ(len, 2u);
+                EXPECT_TRUE(items.empty());
+                numItems = p[0] | p[1] << 8u;
+            } else if (tag == PARSE_TAG_ITEM) {
+                const uint16_t idx = p[0] | p[1] << 8u;
+                const uint8_t pageIdx = p[2], pageCount = p[3], keyLen = p[4];
+                EXPECT_LT(idx, numItems);
+                EXPECT_LT(pageIdx, pageCount);
+                EXPECT_GE((int) idx, lastIdx);
+                lastIdx = idx;
+                const char *text = reinterpret_cast<const char *>(p + 5);
+                items.emplace_back(std::string(text, keyLen), std::string(text + keyLen, len - 5 - keyLen));
+            } else {
+                EXPECT_EQ(tag, PARSE_TAG_END);
+                EXPECT_EQ(len, 0u);
+                EXPECT_EQ(pos, stream.size());
+                return items;
+            }
+        }
+        ADD_FAILURE() << "no end record";
+        return items;
+    }
+
+    TEST_F(AppHostTest, parse_only) {
+        std::vector<bytes_t> messages = {build(send_tx()), multisig_send(),
+                                         build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX))};
+        for (const auto &c : worst_cases()) {
+            messages.push_back(c.second);
+        }
+
+        for (const auto &message : messages) {
+            bytes_t stream;
+            const size_t reviewed = app_host_review_count();
+            ASSERT_EQ(parse_only(message, &stream).sw, APDU_CODE_OK);
+            EXPECT_EQ(app_host_review_count(), reviewed);
+            // Same pages as the review on the device
+            EXPECT_EQ(parse_stream(stream), review(message));
+        }
+
+        // The stream ends with the end record
+        EXPECT_EQ(exchange(apdu(INS_PARSE_ONLY, PAYLOAD_TYPE_NEXT_ITEMS, 0, {})).sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+    }
+
+    TEST_F(AppHostTest, parse_only_interrupted) {
+        const bytes_t message = build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX));
+        const auto r = sign(INS_PARSE_ONLY, {}, message);
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), STREAM_CHUNK);
+
+        // Any other command ends the stream
+        ASSERT_EQ(exchange(apdu(INS_GET_VERSION, 0, 0, {})).sw, APDU_CODE_OK);
+        EXPECT_EQ(exchange(apdu(INS_PARSE_ONLY, PAYLOAD_TYPE_NEXT_ITEMS, 0, {})).sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+    }
+
+    TEST_F(AppHostTest, parse_only_invalid) {
+        send_tx wrongChain;
+        wrongChain.chainID = "test-chain";
+        const auto r = sign(INS_PARSE_ONLY, {}, build(wrongChain));
+        EXPECT_EQ(r.sw, APDU_CODE_DATA_INVALID);
+        EXPECT_FALSE(r.data.empty());
+        EXPECT_EQ(std::string(r.data.begin(), r.data.end()), load(build(wrongChain)));
+        EXPECT_EQ(exchange(apdu(INS_PARSE_ONLY, PAYLOAD_TYPE_NEXT_ITEMS, 0, {})).sw, APDU_CODE_COMMAND_NOT_ALLOWED);
+    }
+
+#if defined(APP_STATS)
+    TEST_F(AppHostTest, get_stats) {
+        app_host_ticker();
+        ASSERT_EQ(exchange(apdu(INS_GET_ADDR_ED25519, 0, 0, path(0))).sw, APDU_CODE_OK);
+        app_host_ticker();
+
+        const bytes_t message = build(send_tx());
+        ASSERT_EQ(sign(INS_SIGN_ED25519, path(0), message).sw, APDU_CODE_OK);
+        send_tx wrongChain;
+        wrongChain.chainID = "test-chain";
+        ASSERT_EQ(sign(INS_SIGN_ED25519, path(0), build(wrongChain)).sw, APDU_CODE_DATA_INVALID);
+        ASSERT_EQ(exchange(apdu(INS_GET_ADDR_ED25519, 0, 0, path(0))).sw, APDU_CODE_OK);
+
+        EXPECT_EQ(exchange(apdu(INS_GET_STATS, 1, 0, {})).sw, APDU_CODE_INVALIDP1P2);
+        const auto r = exchange(apdu(INS_GET_STATS, 0, 0, {}));
+        ASSERT_EQ(r.sw, APDU_CODE_OK);
+        ASSERT_EQ(r.data.size(), sizeof(app_stats_t));
+
+        // Live counters are word aligned, the reply is packed
+        EXPECT_EQ(alignof(app_stats_counters_t), alignof(uint32_t));
+        EXPECT_EQ(sizeof(app_stats_t), 1 + sizeof(app_stats_counters_t));
+
+        app_stats_t stats;
+        MEMCPY(&stats, r.data.data(), sizeof(stats));
+        EXPECT_EQ(stats.version, STATS_VERSION);
+        EXPECT_EQ(stats.ticks, 2u);
+        EXPECT_EQ(stats.apdus[INS_GET_ADDR_ED25519], 2u);
+        EXPECT_EQ(stats.apdus[INS_SIGN_ED25519], 2 * sign_apdus(INS_SIGN_ED25519, path(0), message).size());
+        EXPECT_EQ(stats.apdus[INS_GET_STATS], 2u);
+        EXPECT_EQ(stats.bytesAppended, message.size() + build(wrongChain).size());
+        EXPECT_EQ(stats.txRam + stats.txFlash, 2u);
+        // One per page shown: Source and Dest take two pages each
+        uint32_t renders = 0;
+        for (size_t i = 0; i < STATS_ITEMS_COUNT; i++) {
+            renders += stats.renders[i];
+        }
+        EXPECT_EQ(renders, 7u);
+        EXPECT_EQ(stats.renders[0], 2u);
+        EXPECT_EQ(stats.lastParseTick, 2u);
+        EXPECT_EQ(stats.lastSignTick, 2u);
+        // The second address comes from the cache
+        EXPECT_GE(stats.pubkeyCacheHits, 1u);
+
+        uint32_t errors = 0;
+        for (size_t i = 0; i < STATS_ERRORS_COUNT; i++) {
+            errors += stats.parseErrors[i];
+        }
+        EXPECT_EQ(errors, 1u);
+    }
+#endif
+}
@@ -0,0 +1,224 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include <string>
+#include <vector>
+#include "lib/cx_host.h"
+#include "lib/crypto.h"
+#include "lib/coin.h"
+
+namespace {
+    std::vector<uint8_t> fromHex(const std::string &s) {
+        std::vector<uint8_t> out(s.size() / 2);
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i] = (uint8_t) std::stoul(s.substr(2 * i, 2), nullptr, 16);
+        }
+        return out;
+    }
+
+    std::string toHex(const uint8_t *data, size_t len) {
+        static const char digits[] = "0123456789abcdef";
+        std::string out;
+        for (size_t i = 0; i < len; i++) {
+            out += digits[data[i] >> 4u];
+            out += digits[data[i] & 0xFu];
+        }
+        return out;
+    }
+
+    // Compressed ed25519 key from the cx representation, as crypto_extractPublicKey does
+    std::string compressedKey(const cx_ecfp_public_key_t &pk) {
+        uint8_t out[32];
+        for (int i = 0; i < 32; i++) {
+            out[i] = pk.W[64 - i];
+        }
+        out[31] |= (pk.W[32] & 1u) << 7u;
+        return toHex(out, sizeof(out));
+    }
+
+    struct rfc8032_vector {
+        const char *secret;
+        const char *publicKey;
+        const char *message;
+        const char *signature;
+    };
+
+    // RFC 8032, section 7.1
+    const rfc8032_vector rfc8032_vectors[] = {
+        {
+            "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+            "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+            "",
+            "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b",
+        },
+        {
+            "4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+            "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+            "72",
+            "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00",
+        },
+        {
+            "c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+            "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+            "af82",
+            "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a",
+        },
+    };
+
+    TEST(CX_HOST, sha256) {
+        uint8_t out[CX_SHA256_SIZE];
+        cx_hash_sha256((const uint8_t *) "abc", 3, out, sizeof(out));
+        EXPECT_EQ(toHex(out, sizeof(out)), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+        // Incremental interface
+        cx_sha256_t ctx;
+        cx_sha256_init(&ctx);
+        cx_hash(&ctx.header, 0, (const uint8_t *) "a", 1, nullptr, 0);
+        EXPECT_EQ(cx_hash(&ctx.header, CX_LAST, (const uint8_t *) "bc", 2, out, sizeof(out)), CX_SHA256_SIZE);
+        EXPECT_EQ(toHex(out, sizeof(out)), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    }
+
+    TEST(CX_HOST, sha512) {
+        uint8_t out[CX_SHA512_SIZE];
+        cx_hash_sha512((const uint8_t *) "abc", 3, out, sizeof(out));
+        EXPECT_EQ(toHex(out, sizeof(out)),
+                  "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+                  "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+    }
+
+    TEST(CX_HOST, rfc8032) {
+        for (const auto &v : rfc8032_vectors) {
+            const auto secret = fromHex(v.secret);
+            const auto message = fromHex(v.message);
+
+            cx_ecfp_private_key_t privateKey;
+            cx_ecfp_public_key_t publicKey;
+            cx_ecfp_init_private_key(CX_CURVE_Ed25519, secret.data(), 32, &privateKey);
+            cx_ecfp_init_public_key(CX_CURVE_Ed25519, nullptr, 0, &publicKey);
+            cx_ecfp_generate_pair(CX_CURVE_Ed25519, &publicKey, &privateKey, 1);
+            EXPECT_EQ(compressedKey(publicKey), v.publicKey);
+
+            uint8_t signature[64];
+            ASSERT_EQ(cx_eddsa_sign(&privateKey, CX_LAST, CX_SHA512,
+                                    message.data(), message.size(),
+                                    nullptr, 0, signature, sizeof(signature), nullptr), 64);
+            EXPECT_EQ(toHex(signature, sizeof(signature)), v.signature);
+
+            EXPECT_EQ(cx_eddsa_verify(&publicKey, CX_LAST, CX_SHA512,
+                                      message.data(), message.size(),
+                                      nullptr, 0, signature, sizeof(signature)), 1);
+
+            // Any change to the message or the signature must be rejected
+            std::vector<uint8_t> tampered = message;
+            tampered.push_back(0);
+            EXPECT_EQ(cx_eddsa_verify(&publicKey, CX_LAST, CX_SHA512,
+                                      tampered.data(), tampered.size(),
+                                      nullptr, 0, signature, sizeof(signature)), 0);
+            signature[10] ^= 1u;
+            EXPECT_EQ(cx_eddsa_verify(&publicKey, CX_LAST, CX_SHA512,
+                                      message.data(), message.size(),
+                                      nullptr, 0, signature, sizeof(signature)), 0);
+        }
+    }
+
+    // SLIP-0010, test vector 1 for ed25519
+    TEST(CX_HOST, slip10) {
+        const auto seed = fromHex("000102030405060708090a0b0c0d0e0f");
+        cx_host_set_seed(seed.data(), seed.size());
+
+        uint8_t privateKey[32], chainCode[32];
+        const uint32_t path[] = {0x80000000u, 0x80000001u};
+
+        os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519,
+                                            path, 0, privateKey, chainCode, nullptr, 0);
+        EXPECT_EQ(toHex(privateKey, 32), "2b4be7f19ee27bbf30c667b642d5f4aa69fd169872f8fc3059c08ebae2eb19e7");
+        EXPECT_EQ(toHex(chainCode, 32), "90046a93de5380a72b5e45010748567d5ea02bbf6522f979e05c0d8d8ca9fffb");
+
+        os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519,
+                                            path, 2, privateKey, chainCode, nullptr, 0);
+        EXPECT_EQ(toHex(privateKey, 32), "b1d0bad404bf35da785a64ca1ac54b2617211d2777696fbffaf208f746ae84f2");
+        EXPECT_EQ(toHex(chainCode, 32), "a320425f77d1b5c2505a6b1b27382b37368ee640e3557c315416801243552f14");
+
+        cx_host_set_mnemonic("equip will roof matter pink blind book anxiety banner elbow sun young");
+    }
+
+    // Full device code path: seed -> 44'/234' node -> account key -> signature
+    TEST(CX_HOST, crypto_sign_verifies) {
+        cx_host_set_mnemonic("equip will roof matter pink blind book anxiety banner elbow sun young");
+        crypto_accountNodeClear();
+
+        hdPath[0] = HDPATH_0_DEFAULT;
+        hdPath[1] = HDPATH_1_DEFAULT;
+        hdPath[2] = 0x80000000u;
+
+        uint8_t pubKey[PK_LEN];
+        crypto_derivePublicKey(hdPath, pubKey, sizeof(pubKey));
+
+        // The account node shortcut must match a full derivation from the seed
+        uint8_t privateKeyData[32];
+        os_perso_derive_node_bip32_seed_key(HDW_ED25519_SLIP10, CX_CURVE_Ed25519,
+                                            hdPath, HDPATH_LEN_DEFAULT, privateKeyData, nullptr, nullptr, 0);
+        cx_ecfp_private_key_t privateKey;
+        cx_ecfp_public_key_t publicKey;
+        cx_ecfp_init_private_key(CX_CURVE_Ed25519, privateKeyData, 32, &privateKey);
+        cx_ecfp_generate_pair(CX_CURVE_Ed25519, &publicKey, &privateKey, 1);
+        EXPECT_EQ(compressedKey(publicKey), toHex(pubKey, sizeof(pubKey)));
+
+        const std::string message = "{\"chain_id\":\"test\"}";
+        uint8_t signature[ED25519_SIG_LEN];
+        ASSERT_EQ(crypto_sign(signature, sizeof(signature),
+                              (const uint8_t *) message.data(), message.size()), ED25519_SIG_LEN);
+
+        // The device signs the SHA-512 digest of the message
+        uint8_t digest[CX_SHA512_SIZE];
+        cx_hash_sha512((const uint8_t *) message.data(), message.size(), digest, sizeof(digest));
+        EXPECT_EQ(cx_eddsa_verify(&publicKey, CX_LAST, CX_SHA512, digest, sizeof(digest),
+                                  nullptr, 0, signature, sizeof(signature)), 1);
+    }
+
+    // Digest prepared over several ticker events, as during a review
+    TEST(CX_HOST, crypto_sign_prepared_in_steps) {
+        cx_host_set_mnemonic("equip will roof matter pink blind book anxiety banner elbow sun young");
+        crypto_accountNodeClear();
+        hdPath[0] = HDPATH_0_DEFAULT;
+        hdPath[1] = HDPATH_1_DEFAULT;
+        hdPath[2] = 0x80000000u;
+
+        std::vector<uint8_t> message(3 * SIGN_PREPARE_DIGEST_STEP + 17);
+        for (size_t i = 0; i < message.size(); i++) {
+            message[i] = (uint8_t) i;
+        }
+
+        uint8_t expected[ED25519_SIG_LEN];
+        ASSERT_EQ(crypto_sign(expected, sizeof(expected), message.data(), message.size()), ED25519_SIG_LEN);
+
+        size_t steps = 1;
+        while (!crypto_signPrepareDigestStep(message.data(), message.size(), SIGN_PREPARE_DIGEST_STEP)) {
+            steps++;
+        }
+        EXPECT_EQ(steps, 4u);
+        EXPECT_TRUE(crypto_signPrepareDigestStep(message.data(), message.size(), SIGN_PREPARE_DIGEST_STEP));
+
+        uint8_t signature[ED25519_SIG_LEN];
+        ASSERT_EQ(crypto_sign(signature, sizeof(signature), message.data(), message.size()), ED25519_SIG_LEN);
+        EXPECT_EQ(toHex(signature, sizeof(signature)), toHex(expected, sizeof(expected)));
+
+        // Interrupted preparation: the rest of the message is hashed when signing
+        ASSERT_FALSE(crypto_signPrepareDigestStep(message.data(), message.size(), SIGN_PREPARE_DIGEST_STEP));
+        ASSERT_EQ(crypto_sign(signature, sizeof(signature), message.data(), message.size()), ED25519_SIG_LEN);
+        EXPECT_EQ(toHex(signature, sizeof(signature)), toHex(expected, sizeof(expected)));
+    }
+}
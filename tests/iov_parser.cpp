@@ -0,0 +1,332 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "lib/iov_parser.h"
+#include "lib/parser_common.h"
+#include "lib/parser_txdef.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    std::vector<std::string> items(const iov_parser_t *parser) {
+        std::vector<std::string> out;
+        for (int i = 0; i < iov_parser_num_items(parser); i++) {
+            uint8_t pageCount = 1;
+            for (uint8_t page = 0; page < pageCount; page++) {
+                char key[40], value[IOV_PARSER_VALUE_LEN_NANOS];
+                EXPECT_EQ(iov_parser_get_item(parser, i, page, key, sizeof(key), value, sizeof(value), &pageCount),
+                          parser_ok);
+                out.push_back(std::string(key) + "=" + value);
+            }
+        }
+        return out;
+    }
+
+    TEST(IOV_PARSER, send) {
+        iov_parser_t *parser = iov_parser_create(1024);
+        ASSERT_NE(parser, nullptr);
+
+        const bytes_t tx = build(send_tx());
+        ASSERT_EQ(iov_parser_parse(parser, tx.data(), tx.size()), parser_ok);
+
+        const auto out = items(parser);
+        ASSERT_EQ(out.size(), 7u);
+        ASSERT_EQ(iov_parser_num_items(parser), 5);
+        EXPECT_EQ(out[0].rfind("Source [1/2]=iov1", 0), 0u) << out[0];
+        EXPECT_EQ(out[4], "Amount [IOV]=100.500000000");
+        EXPECT_EQ(out[6], "Memo=Hello");
+
+        uint8_t pageCount;
+        char key[40], value[40];
+        EXPECT_EQ(iov_parser_get_item(parser, 3, 0, key, sizeof(key), value, sizeof(value), &pageCount),
+                  parser_ok);
+        EXPECT_STREQ(key, "Fees [IOV]");
+        EXPECT_EQ(iov_parser_get_item(parser, 5, 0, key, sizeof(key), value, sizeof(value), &pageCount),
+                  parser_display_idx_out_of_range);
+        // Negative once cast to the parser's int8_t index
+        for (const uint8_t idx : {128, 200, 255}) {
+            EXPECT_EQ(iov_parser_get_item(parser, idx, 0, key, sizeof(key), value, sizeof(value), &pageCount),
+                      parser_display_idx_out_of_range) << +idx;
+            EXPECT_EQ(pageCount, 0u);
+        }
+        EXPECT_EQ(iov_parser_get_item(parser, 0, 2, key, sizeof(key), value, sizeof(value), &pageCount),
+                  parser_display_page_out_of_range);
+
+        iov_parser_destroy(parser);
+    }
+
+    TEST(IOV_PARSER, caller_memory) {
+        std::vector<uint64_t> mem((iov_parser_size(512) + 7) / 8);
+        EXPECT_EQ(iov_parser_init(mem.data(), iov_parser_size(512) - 1, 512), nullptr);
+
+        iov_parser_t *parser = iov_parser_init(mem.data(), iov_parser_size(512), 512);
+        ASSERT_NE(parser, nullptr);
+        EXPECT_EQ(iov_parser_num_items(parser), 0);
+
+        // The transaction is copied: the input can go away before the items are read
+        bytes_t tx = build(send_tx());
+        ASSERT_EQ(iov_parser_parse(parser, tx.data(), tx.size()), parser_ok);
+        const auto expected = items(parser);
+        std::fill(tx.begin(), tx.end(), 0);
+        EXPECT_EQ(items(parser), expected);
+
+        const bytes_t big(513, 0);
+        EXPECT_EQ(iov_parser_parse(parser, big.data(), big.size()), parser_context_unexpected_size);
+        EXPECT_EQ(iov_parser_num_items(parser), 0);
+    }
+
+    // Handles share no state
+    TEST(IOV_PARSER, independent_handles) {
+        iov_parser_t *a = iov_parser_create(1024);
+        iov_parser_t *b = iov_parser_create(1024);
+
+        send_tx other;
+        other.memo = "";
+        other.amountWhole = 3;
+        const bytes_t txA = build(send_tx());
+        const bytes_t txB = build(other);
+        ASSERT_EQ(iov_parser_parse(a, txA.data(), txA.size()), parser_ok);
+        const auto expected = items(a);
+        ASSERT_EQ(iov_parser_parse(b, txB.data(), txB.size()), parser_ok);
+
+        EXPECT_EQ(items(a), expected);
+        EXPECT_EQ(items(b).size(), expected.size() - 1);
+
+        iov_parser_destroy(a);
+        iov_parser_destroy(b);
+    }
+
+    // Repeated fields must not keep state from the previous transaction
+    TEST(IOV_PARSER, reparse) {
+        iov_parser_t *parser = iov_parser_create(1024);
+
+        const bytes_t tx = build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX));
+        ASSERT_EQ(iov_parser_parse(parser, tx.data(), tx.size()), parser_ok);
+        const auto expected = items(parser);
+        ASSERT_EQ(iov_parser_parse(parser, tx.data(), tx.size()), parser_ok);
+        EXPECT_EQ(items(parser), expected);
+
+        iov_parser_destroy(parser);
+    }
+
+    // Participants are reset for every update, also those the transaction union does not overlap
+    TEST(IOV_PARSER, update_reparse) {
+        iov_parser_t *parser = iov_parser_create(1024);
+        iov_parser_t *fresh = iov_parser_create(1024);
+
+        const bytes_t full = build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX));
+        const bytes_t fewer = build_msg(PBIDX_TX_UPDATEMSG, update_msg(PBIDX_UPDATEMSG_PARTICIPANTS_MAX - 1));
+        ASSERT_EQ(iov_parser_parse(fresh, fewer.data(), fewer.size()), parser_ok);
+        ASSERT_EQ(iov_parser_parse(parser, full.data(), full.size()), parser_ok);
+        ASSERT_EQ(iov_parser_parse(parser, fewer.data(), fewer.size()), parser_ok);
+        EXPECT_EQ(items(parser), items(fresh));
+
+        iov_parser_destroy(fresh);
+        iov_parser_destroy(parser);
+    }
+
+    // The BCD digits of an id do not fit the Nano S value line in one go
+    TEST(IOV_PARSER, ids_nanos) {
+        iov_parser_t *parser = iov_parser_create(1024);
+
+        const bytes_t vote = build_msg(PBIDX_TX_VOTEMSG, vote_msg(1));
+        ASSERT_EQ(iov_parser_parse(parser, vote.data(), vote.size()), parser_ok);
+        auto out = items(parser);
+        EXPECT_NE(std::find(out.begin(), out.end(), "ProposalId=4660"), out.end());
+
+        const bytes_t update = build_msg(PBIDX_TX_UPDATEMSG, update_msg(2));
+        ASSERT_EQ(iov_parser_parse(parser, update.data(), update.size()), parser_ok);
+        out = items(parser);
+        EXPECT_NE(std::find(out.begin(), out.end(), "ContractId=42"), out.end());
+
+        iov_parser_destroy(parser);
+    }
+
+    TEST(IOV_PARSER, error_offset) {
+        iov_parser_t *parser = iov_parser_create(1024);
+
+        // Unknown root field appended at the end
+        bytes_t tx = build(send_tx());
+        const size_t end = tx.size();
+        tx.push_back(9u << 3u);
+        tx.push_back(1);
+        EXPECT_EQ(iov_parser_parse(parser, tx.data(), tx.size()), parser_unexpected_field);
+        EXPECT_EQ(iov_parser_error(parser), parser_unexpected_field);
+        EXPECT_EQ(iov_parser_num_items(parser), 0);
+        EXPECT_EQ(iov_parser_error_offset(parser), end);
+
+        // Invalid ticker nested in Fees.Coin is reported at its position, not at the end of Fees
+        send_tx bad;
+        bad.ticker = "iov";
+        const bytes_t badTx = build(bad);
+        EXPECT_EQ(iov_parser_parse(parser, badTx.data(), badTx.size()), parser_unexpected_characters);
+        const std::string needle = "iov";
+        const size_t offset = iov_parser_error_offset(parser);
+        ASSERT_LE(offset, badTx.size());
+        EXPECT_EQ(std::string(badTx.begin() + offset - 3, badTx.begin() + offset), needle);
+
+        EXPECT_STREQ(iov_parser_error_description(parser_unexpected_field), "Unexpected field");
+        iov_parser_destroy(parser);
+    }
+
+    // Fractional parts are below 10^9 in every message, amounts and fees alike
+    TEST(IOV_PARSER, coin_fractional) {
+        iov_parser_t *parser = iov_parser_create(1024);
+
+        send_tx tx;
+        tx.amountFractional = IOV_FRAC_UNIT - 1;
+        bytes_t data = build(tx);
+        EXPECT_EQ(iov_parser_parse(parser, data.data(), data.size()), parser_ok);
+
+        tx.amountFractional = IOV_FRAC_UNIT;
+        data = build(tx);
+        EXPECT_EQ(iov_parser_parse(parser, data.data(), data.size()), parser_value_out_of_range);
+
+        send_tx fees;
+        fees.feeFractional = IOV_FRAC_UNIT;
+        data = build(fees);
+        EXPECT_EQ(iov_parser_parse(parser, data.data(), data.size()), parser_value_out_of_range);
+
+        data = build_msg(PBIDX_TX_UPDATEMSG, update_msg(2), "iov-mainnet", 7, IOV_FRAC_UNIT);
+        EXPECT_EQ(iov_parser_parse(parser, data.data(), data.size()), parser_value_out_of_range);
+
+        iov_parser_destroy(parser);
+    }
+
+    send_tx batch_leg(uint64_t whole, uint64_t fractional, const std::string &ticker, const std::string &memo = "") {
+        send_tx tx;
+        tx.amountWhole = whole;
+        tx.amountFractional = fractional;
+        tx.ticker = ticker;
+        tx.memo = memo;
+        return tx;
+    }
+
+    int parse_batch(iov_parser_t *parser, const bytes_t &batch) {
+        const bytes_t tx = build_msg(PBIDX_TX_BATCHMSG, batch);
+        return iov_parser_parse(parser, tx.data(), tx.size());
+    }
+
+    std::vector<std::string> keys(const iov_parser_t *parser) {
+        std::vector<std::string> out;
+        for (const auto &item : items(parser)) {
+            out.push_back(item.substr(0, item.find('=')));
+        }
+        return out;
+    }
+
+    // Totals by ticker, fees, then source, destination, amount and memo (if any) of each leg
+    TEST(IOV_PARSER, batch_items) {
+        iov_parser_t *parser = iov_parser_create(4096);
+
+        ASSERT_EQ(parse_batch(parser, batch_msg({batch_leg(100, 500000000, "IOV", "Hello"),
+                                                 batch_leg(2, 0, "CASH"),
+                                                 batch_leg(0, 250000000, "IOV", "Bye")})), parser_ok);
+        EXPECT_EQ(iov_parser_num_items(parser), 14);
+        EXPECT_THAT(keys(parser), ::testing::ElementsAre(
+            "Total [IOV]", "Total [CASH]", "Fees [IOV]",
+            "Send [1/3] Source [1/2]", "Send [1/3] Source [2/2]",
+            "Send [1/3] Dest [1/2]", "Send [1/3] Dest [2/2]",
+            "Send [1/3] [IOV]", "Send [1/3] Memo",
+            "Send [2/3] Source [1/2]", "Send [2/3] Source [2/2]",
+            "Send [2/3] Dest [1/2]", "Send [2/3] Dest [2/2]",
+            "Send [2/3] [CASH]",
+            "Send [3/3] Source [1/2]", "Send [3/3] Source [2/2]",
+            "Send [3/3] Dest [1/2]", "Send [3/3] Dest [2/2]",
+            "Send [3/3] [IOV]", "Send [3/3] Memo"));
+
+        const auto out = items(parser);
+        EXPECT_EQ(out[0], "Total [IOV]=100.750000000");
+        EXPECT_EQ(out[1], "Total [CASH]=2.000000000");
+        EXPECT_EQ(out[13], "Send [2/3] [CASH]=2.000000000");
+        EXPECT_EQ(out[19], "Send [3/3] Memo=Bye");
+
+        // Same error as for any other message past the last item
+        uint8_t pageCount;
+        char key[40], value[40];
+        EXPECT_EQ(iov_parser_get_item(parser, 14, 0, key, sizeof(key), value, sizeof(value), &pageCount),
+                  parser_display_idx_out_of_range);
+        EXPECT_EQ(pageCount, 0u);
+
+        iov_parser_destroy(parser);
+    }
+
+    TEST(IOV_PARSER, batch_totals) {
+        iov_parser_t *parser = iov_parser_create(4096);
+
+        // Carry from the low to the high 64 bits of the fixed point total
+        ASSERT_EQ(parse_batch(parser, batch_msg({batch_leg(18446744073u, 709551615, "IOV"),
+                                                 batch_leg(0, 1, "IOV")})), parser_ok);
+        EXPECT_EQ(items(parser)[0], "Total [IOV]=18446744073.709551616");
+
+        // Largest total: every leg at the largest amount accepted
+        ASSERT_EQ(parse_batch(parser, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX,
+                                                batch_leg(INT64_MAX, IOV_FRAC_UNIT - 1, "IOV"))), parser_ok);
+        EXPECT_EQ(items(parser)[0], "Total [IOV]=147573952589676412927.999999984");
+
+        iov_parser_destroy(parser);
+    }
+
+    TEST(IOV_PARSER, batch_limits) {
+        iov_parser_t *parser = iov_parser_create(4096);
+
+        std::vector<send_tx> legs;
+        for (const char *ticker : {"IOV", "CASH", "ETH", "BTC"}) {
+            legs.push_back(batch_leg(1, 0, ticker));
+        }
+        ASSERT_EQ(legs.size(), (size_t) PBIDX_BATCHMSG_TICKERS_MAX);
+        EXPECT_EQ(parse_batch(parser, batch_msg(legs)), parser_ok);
+        legs.push_back(batch_leg(1, 0, "LTC"));
+        EXPECT_EQ(parse_batch(parser, batch_msg(legs)), parser_unexpected_number_items);
+
+        EXPECT_EQ(parse_batch(parser, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX)), parser_ok);
+        EXPECT_EQ(parse_batch(parser, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX + 1)), parser_unexpected_number_items);
+        EXPECT_EQ(parse_batch(parser, bytes_t()), parser_unexpected_number_items);
+        EXPECT_EQ(parse_batch(parser, pb_writer().varint(PBIDX_BATCHMSG_MESSAGES + 1, 1).data),
+                  parser_unexpected_field);
+
+        // Memo limit of each leg
+        EXPECT_EQ(parse_batch(parser, batch_msg({batch_leg(1, 0, "IOV", std::string(TX_MEMOLEN_MAX, 'm'))})),
+                  parser_ok);
+        EXPECT_EQ(parse_batch(parser, batch_msg({batch_leg(1, 0, "IOV", std::string(TX_MEMOLEN_MAX + 1, 'm'))})),
+                  parser_unexpected_buffer_end);
+
+        iov_parser_destroy(parser);
+    }
+
+    // Only SendMsg can be batched, and nothing else can be in a BatchMsg
+    TEST(IOV_PARSER, batch_unknown_fields) {
+        iov_parser_t *parser = iov_parser_create(4096);
+
+        const bytes_t vote = pb_writer().bytes(PBIDX_BATCHMSG_MESSAGES,
+                                               pb_writer().bytes(PBIDX_TX_VOTEMSG, vote_msg(1)).data).data;
+        EXPECT_EQ(parse_batch(parser, vote), parser_unexpected_field);
+
+        const bytes_t empty = pb_writer().bytes(PBIDX_BATCHMSG_MESSAGES, bytes_t()).data;
+        EXPECT_EQ(parse_batch(parser, empty), parser_unexpected_type);
+
+        bytes_t extra = batch_msg(1);
+        const bytes_t field = pb_writer().varint(PBIDX_BATCHMSG_MESSAGES + 1, 1).data;
+        extra.insert(extra.end(), field.begin(), field.end());
+        EXPECT_EQ(parse_batch(parser, extra), parser_unexpected_field);
+
+        iov_parser_destroy(parser);
+    }
+}
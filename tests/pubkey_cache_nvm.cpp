@@ -0,0 +1,124 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include "lib/crypto.h"
+#include "lib/cx_host.h"
+#include "lib/pubkey_cache.h"
+#include "lib/stats.h"
+
+// Write policy of the flash tier: a key goes to flash on its second use or when its path signs
+
+namespace {
+    class PubkeyCacheNvmTest : public ::testing::Test {
+    protected:
+        void SetUp() override {
+            cx_host_set_mnemonic("equip will roof matter pink blind book anxiety banner elbow sun young");
+            crypto_accountNodeClear();
+            pubkey_cache_clear();
+            stats_reset();
+        }
+
+        static void account(uint32_t index, uint32_t path[HDPATH_LEN_DEFAULT]) {
+            path[0] = HDPATH_0_DEFAULT;
+            path[1] = HDPATH_1_DEFAULT;
+            path[2] = 0x80000000u | index;
+        }
+
+        static void use(uint32_t index) {
+            uint32_t path[HDPATH_LEN_DEFAULT];
+            account(index, path);
+            uint8_t pubKey[PK_LEN];
+            crypto_extractPublicKey(path, pubKey, sizeof(pubKey));
+        }
+
+        static bool inFlash(uint32_t index) {
+            uint32_t path[HDPATH_LEN_DEFAULT];
+            account(index, path);
+            uint8_t pubKey[PK_LEN];
+            return pubkey_cache_nvm_get(path, pubKey);
+        }
+    };
+
+    TEST_F(PubkeyCacheNvmTest, scan_does_not_write) {
+        use(50);
+        use(50);
+        ASSERT_TRUE(inFlash(50));
+        stats_reset();
+
+        // One pass over more accounts than the flash tier holds
+        for (uint32_t i = 100; i < 100 + 2 * PUBKEY_CACHE_NVM_SIZE; i++) {
+            use(i);
+        }
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+        EXPECT_FALSE(inFlash(100));
+        EXPECT_TRUE(inFlash(50));
+    }
+
+    TEST_F(PubkeyCacheNvmTest, second_use_writes_once) {
+        use(60);
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+        EXPECT_FALSE(inFlash(60));
+
+        use(60);
+        EXPECT_GT(app_stats.nvmPageWrites, 0u);
+        EXPECT_TRUE(inFlash(60));
+
+        stats_reset();
+        use(60);
+        // Read back from flash after a restart of the RAM tier
+        pubkey_cache_clear();
+        use(60);
+        use(60);
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+    }
+
+    TEST_F(PubkeyCacheNvmTest, same_path_is_not_written_again) {
+        use(70);
+        use(70);
+        ASSERT_TRUE(inFlash(70));
+
+        // The key is cached again in RAM, as after a derivation: its second use finds it in flash
+        uint32_t path[HDPATH_LEN_DEFAULT];
+        account(70, path);
+        uint8_t pubKey[PK_LEN];
+        crypto_derivePublicKey(path, pubKey, sizeof(pubKey));
+        pubkey_cache_clear();
+        pubkey_cache_put(path, pubKey);
+        stats_reset();
+        use(70);
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+    }
+
+    TEST_F(PubkeyCacheNvmTest, signing_path_is_persisted) {
+        uint32_t path[HDPATH_LEN_DEFAULT];
+        account(80, path);
+
+        // Nothing to write when the key is not cached
+        pubkey_cache_persist(path);
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+        EXPECT_FALSE(inFlash(80));
+
+        use(80);
+        pubkey_cache_persist(path);
+        EXPECT_GT(app_stats.nvmPageWrites, 0u);
+        EXPECT_TRUE(inFlash(80));
+
+        stats_reset();
+        pubkey_cache_persist(path);
+        use(80);
+        EXPECT_EQ(app_stats.nvmPageWrites, 0u);
+    }
+}
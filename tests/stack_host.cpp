@@ -0,0 +1,59 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include <cstring>
+#include "app_host.h"
+#include "lib/parser.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    void useStack(void *arg) {
+        volatile uint8_t local[4096];
+        memset((void *) local, 0, sizeof(local));
+        *(size_t *) arg = local[100];
+    }
+
+    TEST(STACK_HOST, measures_local_arrays) {
+        size_t out = 1;
+        const size_t used = app_host_stack_usage(useStack, &out);
+        EXPECT_EQ(out, 0u);
+        EXPECT_GE(used, 4096u);
+        EXPECT_LT(used, 4096u + 1024u);
+    }
+
+    struct parse_call_t {
+        bytes_t data;
+        parser_context_t ctx;
+        parser_tx_t tx;
+        parser_error_t err;
+    };
+
+    TEST(STACK_HOST, parser_parse) {
+        parse_call_t call;
+        call.data = build_msg(PBIDX_TX_BATCHMSG, batch_msg(PBIDX_BATCHMSG_SENDMSG_MAX));
+
+        const size_t used = app_host_stack_usage([](void *arg) {
+            auto c = (parse_call_t *) arg;
+            c->err = parser_parse(&c->ctx, c->data.data(), c->data.size(), &c->tx);
+        }, &call);
+        EXPECT_EQ(call.err, parser_ok);
+        EXPECT_GT(used, 0u);
+        // Loose bound (lazy symbol binding may run on this stack): catches runaway recursion or large locals
+        EXPECT_LT(used, 16u * 1024u);
+    }
+}
@@ -0,0 +1,104 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#if defined(APP_TRACE)
+
+#include <gmock/gmock.h>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include "lib/parser.h"
+#include "lib/trace.h"
+#include "tx_builder.h"
+
+using namespace iov_test;
+
+namespace {
+    void parse(const bytes_t &data) {
+        parser_context_t ctx;
+        parser_tx_t tx;
+        ASSERT_EQ(parser_parse(&ctx, data.data(), data.size(), &tx), parser_ok);
+
+        char key[33], value[37];
+        uint8_t pageCount;
+        ASSERT_EQ(parser_getItem(&ctx, 0, key, sizeof(key), value, sizeof(value), 0, &pageCount), parser_ok);
+    }
+
+    std::string chrome() {
+        FILE *f = tmpfile();
+        trace_write_chrome(f);
+        std::string out(ftell(f), 0);
+        rewind(f);
+        EXPECT_EQ(fread(&out[0], 1, out.size(), f), out.size());
+        fclose(f);
+        return out;
+    }
+
+    size_t count(const std::string &s, const std::string &needle) {
+        size_t n = 0;
+        for (size_t pos = s.find(needle); pos != std::string::npos; pos = s.find(needle, pos + 1)) {
+            n++;
+        }
+        return n;
+    }
+
+    TEST(TRACE, disabled_records_nothing) {
+        trace_enable(false);
+        trace_reset();
+        parse(build(send_tx()));
+        EXPECT_EQ(trace_count(), 0u);
+    }
+
+    TEST(TRACE, parse_stages) {
+        trace_reset();
+        trace_enable(true);
+        parse(build(send_tx()));
+        trace_enable(false);
+
+        const std::string json = chrome();
+        EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+        EXPECT_EQ(count(json, "\"ph\":\"B\""), count(json, "\"ph\":\"E\""));
+        EXPECT_EQ(count(json, "\"ph\":\"B\""), trace_count() / 2);
+        for (const char *name : {"parser_readRoot", "parser_readPB_Root", "parser_readPB_Fees",
+                                 "parser_readPB_SendMsg", "parser_readPB_Coin", "parser_getItem"}) {
+            EXPECT_GE(count(json, std::string("\"name\":\"") + name + "\""), 2u) << name;
+        }
+        EXPECT_EQ(count(json, "parser_readPB_VoteMsg"), 0u);
+        trace_reset();
+    }
+
+    TEST(TRACE, one_ring_per_thread) {
+        trace_reset();
+        trace_enable(true);
+        std::thread a([] { parse(build(send_tx())); });
+        std::thread b([] { parse(build(send_tx())); });
+        a.join();
+        b.join();
+        trace_enable(false);
+
+        const std::string json = chrome();
+        std::set<std::string> tids;
+        const std::regex tid("\"tid\":([0-9]+)");
+        for (auto it = std::sregex_iterator(json.begin(), json.end(), tid); it != std::sregex_iterator(); ++it) {
+            tids.insert((*it)[1]);
+        }
+        EXPECT_EQ(tids.size(), 2u);
+        EXPECT_EQ(count(json, "\"name\":\"parser_readRoot\""), 4u);
+        trace_reset();
+    }
+}
+
+#endif
@@ -0,0 +1,198 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Builds weave transactions (see parser_txdef.h) and the APDUs that carry them
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace iov_test {
+    typedef std::vector<uint8_t> bytes_t;
+
+    class pb_writer {
+    public:
+        pb_writer &varint(uint32_t field, uint64_t value) {
+            writeVarint(field << 3u);
+            writeVarint(value);
+            return *this;
+        }
+
+        pb_writer &bytes(uint32_t field, const bytes_t &value) {
+            writeVarint((field << 3u) | 2u);
+            writeVarint(value.size());
+            data.insert(data.end(), value.begin(), value.end());
+            return *this;
+        }
+
+        pb_writer &string(uint32_t field, const std::string &value) {
+            return bytes(field, bytes_t(value.begin(), value.end()));
+        }
+
+        bytes_t data;
+
+    private:
+        void writeVarint(uint64_t v) {
+            while (v >= 0x80) {
+                data.push_back((uint8_t) (v | 0x80u));
+                v >>= 7u;
+            }
+            data.push_back((uint8_t) v);
+        }
+    };
+
+    inline bytes_t address(uint8_t seed) {
+        bytes_t out(20);
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i] = (uint8_t) (seed + i * 13);
+        }
+        return out;
+    }
+
+    inline bytes_t coin(uint64_t whole, uint64_t fractional, const std::string &ticker) {
+        pb_writer w;
+        if (whole > 0) {
+            w.varint(1, whole);
+        }
+        if (fractional > 0) {
+            w.varint(2, fractional);
+        }
+        return w.string(3, ticker).data;
+    }
+
+    struct send_tx {
+        std::string chainID = "iov-mainnet";
+        uint64_t nonce = 7;
+        uint64_t amountWhole = 100;
+        uint64_t amountFractional = 500000000;
+        uint64_t feeFractional = 10000000;
+        std::string ticker = "IOV";
+        std::string memo = "Hello";
+    };
+
+    /// version | len(chainID) | chainID | nonce (big endian) | serialized tx
+    inline bytes_t tx_header(const std::string &chainID, uint64_t nonce) {
+        bytes_t out = {0x00, 0xCA, 0xFE, 0x00, (uint8_t) chainID.size()};
+        out.insert(out.end(), chainID.begin(), chainID.end());
+        for (int i = 7; i >= 0; i--) {
+            out.push_back((uint8_t) (nonce >> (8u * i)));
+        }
+        return out;
+    }
+
+    inline bytes_t send_msg(const send_tx &tx) {
+        pb_writer msg;
+        msg.bytes(1, pb_writer().varint(1, 1).data)
+            .bytes(2, address(1))
+            .bytes(3, address(2))
+            .bytes(4, coin(tx.amountWhole, tx.amountFractional, tx.ticker));
+        if (!tx.memo.empty()) {
+            msg.string(5, tx.memo);
+        }
+        return msg.data;
+    }
+
+    /// header + fees + one message in root field msgField
+    inline bytes_t build_msg(uint32_t msgField, const bytes_t &msg,
+                             const std::string &chainID = "iov-mainnet", uint64_t nonce = 7,
+                             uint64_t feeFractional = 10000000, const std::string &ticker = "IOV") {
+        pb_writer fees;
+        fees.bytes(2, address(1))
+            .bytes(3, coin(0, feeFractional, ticker));
+
+        pb_writer root;
+        root.bytes(1, fees.data)
+            .bytes(msgField, msg);
+
+        bytes_t out = tx_header(chainID, nonce);
+        out.insert(out.end(), root.data.begin(), root.data.end());
+        return out;
+    }
+
+    inline bytes_t build(const send_tx &tx) {
+        return build_msg(51, send_msg(tx), tx.chainID, tx.nonce, tx.feeFractional, tx.ticker);
+    }
+
+    inline bytes_t vote_msg(uint8_t option) {
+        return pb_writer()
+            .bytes(1, pb_writer().varint(1, 1).data)
+            .bytes(2, bytes_t{0, 0, 0, 0, 0, 0, 0x12, 0x34})
+            .bytes(3, address(3))
+            .varint(4, option)
+            .data;
+    }
+
+    inline bytes_t update_msg(uint8_t participants) {
+        pb_writer msg;
+        msg.bytes(1, pb_writer().varint(1, 1).data)
+            .bytes(2, bytes_t{0, 0, 0, 0, 0, 0, 0, 0x2A});
+        for (uint8_t i = 0; i < participants; i++) {
+            msg.bytes(3, pb_writer().bytes(1, address(10 + i)).varint(2, 1 + i).data);
+        }
+        return msg.varint(4, participants).varint(5, participants + 1u).data;
+    }
+
+    /// BatchMsg with count SendMsg
+    inline bytes_t batch_msg(uint8_t count, const send_tx &tx = send_tx()) {
+        pb_writer msg;
+        for (uint8_t i = 0; i < count; i++) {
+            msg.bytes(1, pb_writer().bytes(51, send_msg(tx)).data);
+        }
+        return msg.data;
+    }
+
+    /// BatchMsg with one SendMsg per entry of legs
+    inline bytes_t batch_msg(const std::vector<send_tx> &legs) {
+        pb_writer msg;
+        for (const auto &tx : legs) {
+            msg.bytes(1, pb_writer().bytes(51, send_msg(tx)).data);
+        }
+        return msg.data;
+    }
+
+    inline bytes_t apdu(uint8_t ins, uint8_t p1, uint8_t p2, const bytes_t &data) {
+        bytes_t out = {0x22, ins, p1, p2, (uint8_t) data.size()};
+        out.insert(out.end(), data.begin(), data.end());
+        return out;
+    }
+
+    inline bytes_t path(uint32_t account) {
+        const uint32_t p[3] = {0x8000002Cu, 0x800000EAu, 0x80000000u | account};
+        bytes_t out;
+        for (uint32_t v : p) {
+            for (int i = 0; i < 4; i++) {
+                out.push_back((uint8_t) (v >> (8u * i)));
+            }
+        }
+        return out;
+    }
+
+    /// INIT (path) + ADD ... + LAST chunks of a signing request
+    inline std::vector<bytes_t> sign_apdus(uint8_t ins, const bytes_t &pathData, const bytes_t &message,
+                                           size_t chunkSize = 250) {
+        std::vector<bytes_t> out;
+        out.push_back(apdu(ins, 0, 0, pathData));
+        for (size_t offset = 0; offset < message.size(); offset += chunkSize) {
+            const size_t n = std::min(chunkSize, message.size() - offset);
+            const bool last = offset + n == message.size();
+            out.push_back(apdu(ins, last ? 2 : 1, 0,
+                               bytes_t(message.begin() + offset, message.begin() + offset + n)));
+        }
+        return out;
+    }
+}
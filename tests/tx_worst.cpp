@@ -0,0 +1,76 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#include <gmock/gmock.h>
+#include "lib/parser.h"
+#include "tx_worst.h"
+
+using namespace iov_test;
+
+namespace {
+    parser_error_t parse(const bytes_t &data, parser_context_t *ctx, parser_tx_t *tx) {
+        parser_error_t err = parser_parse(ctx, data.data(), data.size(), tx);
+        if (err == parser_ok) {
+            err = parser_validate(ctx, bool_true);
+        }
+        return err;
+    }
+
+    // The worst cases must be accepted, otherwise they bound nothing
+    TEST(TX_WORST, all_valid) {
+        for (const auto &c : worst_cases()) {
+            parser_context_t ctx;
+            parser_tx_t tx;
+            ASSERT_EQ(parse(c.second, &ctx, &tx), parser_ok) << c.first;
+            EXPECT_EQ(tx.multisig.count, PBIDX_MULTISIG_COUNT_MAX) << c.first;
+
+            char key[33], value[37];
+            for (int8_t i = 0; i < parser_getNumItems(&ctx); i++) {
+                uint8_t pageCount = 1;
+                for (uint8_t page = 0; page < pageCount; page++) {
+                    EXPECT_EQ(parser_getItem(&ctx, i, key, sizeof(key), value, sizeof(value), page, &pageCount),
+                              parser_ok) << c.first << " item " << (int) i;
+                }
+            }
+        }
+    }
+
+    TEST(TX_WORST, at_the_limits) {
+        parser_context_t ctx;
+        parser_tx_t tx;
+
+        ASSERT_EQ(parse(worst_build(PBIDX_TX_UPDATEMSG, worst_update_msg()), &ctx, &tx), parser_ok);
+        EXPECT_EQ(tx.updatemsg.participantsCount, PBIDX_UPDATEMSG_PARTICIPANTS_MAX);
+
+        ASSERT_EQ(parse(worst_build(PBIDX_TX_BATCHMSG, worst_batch_msg()), &ctx, &tx), parser_ok);
+        EXPECT_EQ(tx.batchmsg.sendmsgCount, PBIDX_BATCHMSG_SENDMSG_MAX);
+        EXPECT_EQ(tx.batchmsg.totalsCount, PBIDX_BATCHMSG_TICKERS_MAX);
+
+        // One more multisig contract is rejected
+        bytes_t tooMany = worst_build(PBIDX_TX_SENDMSG, worst_send_msg());
+        const bytes_t extra = pb_writer().bytes(PBIDX_TX_MULTISIG, bytes_t(8, 0xFF)).data;
+        tooMany.insert(tooMany.end(), extra.begin(), extra.end());
+        EXPECT_EQ(parse(tooMany, &ctx, &tx), parser_value_out_of_range);
+
+        // One more memo byte is rejected
+        const bytes_t longMemo = pb_writer()
+            .bytes(PBIDX_SENDMSG_SOURCE, address(1))
+            .bytes(PBIDX_SENDMSG_DESTINATION, address(2))
+            .bytes(PBIDX_SENDMSG_AMOUNT, worst_coin("IOV"))
+            .string(PBIDX_SENDMSG_MEMO, worst_memo() + "!")
+            .data;
+        EXPECT_NE(parse(worst_build(PBIDX_TX_SENDMSG, longMemo), &ctx, &tx), parser_ok);
+    }
+}
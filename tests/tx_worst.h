@@ -0,0 +1,122 @@
+/*******************************************************************************
+*   (c) 2019 ZondaX GmbH
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+********************************************************************************/
+#pragma once
+
+// Worst-case transactions: every optional field present, every repeated field at its limit and
+// the values with the longest rendering. Used to bound parse and render times.
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lib/parser_txdef.h"
+#include "tx_builder.h"
+
+namespace iov_test {
+    /// Largest amount accepted by parser_readPB_Coin
+    inline bytes_t worst_coin(const std::string &ticker) {
+        return pb_writer()
+            .varint(PBIDX_COIN_WHOLE, INT64_MAX)
+            .varint(PBIDX_COIN_FRACTIONAL, IOV_FRAC_UNIT - 1)
+            .string(PBIDX_COIN_TICKER, ticker)
+            .data;
+    }
+
+    /// Printable ASCII: nothing is dropped by asciify, so the memo has the most pages
+    inline std::string worst_memo() {
+        std::string memo;
+        for (size_t i = 0; i < TX_MEMOLEN_MAX; i++) {
+            memo += (char) ('!' + i % ('~' - '!' + 1));
+        }
+        return memo;
+    }
+
+    /// _readUInt32 rejects UINT32_MAX itself
+    inline bytes_t worst_metadata() {
+        return pb_writer().varint(PBIDX_METADATA_SCHEMA, UINT32_MAX - 1).data;
+    }
+
+    inline bytes_t worst_send_msg(const std::string &ticker = "IOVX") {
+        return pb_writer()
+            .bytes(PBIDX_SENDMSG_METADATA, worst_metadata())
+            .bytes(PBIDX_SENDMSG_SOURCE, address(1))
+            .bytes(PBIDX_SENDMSG_DESTINATION, address(2))
+            .bytes(PBIDX_SENDMSG_AMOUNT, worst_coin(ticker))
+            .string(PBIDX_SENDMSG_MEMO, worst_memo())
+            .data;
+    }
+
+    inline bytes_t worst_vote_msg() {
+        return pb_writer()
+            .bytes(PBIDX_VOTEMSG_METADATA, worst_metadata())
+            .bytes(PBIDX_VOTEMSG_PROPOSAL_ID, bytes_t(8, 0xFF))
+            .bytes(PBIDX_VOTEMSG_VOTER, address(3))
+            .varint(PBIDX_VOTEMSG_VOTE, VOTE_OPTION_ABSTAIN)
+            .data;
+    }
+
+    inline bytes_t worst_update_msg() {
+        pb_writer msg;
+        msg.bytes(PBIDX_UPDATEMSG_METADATA, worst_metadata())
+            .bytes(PBIDX_UPDATEMSG_ID, bytes_t(8, 0xFF));
+        for (uint8_t i = 0; i < PBIDX_UPDATEMSG_PARTICIPANTS_MAX; i++) {
+            msg.bytes(PBIDX_UPDATEMSG_PARTICIPANTS, pb_writer()
+                .bytes(PBIDX_PARTICIPANTMSG_SIGNATURE, address(10 + i))
+                .varint(PBIDX_PARTICIPANTMSG_WEIGHT, UINT32_MAX - 1)
+                .data);
+        }
+        return msg.varint(PBIDX_UPDATEMSG_ACTIVATION_TH, UINT32_MAX - 1)
+            .varint(PBIDX_UPDATEMSG_ADMIN_TH, UINT32_MAX - 1)
+            .data;
+    }
+
+    /// All messages with a memo, amounts spread over every ticker slot so each total is as large as possible
+    inline bytes_t worst_batch_msg() {
+        pb_writer msg;
+        for (uint8_t i = 0; i < PBIDX_BATCHMSG_SENDMSG_MAX; i++) {
+            const std::string ticker = std::string("IOV") + (char) ('A' + i % PBIDX_BATCHMSG_TICKERS_MAX);
+            msg.bytes(PBIDX_BATCHMSG_MESSAGES,
+                      pb_writer().bytes(PBIDX_BATCHMSG_UNION_SENDMSG, worst_send_msg(ticker)).data);
+        }
+        return msg.data;
+    }
+
+    /// Header, largest fees, the maximum number of multisig contracts and one message
+    inline bytes_t worst_build(uint32_t msgField, const bytes_t &msg) {
+        pb_writer root;
+        root.bytes(PBIDX_TX_FEES, pb_writer()
+            .bytes(PBIDX_FEES_PAYER, address(1))
+            .bytes(PBIDX_FEES_COIN, worst_coin("IOVX"))
+            .data);
+        for (uint8_t i = 0; i < PBIDX_MULTISIG_COUNT_MAX; i++) {
+            root.bytes(PBIDX_TX_MULTISIG, bytes_t(8, 0xFF));
+        }
+        root.bytes(msgField, msg);
+
+        bytes_t out = tx_header("iov-mainnet", INT64_MAX);
+        out.insert(out.end(), root.data.begin(), root.data.end());
+        return out;
+    }
+
+    inline std::vector<std::pair<std::string, bytes_t>> worst_cases() {
+        return {
+            {"worst_send", worst_build(PBIDX_TX_SENDMSG, worst_send_msg())},
+            {"worst_vote", worst_build(PBIDX_TX_VOTEMSG, worst_vote_msg())},
+            {"worst_update", worst_build(PBIDX_TX_UPDATEMSG, worst_update_msg())},
+            {"worst_batch", worst_build(PBIDX_TX_BATCHMSG, worst_batch_msg())},
+        };
+    }
+}